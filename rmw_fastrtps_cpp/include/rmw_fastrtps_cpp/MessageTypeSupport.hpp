@@ -15,6 +15,8 @@
 #ifndef RMW_FASTRTPS_CPP__MESSAGETYPESUPPORT_HPP_
 #define RMW_FASTRTPS_CPP__MESSAGETYPESUPPORT_HPP_
 
+#include "rosidl_runtime_c/message_type_support_struct.h"
+
 #include "rosidl_typesupport_fastrtps_cpp/message_type_support.h"
 
 #include "TypeSupport.hpp"
@@ -25,7 +27,10 @@ namespace rmw_fastrtps_cpp
 class MessageTypeSupport : public TypeSupport
 {
 public:
-  explicit MessageTypeSupport(const message_type_support_callbacks_t * members);
+  /// Messages are only copied as is when `type_supports` tells they are laid out as serialized.
+  explicit MessageTypeSupport(
+    const message_type_support_callbacks_t * members,
+    const rosidl_message_type_support_t * type_supports = nullptr);
 };
 
 }  // namespace rmw_fastrtps_cpp
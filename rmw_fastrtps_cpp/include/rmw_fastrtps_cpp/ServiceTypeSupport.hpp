@@ -20,6 +20,8 @@
 #include "fastcdr/FastBuffer.h"
 #include "fastcdr/Cdr.h"
 
+#include "rosidl_runtime_c/service_type_support_struct.h"
+
 #include "rosidl_typesupport_fastrtps_cpp/message_type_support.h"
 #include "rosidl_typesupport_fastrtps_cpp/service_type_support.h"
 
@@ -37,13 +39,17 @@ protected:
 class RequestTypeSupport : public ServiceTypeSupport
 {
 public:
-  explicit RequestTypeSupport(const service_type_support_callbacks_t * members);
+  explicit RequestTypeSupport(
+    const service_type_support_callbacks_t * members,
+    const rosidl_service_type_support_t * type_supports = nullptr);
 };
 
 class ResponseTypeSupport : public ServiceTypeSupport
 {
 public:
-  explicit ResponseTypeSupport(const service_type_support_callbacks_t * members);
+  explicit ResponseTypeSupport(
+    const service_type_support_callbacks_t * members,
+    const rosidl_service_type_support_t * type_supports = nullptr);
 };
 
 }  // namespace rmw_fastrtps_cpp
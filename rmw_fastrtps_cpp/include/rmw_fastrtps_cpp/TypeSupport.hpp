@@ -24,6 +24,8 @@
 #include "fastcdr/Cdr.h"
 #include "fastcdr/FastBuffer.h"
 
+#include "rosidl_runtime_c/message_type_support_struct.h"
+
 #include "rosidl_typesupport_fastrtps_cpp/message_type_support.h"
 
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
@@ -45,11 +47,19 @@ public:
   TypeSupport();
 
 protected:
-  void set_members(const message_type_support_callbacks_t * members);
+  /// \param[in] type_supports type supports of the message, to check if it can be copied as is.
+  void set_members(
+    const message_type_support_callbacks_t * members,
+    const rosidl_message_type_support_t * type_supports);
 
 private:
+  bool can_copy_plain(const eprosima::fastcdr::Cdr & cdr) const;
+
   const message_type_support_callbacks_t * members_;
   bool has_data_;
+  // Whether messages are (de)serialized by copying them as is, when the stream uses XCDRv1 and
+  // the endianness of the host
+  bool copy_plain_;
 };
 
 }  // namespace rmw_fastrtps_cpp
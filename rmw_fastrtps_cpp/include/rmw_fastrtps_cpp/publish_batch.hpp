@@ -0,0 +1,55 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_CPP__PUBLISH_BATCH_HPP_
+#define RMW_FASTRTPS_CPP__PUBLISH_BATCH_HPP_
+
+#include "rmw/rmw.h"
+#include "rmw_fastrtps_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_cpp
+{
+
+/// Publish several ROS messages at once.
+/**
+ * All messages are published with the same source timestamp, in the order they are given.
+ * No other message of the publisher is written while they are, so that they arrive together.
+ * When the publisher uses asynchronous publication mode, the flow controller may send them
+ * together in fewer datagrams.
+ * Each message is still written to the DataWriter on its own, as Fast DDS cannot write several
+ * samples at once.
+ *
+ * If writing one of the messages fails, the messages after it are not published.
+ *
+ * \param[in] publisher publisher to publish with.
+ * \param[in] ros_messages array of `count` type erased ROS messages.
+ * \param[in] count number of messages in `ros_messages`.
+ * \param[in] allocation optional publisher allocation, may be `NULL`.
+ * \return `RMW_RET_OK` if successful, or
+ * \return `RMW_RET_INVALID_ARGUMENT` if an argument is `NULL`, or
+ * \return `RMW_RET_INCORRECT_RMW_IMPLEMENTATION` if the publisher is from a different
+ *   rmw implementation, or
+ * \return `RMW_RET_ERROR` if a message could not be published.
+ */
+RMW_FASTRTPS_CPP_PUBLIC
+rmw_ret_t
+publish_batch(
+  const rmw_publisher_t * publisher,
+  const void * const * ros_messages,
+  size_t count,
+  rmw_publisher_allocation_t * allocation);
+
+}  // namespace rmw_fastrtps_cpp
+
+#endif  // RMW_FASTRTPS_CPP__PUBLISH_BATCH_HPP_
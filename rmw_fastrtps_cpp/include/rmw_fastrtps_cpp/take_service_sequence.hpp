@@ -0,0 +1,82 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_CPP__TAKE_SERVICE_SEQUENCE_HPP_
+#define RMW_FASTRTPS_CPP__TAKE_SERVICE_SEQUENCE_HPP_
+
+#include "rmw/rmw.h"
+#include "rmw_fastrtps_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_cpp
+{
+
+/// Take up to `count` incoming ROS service requests in a single call.
+/**
+ * Requests are taken from the service reader in as few takes as possible, instead of one
+ * request per call to rmw_take_request().
+ *
+ * Taken requests are deserialized into the first `*taken` elements of `ros_requests`, and
+ * their headers are stored in the same positions of `request_headers`.
+ * To keep them contiguous, the pointers in `ros_requests` may be reordered; the caller still
+ * owns all of them.
+ *
+ * \param[in] service service to take the requests from.
+ * \param[in] count maximum number of requests to take.
+ * \param[inout] ros_requests array of `count` type erased ROS requests to take into.
+ * \param[out] request_headers array of `count` headers for the taken requests.
+ * \param[out] taken number of requests taken.
+ * \return `RMW_RET_OK` if successful, even if no request was taken, or
+ * \return `RMW_RET_INVALID_ARGUMENT` if an argument is `NULL` or `count` is 0, or
+ * \return `RMW_RET_INCORRECT_RMW_IMPLEMENTATION` if the service is from a different
+ *   rmw implementation.
+ */
+RMW_FASTRTPS_CPP_PUBLIC
+rmw_ret_t
+take_request_sequence(
+  const rmw_service_t * service,
+  size_t count,
+  void ** ros_requests,
+  rmw_service_info_t * request_headers,
+  size_t * taken);
+
+/// Take up to `count` incoming ROS service responses in a single call.
+/**
+ * Responses are taken from the client reader one by one, so that responses to other clients
+ * are discarded without being deserialized, but within a single call.
+ *
+ * Taken responses are deserialized into the first `*taken` elements of `ros_responses`, and
+ * their headers are stored in the same positions of `request_headers`.
+ *
+ * \param[in] client client to take the responses from.
+ * \param[in] count maximum number of responses to take.
+ * \param[inout] ros_responses array of `count` type erased ROS responses to take into.
+ * \param[out] request_headers array of `count` headers for the taken responses.
+ * \param[out] taken number of responses taken.
+ * \return `RMW_RET_OK` if successful, even if no response was taken, or
+ * \return `RMW_RET_INVALID_ARGUMENT` if an argument is `NULL` or `count` is 0, or
+ * \return `RMW_RET_INCORRECT_RMW_IMPLEMENTATION` if the client is from a different
+ *   rmw implementation.
+ */
+RMW_FASTRTPS_CPP_PUBLIC
+rmw_ret_t
+take_response_sequence(
+  const rmw_client_t * client,
+  size_t count,
+  void ** ros_responses,
+  rmw_service_info_t * request_headers,
+  size_t * taken);
+
+}  // namespace rmw_fastrtps_cpp
+
+#endif  // RMW_FASTRTPS_CPP__TAKE_SERVICE_SEQUENCE_HPP_
@@ -178,8 +178,9 @@ init_context_impl(
   }
 
   common_context->graph_cache.set_on_change_callback(
-    [guard_condition = graph_guard_condition.get()]()
+    [guard_condition = graph_guard_condition.get(), participant = participant_info.get()]()
     {
+      participant->graph_change_count_.fetch_add(1u);
       rmw_fastrtps_shared_cpp::__rmw_trigger_guard_condition(
         eprosima_fastrtps_identifier,
         guard_condition);
@@ -36,8 +36,10 @@
 #include "rcpputils/scope_exit.hpp"
 
 #include "rmw_fastrtps_shared_cpp/create_rmw_gid.hpp"
+#include "rmw_fastrtps_shared_cpp/bounded_payload_pool.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_publisher_info.hpp"
+#include "rmw_fastrtps_shared_cpp/local_delivery.hpp"
 #include "rmw_fastrtps_shared_cpp/names.hpp"
 #include "rmw_fastrtps_shared_cpp/namespace_prefix.hpp"
 #include "rmw_fastrtps_shared_cpp/qos.hpp"
@@ -176,7 +178,7 @@ rmw_fastrtps_cpp::create_publisher(
   /////
   // Create the Type Support struct
   if (!fastdds_type) {
-    auto tsupport = new (std::nothrow) MessageTypeSupport_cpp(callbacks);
+    auto tsupport = new (std::nothrow) MessageTypeSupport_cpp(callbacks, type_supports);
     if (!tsupport) {
       RMW_SET_ERROR_MSG("create_publisher() failed to allocate MessageTypeSupport");
       return nullptr;
@@ -264,18 +266,39 @@ rmw_fastrtps_cpp::create_publisher(
     return nullptr;
   }
 
+  if (participant_info->data_sharing_for_plain_types && info->type_support_->is_plain()) {
+    enable_data_sharing(writer_qos);
+  }
+
+  if (participant_info->xcdr2_for_non_plain_types && !info->type_support_->is_plain() &&
+    rmw_fastrtps_shared_cpp::is_xcdr2_interoperable(type_supports))
+  {
+    enable_xcdr2(writer_qos);
+  }
+
+  // Bounded messages are published without allocating their payloads
+  info->payload_pool_ = rmw_fastrtps_shared_cpp::create_bounded_payload_pool(
+    *static_cast<const rmw_fastrtps_shared_cpp::TypeSupport *>(info->type_support_.get()),
+    writer_qos);
+
   // Creates DataWriter with a mask enabling publication_matched calls for the listener
   info->data_writer_ = publisher->create_datawriter(
     info->topic_,
     writer_qos,
     info->data_writer_listener_,
-    eprosima::fastdds::dds::StatusMask::publication_matched());
+    eprosima::fastdds::dds::StatusMask::publication_matched(),
+    info->payload_pool_);
 
   if (!info->data_writer_) {
     RMW_SET_ERROR_MSG("create_publisher() could not create data writer");
     return nullptr;
   }
 
+  // An offered deadline is only met by writing the messages
+  info->skip_write_when_unmatched_ =
+    eprosima::fastdds::dds::VOLATILE_DURABILITY_QOS == writer_qos.durability().kind &&
+    eprosima::fastrtps::c_TimeInfinite == writer_qos.deadline().period;
+
   // Set the StatusCondition to none to prevent triggering via WaitSets
   info->data_writer_->get_statuscondition().set_enabled_statuses(
     eprosima::fastdds::dds::StatusMask::none());
@@ -317,6 +340,10 @@ rmw_fastrtps_cpp::create_publisher(
 
   rmw_publisher->options = *publisher_options;
 
+  if (participant_info->local_delivery_) {
+    participant_info->local_delivery_->add_publisher(info);
+  }
+
   cleanup_rmw_publisher.cancel();
   cleanup_datawriter.cancel();
   cleanup_info.cancel();
@@ -40,6 +40,7 @@
 
 #include "rmw_dds_common/qos.hpp"
 
+#include "rmw_fastrtps_shared_cpp/client_response_filter.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_client_info.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
 #include "rmw_fastrtps_shared_cpp/guid_utils.hpp"
@@ -197,6 +198,10 @@ rmw_create_client(
 
   auto cleanup_info = rcpputils::make_scope_exit(
     [info, participant_info]() {
+      if (nullptr != info->response_filtered_topic_) {
+        participant_info->participant_->delete_contentfilteredtopic(
+          info->response_filtered_topic_);
+      }
       rmw_fastrtps_shared_cpp::remove_topic_and_type(
         participant_info, nullptr, info->response_topic_, info->response_type_support_);
       rmw_fastrtps_shared_cpp::remove_topic_and_type(
@@ -216,7 +221,7 @@ rmw_create_client(
   info->response_type_support_impl_ = response_members;
 
   if (!request_fastdds_type) {
-    auto tsupport = new (std::nothrow) RequestTypeSupport_cpp(service_members);
+    auto tsupport = new (std::nothrow) RequestTypeSupport_cpp(service_members, type_supports);
     if (!tsupport) {
       RMW_SET_ERROR_MSG("create_client() failed to allocate request typesupport");
       return nullptr;
@@ -225,7 +230,7 @@ rmw_create_client(
     request_fastdds_type.reset(tsupport);
   }
   if (!response_fastdds_type) {
-    auto tsupport = new (std::nothrow) ResponseTypeSupport_cpp(service_members);
+    auto tsupport = new (std::nothrow) ResponseTypeSupport_cpp(service_members, type_supports);
     if (!tsupport) {
       RMW_SET_ERROR_MSG("create_client() failed to allocate response typesupport");
       return nullptr;
@@ -277,7 +282,15 @@ rmw_create_client(
     return nullptr;
   }
 
-  response_topic_desc = info->response_topic_;
+  // Read responses through a filtered topic, so servers only send this client its own responses
+  if (!rmw_fastrtps_shared_cpp::create_client_response_filtered_topic(
+      dds_participant, info->response_topic_, &info->response_filtered_topic_))
+  {
+    RMW_SET_ERROR_MSG("create_client() failed to create response filtered topic");
+    return nullptr;
+  }
+
+  response_topic_desc = info->response_filtered_topic_;
 
   // Create request topic
   info->request_topic_ = participant_info->find_or_create_topic(
@@ -341,6 +354,10 @@ rmw_create_client(
   info->response_reader_->get_statuscondition().set_enabled_statuses(
     eprosima::fastdds::dds::StatusMask::data_available());
 
+  if (participant_info->track_data_readiness) {
+    info->data_readiness_.enable(info->response_reader_, info->listener_);
+  }
+
   // lambda to delete datareader
   auto cleanup_datareader = rcpputils::make_scope_exit(
     [subscriber, info]() {
@@ -22,6 +22,7 @@
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
 
 #include "rmw_fastrtps_cpp/identifier.hpp"
+#include "rmw_fastrtps_cpp/publish_batch.hpp"
 
 extern "C"
 {
@@ -55,3 +56,19 @@ rmw_publish_loaned_message(
     eprosima_fastrtps_identifier, publisher, ros_message, allocation);
 }
 }  // extern "C"
+
+namespace rmw_fastrtps_cpp
+{
+
+rmw_ret_t
+publish_batch(
+  const rmw_publisher_t * publisher,
+  const void * const * ros_messages,
+  size_t count,
+  rmw_publisher_allocation_t * allocation)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_publish_batch(
+    eprosima_fastrtps_identifier, publisher, ros_messages, count, allocation);
+}
+
+}  // namespace rmw_fastrtps_cpp
@@ -35,6 +35,8 @@
 #include "rmw_fastrtps_cpp/identifier.hpp"
 #include "rmw_fastrtps_cpp/publisher.hpp"
 
+#include "type_support_common.hpp"
+
 #include "rmw_dds_common/context.hpp"
 #include "rmw_dds_common/msg/participant_entities_info.hpp"
 
@@ -46,21 +48,34 @@ rmw_init_publisher_allocation(
   const rosidl_runtime_c__Sequence__bound * message_bounds,
   rmw_publisher_allocation_t * allocation)
 {
-  // Unused in current implementation.
-  (void) type_support;
+  RMW_CHECK_ARGUMENT_FOR_NULL(type_support, RMW_RET_INVALID_ARGUMENT);
+  const rosidl_message_type_support_t * ts = get_message_typesupport_handle(
+    type_support, RMW_FASTRTPS_CPP_TYPESUPPORT_C);
+  if (!ts) {
+    ts = get_message_typesupport_handle(
+      type_support, RMW_FASTRTPS_CPP_TYPESUPPORT_CPP);
+    if (!ts) {
+      RMW_SET_ERROR_MSG("type support not from this implementation");
+      return RMW_RET_ERROR;
+    }
+  }
+
+  // The type support does not take sequence bounds into account, so only messages
+  // that are bounded as a whole have a known maximum size.
   (void) message_bounds;
-  (void) allocation;
-  RMW_SET_ERROR_MSG("unimplemented");
-  return RMW_RET_UNSUPPORTED;
+  auto callbacks = static_cast<const message_type_support_callbacks_t *>(ts->data);
+  auto tss = MessageTypeSupport_cpp(callbacks);
+  size_t max_serialized_size = tss.is_bounded() ? tss.m_typeSize : 0u;
+
+  return rmw_fastrtps_shared_cpp::__rmw_init_publisher_allocation(
+    eprosima_fastrtps_identifier, max_serialized_size, allocation);
 }
 
 rmw_ret_t
 rmw_fini_publisher_allocation(rmw_publisher_allocation_t * allocation)
 {
-  // Unused in current implementation.
-  (void) allocation;
-  RMW_SET_ERROR_MSG("unimplemented");
-  return RMW_RET_UNSUPPORTED;
+  return rmw_fastrtps_shared_cpp::__rmw_fini_publisher_allocation(
+    eprosima_fastrtps_identifier, allocation);
 }
 
 rmw_publisher_t *
@@ -18,6 +18,7 @@
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
 
 #include "rmw_fastrtps_cpp/identifier.hpp"
+#include "rmw_fastrtps_cpp/take_service_sequence.hpp"
 
 extern "C"
 {
@@ -42,3 +43,20 @@ rmw_send_response(
     eprosima_fastrtps_identifier, service, request_header, ros_response);
 }
 }  // extern "C"
+
+namespace rmw_fastrtps_cpp
+{
+
+rmw_ret_t
+take_response_sequence(
+  const rmw_client_t * client,
+  size_t count,
+  void ** ros_responses,
+  rmw_service_info_t * request_headers,
+  size_t * taken)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_take_response_sequence(
+    eprosima_fastrtps_identifier, client, count, ros_responses, request_headers, taken);
+}
+
+}  // namespace rmw_fastrtps_cpp
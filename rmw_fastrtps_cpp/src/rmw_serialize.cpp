@@ -12,14 +12,134 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+
 #include "fastcdr/FastBuffer.h"
 
 #include "rmw/error_handling.h"
+#include "rmw/impl/cpp/macros.hpp"
 #include "rmw/serialized_message.h"
 #include "rmw/rmw.h"
 
 #include "./type_support_common.hpp"
 
+namespace
+{
+
+/// Type supports of the serialization functions, built once per type.
+/**
+ * Looking a type support up only takes atomic loads and a comparison with the callbacks.
+ * Type supports are added with a compare and exchange, and only freed with the cache.
+ *
+ * The libraries of the messages may be unloaded, and others loaded at the same address.
+ * Each entry keeps a copy of the callbacks it was built from, with the name of the type,
+ * and is only used while the callbacks found at that address are still the same.
+ */
+class SerializationTypeSupports
+{
+public:
+  ~SerializationTypeSupports()
+  {
+    for (std::atomic<Entry *> & bucket : buckets_) {
+      Entry * entry = bucket.load(std::memory_order_acquire);
+      while (nullptr != entry) {
+        Entry * next = entry->next;
+        delete entry;
+        entry = next;
+      }
+    }
+  }
+
+  static SerializationTypeSupports & get_instance()
+  {
+    static SerializationTypeSupports instance;
+    return instance;
+  }
+
+  /// \return the type support of `callbacks`, or nullptr when it could not be built.
+  const MessageTypeSupport_cpp * get(
+    const message_type_support_callbacks_t * callbacks,
+    const rosidl_message_type_support_t * type_supports)
+  {
+    // Callbacks are aligned, so their lowest bits are always the same
+    std::atomic<Entry *> & bucket =
+      buckets_[(reinterpret_cast<uintptr_t>(callbacks) >> 4u) % buckets_.size()];
+    Entry * head = bucket.load(std::memory_order_acquire);
+    const Entry * found = find(head, callbacks);
+    if (nullptr != found) {
+      return &found->type_support;
+    }
+
+    Entry * entry = new (std::nothrow) Entry(callbacks, type_supports);
+    if (nullptr == entry) {
+      RMW_SET_ERROR_MSG("failed to allocate type support");
+      return nullptr;
+    }
+    entry->next = head;
+    while (!bucket.compare_exchange_weak(
+        entry->next, entry, std::memory_order_release, std::memory_order_acquire))
+    {
+      // Another thread may have added the same type meanwhile
+      found = find(entry->next, callbacks);
+      if (nullptr != found) {
+        delete entry;
+        return &found->type_support;
+      }
+    }
+    return &entry->type_support;
+  }
+
+private:
+  struct Entry
+  {
+    Entry(
+      const message_type_support_callbacks_t * callbacks,
+      const rosidl_message_type_support_t * type_supports)
+    : callbacks(callbacks), callbacks_copy(*callbacks),
+      message_namespace(callbacks->message_namespace_), message_name(callbacks->message_name_),
+      type_support(callbacks, type_supports)
+    {
+    }
+
+    /// Whether the entry was built from `callbacks`, as they currently are.
+    bool matches(const message_type_support_callbacks_t * callbacks) const
+    {
+      // A library unloaded and replaced by another one leaves different callbacks behind
+      return this->callbacks == callbacks &&
+             0 == std::memcmp(&callbacks_copy, callbacks, sizeof(callbacks_copy)) &&
+             0 == std::strcmp(message_namespace.c_str(), callbacks->message_namespace_) &&
+             0 == std::strcmp(message_name.c_str(), callbacks->message_name_);
+    }
+
+    const message_type_support_callbacks_t * callbacks;
+    const message_type_support_callbacks_t callbacks_copy;
+    const std::string message_namespace;
+    const std::string message_name;
+    MessageTypeSupport_cpp type_support;
+    Entry * next{nullptr};
+  };
+
+  static const Entry * find(const Entry * entry, const message_type_support_callbacks_t * callbacks)
+  {
+    // Entries left behind by unloaded libraries are skipped, newer ones come first
+    while (nullptr != entry && !entry->matches(callbacks)) {
+      entry = entry->next;
+    }
+    return entry;
+  }
+
+  SerializationTypeSupports() = default;
+
+  std::array<std::atomic<Entry *>, 64u> buckets_{};
+};
+
+}  // namespace
+
 extern "C"
 {
 rmw_ret_t
@@ -40,8 +160,11 @@ rmw_serialize(
   }
 
   auto callbacks = static_cast<const message_type_support_callbacks_t *>(ts->data);
-  auto tss = MessageTypeSupport_cpp(callbacks);
-  auto data_length = tss.getEstimatedSerializedSize(ros_message, callbacks);
+  auto tss = SerializationTypeSupports::get_instance().get(callbacks, type_support);
+  if (!tss) {
+    return RMW_RET_ERROR;  // Error message already set
+  }
+  auto data_length = tss->getEstimatedSerializedSize(ros_message, callbacks);
   if (serialized_message->buffer_capacity < data_length) {
     if (rmw_serialized_message_resize(serialized_message, data_length) != RMW_RET_OK) {
       RMW_SET_ERROR_MSG("unable to dynamically resize serialized message");
@@ -55,7 +178,7 @@ rmw_serialize(
     buffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN, eprosima::fastcdr::CdrVersion::XCDRv1);
   ser.set_encoding_flag(eprosima::fastcdr::EncodingAlgorithmFlag::PLAIN_CDR);
 
-  auto ret = tss.serializeROSmessage(ros_message, ser, callbacks);
+  auto ret = tss->serializeROSmessage(ros_message, ser, callbacks);
   serialized_message->buffer_length = data_length;
   serialized_message->buffer_capacity = data_length;
   return ret == true ? RMW_RET_OK : RMW_RET_ERROR;
@@ -79,22 +202,53 @@ rmw_deserialize(
   }
 
   auto callbacks = static_cast<const message_type_support_callbacks_t *>(ts->data);
-  auto tss = MessageTypeSupport_cpp(callbacks);
+  auto tss = SerializationTypeSupports::get_instance().get(callbacks, type_support);
+  if (!tss) {
+    return RMW_RET_ERROR;  // Error message already set
+  }
   eprosima::fastcdr::FastBuffer buffer(
     reinterpret_cast<char *>(serialized_message->buffer), serialized_message->buffer_length);
   eprosima::fastcdr::Cdr deser(buffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN);
 
-  auto ret = tss.deserializeROSmessage(deser, ros_message, callbacks);
+  auto ret = tss->deserializeROSmessage(deser, ros_message, callbacks);
   return ret == true ? RMW_RET_OK : RMW_RET_ERROR;
 }
 
 rmw_ret_t
 rmw_get_serialized_message_size(
-  const rosidl_message_type_support_t * /*type_support*/,
-  const rosidl_runtime_c__Sequence__bound * /*message_bounds*/,
-  size_t * /*size*/)
+  const rosidl_message_type_support_t * type_support,
+  const rosidl_runtime_c__Sequence__bound * message_bounds,
+  size_t * size)
 {
-  RMW_SET_ERROR_MSG("unimplemented");
-  return RMW_RET_UNSUPPORTED;
+  RMW_CHECK_ARGUMENT_FOR_NULL(type_support, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_ARGUMENT_FOR_NULL(size, RMW_RET_INVALID_ARGUMENT);
+
+  const rosidl_message_type_support_t * ts = get_message_typesupport_handle(
+    type_support, RMW_FASTRTPS_CPP_TYPESUPPORT_C);
+  if (!ts) {
+    ts = get_message_typesupport_handle(
+      type_support, RMW_FASTRTPS_CPP_TYPESUPPORT_CPP);
+    if (!ts) {
+      RMW_SET_ERROR_MSG("type support not from this implementation");
+      return RMW_RET_ERROR;
+    }
+  }
+
+  auto callbacks = static_cast<const message_type_support_callbacks_t *>(ts->data);
+  auto tss = SerializationTypeSupports::get_instance().get(callbacks, type_support);
+  if (!tss) {
+    return RMW_RET_ERROR;  // Error message already set
+  }
+  if (!tss->is_bounded()) {
+    // The layout of the data of sequence bounds is not defined by rosidl, so they cannot
+    // be used to bound the members of the type
+    (void)message_bounds;
+    RMW_SET_ERROR_MSG("serialized size of unbounded types is not supported");
+    return RMW_RET_UNSUPPORTED;
+  }
+
+  // Same size publishers preallocate, encapsulation included
+  *size = tss->m_typeSize;
+  return RMW_RET_OK;
 }
 }  // extern "C"
@@ -46,6 +46,7 @@
 
 #include "rmw_dds_common/qos.hpp"
 
+#include "rmw_fastrtps_shared_cpp/client_response_filter.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_service_info.hpp"
 #include "rmw_fastrtps_shared_cpp/names.hpp"
@@ -208,6 +209,7 @@ rmw_create_service(
     });
 
   info->typesupport_identifier_ = type_support->typesupport_identifier;
+  info->defer_responses_ = participant_info->defer_service_responses;
 
   /////
   // Create the Type Support structs
@@ -215,7 +217,7 @@ rmw_create_service(
   info->response_type_support_impl_ = response_members;
 
   if (!request_fastdds_type) {
-    auto tsupport = new (std::nothrow) RequestTypeSupport_cpp(service_members);
+    auto tsupport = new (std::nothrow) RequestTypeSupport_cpp(service_members, type_supports);
     if (!tsupport) {
       RMW_SET_ERROR_MSG("create_service() failed to allocate request typesupport");
       return nullptr;
@@ -224,7 +226,7 @@ rmw_create_service(
     request_fastdds_type.reset(tsupport);
   }
   if (!response_fastdds_type) {
-    auto tsupport = new (std::nothrow) ResponseTypeSupport_cpp(service_members);
+    auto tsupport = new (std::nothrow) ResponseTypeSupport_cpp(service_members, type_supports);
     if (!tsupport) {
       RMW_SET_ERROR_MSG("create_service() failed to allocate response typesupport");
       return nullptr;
@@ -337,6 +339,10 @@ rmw_create_service(
   info->request_reader_->get_statuscondition().set_enabled_statuses(
     eprosima::fastdds::dds::StatusMask::data_available());
 
+  if (participant_info->track_data_readiness) {
+    info->data_readiness_.enable(info->request_reader_, info->listener_);
+  }
+
   // lambda to delete datareader
   auto cleanup_datareader = rcpputils::make_scope_exit(
     [subscriber, info]() {
@@ -384,6 +390,9 @@ rmw_create_service(
     return nullptr;
   }
 
+  // Clients filter the responses on this writer, however many of them there are
+  rmw_fastrtps_shared_cpp::allow_client_response_filters(writer_qos);
+
   // Creates DataWriter with a mask enabling publication_matched calls for the listener
   info->response_writer_ = publisher->create_datawriter(
     info->response_topic_,
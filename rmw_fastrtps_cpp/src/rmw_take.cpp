@@ -20,6 +20,7 @@
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
 
 #include "rmw_fastrtps_cpp/identifier.hpp"
+#include "rmw_fastrtps_cpp/loaned_serialized_message.hpp"
 
 extern "C"
 {
@@ -129,3 +130,28 @@ rmw_take_event(
     eprosima_fastrtps_identifier, event_handle, event_info, taken);
 }
 }  // extern "C"
+
+namespace rmw_fastrtps_cpp
+{
+
+rmw_ret_t
+take_loaned_serialized_message(
+  const rmw_subscription_t * subscription,
+  rmw_serialized_message_t * serialized_message,
+  bool * taken,
+  rmw_message_info_t * message_info)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_take_loaned_serialized_message(
+    eprosima_fastrtps_identifier, subscription, serialized_message, taken, message_info);
+}
+
+rmw_ret_t
+return_loaned_serialized_message(
+  const rmw_subscription_t * subscription,
+  rmw_serialized_message_t * serialized_message)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_return_loaned_serialized_message(
+    eprosima_fastrtps_identifier, subscription, serialized_message);
+}
+
+}  // namespace rmw_fastrtps_cpp
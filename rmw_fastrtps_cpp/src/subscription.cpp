@@ -46,10 +46,12 @@
 
 #include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_subscriber_info.hpp"
+#include "rmw_fastrtps_shared_cpp/local_delivery.hpp"
 #include "rmw_fastrtps_shared_cpp/names.hpp"
 #include "rmw_fastrtps_shared_cpp/namespace_prefix.hpp"
 #include "rmw_fastrtps_shared_cpp/qos.hpp"
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+#include "rmw_fastrtps_shared_cpp/shared_data_reader.hpp"
 #include "rmw_fastrtps_shared_cpp/subscription.hpp"
 #include "rmw_fastrtps_shared_cpp/utils.hpp"
 
@@ -392,6 +394,10 @@ __create_dynamic_subscription(
     return nullptr;
   }
 
+  if (participant_info->data_sharing_for_plain_types && info->type_support_->is_plain()) {
+    enable_data_sharing(reader_qos);
+  }
+
   info->datareader_qos_ = reader_qos;
 
   // create_datareader
@@ -411,6 +417,10 @@ __create_dynamic_subscription(
   info->data_reader_->get_statuscondition().set_enabled_statuses(
     eprosima::fastdds::dds::StatusMask::data_available());
 
+  if (participant_info->track_data_readiness) {
+    info->data_readiness_.enable(info->data_reader_, info->data_reader_listener_);
+  }
+
   // lambda to delete datareader
   auto cleanup_datareader = rcpputils::make_scope_exit(
     [subscriber, info]()
@@ -549,7 +559,7 @@ __create_subscription(
   /////
   // Create the Type Support struct
   if (!fastdds_type) {
-    auto tsupport = new (std::nothrow) MessageTypeSupport_cpp(callbacks);
+    auto tsupport = new (std::nothrow) MessageTypeSupport_cpp(callbacks, type_supports);
     if (!tsupport) {
       RMW_SET_ERROR_MSG("create_subscription() failed to allocate MessageTypeSupport");
       return nullptr;
@@ -659,37 +669,68 @@ __create_subscription(
     return nullptr;
   }
 
-  info->datareader_qos_ = reader_qos;
+  if (participant_info->data_sharing_for_plain_types && info->type_support_->is_plain()) {
+    enable_data_sharing(reader_qos);
+  }
 
-  // create_datareader
-  if (!rmw_fastrtps_shared_cpp::create_datareader(
-      info->datareader_qos_,
-      subscription_options,
-      subscriber,
-      des_topic,
-      info->data_reader_listener_,
-      &info->data_reader_))
+  // Subscriptions match publishers using XCDR2 as well as those using XCDR1
+  if (!participant_info->leave_middleware_default_qos && !info->type_support_->is_plain() &&
+    rmw_fastrtps_shared_cpp::is_xcdr2_interoperable(type_supports))
   {
-    RMW_SET_ERROR_MSG("create_datareader() could not create data reader");
-    return nullptr;
+    enable_xcdr2(reader_qos);
   }
 
-  // Initialize DataReader's StatusCondition to be notified when new data is available
-  info->data_reader_->get_statuscondition().set_enabled_statuses(
-    eprosima::fastdds::dds::StatusMask::data_available());
+  info->datareader_qos_ = reader_qos;
+
+  if (participant_info->share_data_readers &&
+    rmw_fastrtps_shared_cpp::can_share_datareader(subscription_options))
+  {
+    // Also creates the RMW GID
+    if (!rmw_fastrtps_shared_cpp::attach_to_shared_datareader(
+        eprosima_fastrtps_identifier, participant_info, info, subscription_options))
+    {
+      RMW_SET_ERROR_MSG("create_subscription() could not attach to shared data reader");
+      return nullptr;
+    }
+  } else {
+    // create_datareader
+    if (!rmw_fastrtps_shared_cpp::create_datareader(
+        info->datareader_qos_,
+        subscription_options,
+        subscriber,
+        des_topic,
+        info->data_reader_listener_,
+        &info->data_reader_))
+    {
+      RMW_SET_ERROR_MSG("create_datareader() could not create data reader");
+      return nullptr;
+    }
+
+    // Initialize DataReader's StatusCondition to be notified when new data is available
+    info->data_reader_->get_statuscondition().set_enabled_statuses(
+      eprosima::fastdds::dds::StatusMask::data_available());
+
+    if (participant_info->track_data_readiness) {
+      info->data_readiness_.enable(info->data_reader_, info->data_reader_listener_);
+    }
+
+    /////
+    // Create RMW GID
+    info->subscription_gid_ = rmw_fastrtps_shared_cpp::create_rmw_gid(
+      eprosima_fastrtps_identifier, info->data_reader_->guid());
+  }
 
   // lambda to delete datareader
   auto cleanup_datareader = rcpputils::make_scope_exit(
-    [subscriber, info]()
+    [subscriber, participant_info, info]()
     {
-      subscriber->delete_datareader(info->data_reader_);
+      if (info->shared_reader_) {
+        rmw_fastrtps_shared_cpp::detach_from_shared_datareader(participant_info, info);
+      } else {
+        subscriber->delete_datareader(info->data_reader_);
+      }
     });
 
-  /////
-  // Create RMW GID
-  info->subscription_gid_ = rmw_fastrtps_shared_cpp::create_rmw_gid(
-    eprosima_fastrtps_identifier, info->data_reader_->guid());
-
   /////
   // Allocate subscription
   rmw_subscription_t * rmw_subscription = rmw_subscription_allocate();
@@ -714,6 +755,9 @@ __create_subscription(
     return nullptr;
   }
   rmw_subscription->options = *subscription_options;
+  if (participant_info->local_delivery_) {
+    participant_info->local_delivery_->add_subscription(info, subscription_options);
+  }
   rmw_fastrtps_shared_cpp::__init_subscription_for_loans(rmw_subscription);
   rmw_subscription->is_cft_enabled = info->filtered_topic_ != nullptr;
 
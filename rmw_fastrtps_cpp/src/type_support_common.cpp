@@ -28,9 +28,12 @@ TypeSupport::TypeSupport()
   m_isGetKeyDefined = false;
   max_size_bound_ = false;
   is_plain_ = false;
+  copy_plain_ = false;
 }
 
-void TypeSupport::set_members(const message_type_support_callbacks_t * members)
+void TypeSupport::set_members(
+  const message_type_support_callbacks_t * members,
+  const rosidl_message_type_support_t * type_supports)
 {
   members_ = members;
 
@@ -52,6 +55,18 @@ void TypeSupport::set_members(const message_type_support_callbacks_t * members)
   } else {
     has_data_ = true;
   }
+  // Plain messages are laid out in memory as in CDR, without the encapsulation
+  plain_size_ = is_plain_ ? data_size : 0u;
+#ifdef ROSIDL_TYPESUPPORT_FASTRTPS_HAS_PLAIN_TYPES
+  // The generated type support only checked that the last member ends where its CDR does,
+  // so the offset of every member is checked against its CDR position
+  copy_plain_ = is_plain_ && has_data_ && nullptr != type_supports &&
+    rmw_fastrtps_shared_cpp::has_plain_layout(type_supports, plain_size_);
+#else
+  // Older type supports only report whether the type is bounded
+  copy_plain_ = false;
+  (void)type_supports;
+#endif
 
   // Total size is encapsulation size + data size
   m_typeSize = 4 + data_size;
@@ -74,6 +89,14 @@ size_t TypeSupport::getEstimatedSerializedSize(const void * ros_message, const v
   return 4 + callbacks->get_serialized_size(ros_message);
 }
 
+bool TypeSupport::can_copy_plain(const eprosima::fastcdr::Cdr & cdr) const
+{
+  // Only XCDRv1 aligns every primitive to its own size, as the compiler does
+  return copy_plain_ &&
+         eprosima::fastcdr::Cdr::DEFAULT_ENDIAN == cdr.endianness() &&
+         eprosima::fastcdr::CdrVersion::XCDRv1 == cdr.get_cdr_version();
+}
+
 bool TypeSupport::serializeROSmessage(
   const void * ros_message, eprosima::fastcdr::Cdr & ser, const void * impl) const
 {
@@ -83,6 +106,11 @@ bool TypeSupport::serializeROSmessage(
   // Serialize encapsulation
   ser.serialize_encapsulation();
 
+  if (can_copy_plain(ser)) {
+    ser.serialize_array(static_cast<const uint8_t *>(ros_message), plain_size_);
+    return true;
+  }
+
   // If type is not empty, serialize message
   if (has_data_) {
     auto callbacks = static_cast<const message_type_support_callbacks_t *>(impl);
@@ -104,6 +132,11 @@ bool TypeSupport::deserializeROSmessage(
     // Deserialize encapsulation.
     deser.read_encapsulation();
 
+    if (can_copy_plain(deser)) {
+      deser.deserialize_array(static_cast<uint8_t *>(ros_message), plain_size_);
+      return true;
+    }
+
     // If type is not empty, deserialize message
     if (has_data_) {
       auto callbacks = static_cast<const message_type_support_callbacks_t *>(impl);
@@ -129,21 +162,25 @@ bool TypeSupport::deserializeROSmessage(
   return true;
 }
 
-MessageTypeSupport::MessageTypeSupport(const message_type_support_callbacks_t * members)
+MessageTypeSupport::MessageTypeSupport(
+  const message_type_support_callbacks_t * members,
+  const rosidl_message_type_support_t * type_supports)
 {
   assert(members);
 
   std::string name = _create_type_name(members);
   this->setName(name.c_str());
 
-  set_members(members);
+  set_members(members, type_supports);
 }
 
 ServiceTypeSupport::ServiceTypeSupport()
 {
 }
 
-RequestTypeSupport::RequestTypeSupport(const service_type_support_callbacks_t * members)
+RequestTypeSupport::RequestTypeSupport(
+  const service_type_support_callbacks_t * members,
+  const rosidl_service_type_support_t * type_supports)
 {
   assert(members);
 
@@ -152,10 +189,12 @@ RequestTypeSupport::RequestTypeSupport(const service_type_support_callbacks_t *
   std::string name = _create_type_name(msg);  // + "Request_";
   this->setName(name.c_str());
 
-  set_members(msg);
+  set_members(msg, nullptr != type_supports ? type_supports->request_typesupport : nullptr);
 }
 
-ResponseTypeSupport::ResponseTypeSupport(const service_type_support_callbacks_t * members)
+ResponseTypeSupport::ResponseTypeSupport(
+  const service_type_support_callbacks_t * members,
+  const rosidl_service_type_support_t * type_supports)
 {
   assert(members);
 
@@ -164,7 +203,7 @@ ResponseTypeSupport::ResponseTypeSupport(const service_type_support_callbacks_t
   std::string name = _create_type_name(msg);  // + "Response_";
   this->setName(name.c_str());
 
-  set_members(msg);
+  set_members(msg, nullptr != type_supports ? type_supports->response_typesupport : nullptr);
 }
 
 }  // namespace rmw_fastrtps_cpp
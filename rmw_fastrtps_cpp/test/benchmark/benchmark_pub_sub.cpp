@@ -0,0 +1,590 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "fastdds/dds/domain/DomainParticipantFactory.hpp"
+#include "fastrtps/attributes/LibrarySettingsAttributes.h"
+
+#include "rcutils/allocator.h"
+#include "rcutils/env.h"
+#include "rcutils/strdup.h"
+
+#include "rmw/error_handling.h"
+#include "rmw/rmw.h"
+
+#include "rosidl_runtime_c/primitives_sequence_functions.h"
+
+#include "test_msgs/msg/basic_types.h"
+#include "test_msgs/msg/unbounded_sequences.h"
+#include "test_msgs/srv/basic_types.h"
+
+namespace
+{
+
+/// Features of the participant of a Node, which are all off by default.
+struct NodeOptions
+{
+  bool share_data_readers{false};
+  bool local_delivery{false};
+  bool data_sharing{false};
+  // Whether Fast DDS hands samples over in the process, instead of through a transport
+  bool intraprocess_delivery{true};
+};
+
+/// Node in a context of its own, whose participant is configured through the environment.
+class Node
+{
+public:
+  Node(benchmark::State & state, const NodeOptions & node_options = NodeOptions())
+  : state_(state)
+  {
+    // Only read when the participant is created
+    if (!rcutils_set_env(
+        "RMW_FASTRTPS_SHARE_DATA_READERS", node_options.share_data_readers ? "1" : "0") ||
+      !rcutils_set_env("RMW_FASTRTPS_LOCAL_DELIVERY", node_options.local_delivery ? "1" : "0") ||
+      !rcutils_set_env("RMW_FASTRTPS_USE_DATA_SHARING", node_options.data_sharing ? "1" : "0"))
+    {
+      fail("cannot set environment variables");
+      return;
+    }
+    if (!node_options.intraprocess_delivery &&
+      !set_intraprocess_delivery(eprosima::fastrtps::INTRAPROCESS_OFF))
+    {
+      fail("cannot turn intraprocess delivery off");
+      return;
+    }
+    intraprocess_delivery_ = node_options.intraprocess_delivery;
+
+    rcutils_allocator_t allocator = rcutils_get_default_allocator();
+    rmw_init_options_t options = rmw_get_zero_initialized_init_options();
+    if (!check(rmw_init_options_init(&options, allocator))) {
+      return;
+    }
+    options.enclave = rcutils_strdup("/", allocator);
+    options.discovery_options.automatic_discovery_range = RMW_AUTOMATIC_DISCOVERY_RANGE_OFF;
+    const rmw_ret_t ret = rmw_init(&options, &context_);
+    rmw_ret_t fini_ret = rmw_init_options_fini(&options);
+    if (!check(ret) || !check(fini_ret)) {
+      return;
+    }
+    initialized_ = true;
+    node_ = rmw_create_node(&context_, "benchmark_node", "/");
+    check(nullptr != node_);
+  }
+
+  ~Node()
+  {
+    for (rmw_client_t * client : clients_) {
+      rmw_destroy_client(node_, client);
+    }
+    for (rmw_service_t * service : services_) {
+      rmw_destroy_service(node_, service);
+    }
+    for (rmw_subscription_t * sub : subscriptions_) {
+      rmw_destroy_subscription(node_, sub);
+    }
+    for (rmw_publisher_t * pub : publishers_) {
+      rmw_destroy_publisher(node_, pub);
+    }
+    if (nullptr != node_) {
+      rmw_destroy_node(node_);
+    }
+    if (initialized_) {
+      rmw_shutdown(&context_);
+      rmw_context_fini(&context_);
+    }
+    if (!intraprocess_delivery_) {
+      set_intraprocess_delivery(eprosima::fastrtps::INTRAPROCESS_FULL);
+    }
+    rmw_reset_error();
+  }
+
+  bool ok() const
+  {
+    return nullptr != node_ && !failed_;
+  }
+
+  rmw_publisher_t * create_publisher(
+    const rosidl_message_type_support_t * ts, const char * topic_name,
+    const rmw_qos_profile_t & qos_profile = rmw_qos_profile_default)
+  {
+    rmw_publisher_options_t options = rmw_get_default_publisher_options();
+    rmw_publisher_t * pub =
+      rmw_create_publisher(node_, ts, topic_name, &qos_profile, &options);
+    if (check(nullptr != pub)) {
+      publishers_.push_back(pub);
+    }
+    return pub;
+  }
+
+  /// Create a subscription, and wait for it to be matched with a publisher.
+  rmw_subscription_t * create_subscription(
+    const rosidl_message_type_support_t * ts, const char * topic_name,
+    const rmw_qos_profile_t & qos_profile = rmw_qos_profile_default)
+  {
+    rmw_subscription_options_t options = rmw_get_default_subscription_options();
+    rmw_subscription_t * sub =
+      rmw_create_subscription(node_, ts, topic_name, &qos_profile, &options);
+    if (!check(nullptr != sub)) {
+      return nullptr;
+    }
+    subscriptions_.push_back(sub);
+
+    size_t count = 0u;
+    for (int i = 0; i < 100 && 0u == count; ++i) {
+      if (!check(rmw_subscription_count_matched_publishers(sub, &count))) {
+        return nullptr;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (0u == count) {
+      fail("subscription not matched");
+      return nullptr;
+    }
+    return sub;
+  }
+
+  rmw_service_t * create_service(
+    const rosidl_service_type_support_t * ts, const char * service_name)
+  {
+    rmw_service_t * service =
+      rmw_create_service(node_, ts, service_name, &rmw_qos_profile_services_default);
+    if (check(nullptr != service)) {
+      services_.push_back(service);
+    }
+    return service;
+  }
+
+  /// Create a client, and wait for its service to be available.
+  rmw_client_t * create_client(
+    const rosidl_service_type_support_t * ts, const char * service_name)
+  {
+    rmw_client_t * client =
+      rmw_create_client(node_, ts, service_name, &rmw_qos_profile_services_default);
+    if (!check(nullptr != client)) {
+      return nullptr;
+    }
+    clients_.push_back(client);
+
+    bool is_available = false;
+    for (int i = 0; i < 100 && !is_available; ++i) {
+      if (!check(rmw_service_server_is_available(node_, client, &is_available))) {
+        return nullptr;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (!is_available) {
+      fail("service not available");
+      return nullptr;
+    }
+    return client;
+  }
+
+  /// Take a message from `sub`, waiting for up to a second for it to arrive.
+  bool take(const rmw_subscription_t * sub, void * ros_message)
+  {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    bool taken = false;
+    while (!taken) {
+      if (!check(rmw_take(sub, ros_message, &taken, nullptr))) {
+        return false;
+      }
+      if (!taken && std::chrono::steady_clock::now() > deadline) {
+        fail("message not received");
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool check(rmw_ret_t ret)
+  {
+    return check(RMW_RET_OK == ret);
+  }
+
+  bool check(bool condition)
+  {
+    if (!condition) {
+      fail(rmw_get_error_string().str);
+      rmw_reset_error();
+    }
+    return condition;
+  }
+
+  void fail(const char * message)
+  {
+    if (!failed_) {
+      state_.SkipWithError(message);
+      failed_ = true;
+    }
+  }
+
+private:
+  // Only possible while there are no participants
+  static bool set_intraprocess_delivery(eprosima::fastrtps::IntraprocessDeliveryType delivery)
+  {
+    auto factory = eprosima::fastdds::dds::DomainParticipantFactory::get_instance();
+    eprosima::fastrtps::LibrarySettingsAttributes library_settings;
+    library_settings.intraprocess_delivery = delivery;
+    const auto ret = factory->set_library_settings(library_settings);
+    return eprosima::fastrtps::types::ReturnCode_t::RETCODE_OK == ret;
+  }
+
+  benchmark::State & state_;
+  bool failed_{false};
+  rmw_context_t context_{rmw_get_zero_initialized_context()};
+  bool initialized_{false};
+  bool intraprocess_delivery_{true};
+  rmw_node_t * node_{nullptr};
+  std::vector<rmw_publisher_t *> publishers_;
+  std::vector<rmw_subscription_t *> subscriptions_;
+  std::vector<rmw_service_t *> services_;
+  std::vector<rmw_client_t *> clients_;
+};
+
+}  // namespace
+
+// Small messages published to many subscriptions of the same topic, with a DataReader each or
+// sharing one
+static void BM_fan_out(benchmark::State & state)
+{
+  NodeOptions node_options;
+  node_options.share_data_readers = 0 != state.range(0);
+  const size_t subscription_count = static_cast<size_t>(state.range(1));
+  Node node(state, node_options);
+  if (!node.ok()) {
+    return;
+  }
+
+  const rosidl_message_type_support_t * ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, BasicTypes);
+  const char * topic_name = "/benchmark_fan_out";
+  rmw_publisher_t * pub = node.create_publisher(ts, topic_name);
+  std::vector<rmw_subscription_t *> subs;
+  for (size_t i = 0; i < subscription_count && node.ok(); ++i) {
+    subs.push_back(node.create_subscription(ts, topic_name));
+  }
+  if (!node.ok()) {
+    return;
+  }
+
+  test_msgs__msg__BasicTypes msg;
+  test_msgs__msg__BasicTypes__init(&msg);
+  test_msgs__msg__BasicTypes received;
+  test_msgs__msg__BasicTypes__init(&received);
+
+  for (auto _ : state) {
+    msg.int64_value++;
+    node.check(rmw_publish(pub, &msg, nullptr));
+    for (size_t i = 0; i < subs.size() && node.ok(); ++i) {
+      node.take(subs[i], &received);
+    }
+    if (!node.ok()) {
+      break;
+    }
+  }
+  state.SetItemsProcessed(
+    static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(subscription_count));
+
+  test_msgs__msg__BasicTypes__fini(&received);
+  test_msgs__msg__BasicTypes__fini(&msg);
+}
+BENCHMARK(BM_fan_out)
+->ArgNames({"share_data_readers", "subscriptions"})
+->ArgsProduct({{0, 1}, {1, 4, 12}})
+->UseRealTime();
+
+// Large messages published to a subscription of the same context, through the DataWriter or
+// handed over locally
+static void BM_local_delivery(benchmark::State & state)
+{
+  NodeOptions node_options;
+  node_options.local_delivery = 0 != state.range(0);
+  const size_t size = static_cast<size_t>(state.range(1));
+  Node node(state, node_options);
+  if (!node.ok()) {
+    return;
+  }
+
+  const rosidl_message_type_support_t * ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, UnboundedSequences);
+  const char * topic_name = "/benchmark_local_delivery";
+  rmw_publisher_t * pub = node.create_publisher(ts, topic_name);
+  rmw_subscription_t * sub = node.create_subscription(ts, topic_name);
+  if (!node.ok()) {
+    return;
+  }
+
+  test_msgs__msg__UnboundedSequences msg;
+  test_msgs__msg__UnboundedSequences__init(&msg);
+  rosidl_runtime_c__uint8__Sequence__fini(&msg.uint8_values);
+  if (!rosidl_runtime_c__uint8__Sequence__init(&msg.uint8_values, size)) {
+    state.SkipWithError("cannot allocate the message");
+  }
+  test_msgs__msg__UnboundedSequences received;
+  test_msgs__msg__UnboundedSequences__init(&received);
+
+  for (auto _ : state) {
+    if (nullptr == msg.uint8_values.data) {
+      break;
+    }
+    msg.uint8_values.data[0]++;
+    node.check(rmw_publish(pub, &msg, nullptr));
+    if (!node.ok() || !node.take(sub, &received)) {
+      break;
+    }
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(size));
+
+  test_msgs__msg__UnboundedSequences__fini(&received);
+  test_msgs__msg__UnboundedSequences__fini(&msg);
+}
+BENCHMARK(BM_local_delivery)
+->ArgNames({"local_delivery", "bytes"})
+->ArgsProduct({{0, 1}, {1024, 1024 * 1024}})
+->UseRealTime();
+
+// Small messages taken in batches of increasing size, whose cost per message is reported
+static void BM_take_sequence(benchmark::State & state)
+{
+  const size_t batch_size = static_cast<size_t>(state.range(0));
+  Node node(state);
+  if (!node.ok()) {
+    return;
+  }
+
+  // Deep enough for a whole batch
+  rmw_qos_profile_t qos_profile = rmw_qos_profile_default;
+  qos_profile.depth = batch_size;
+  const rosidl_message_type_support_t * ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, BasicTypes);
+  const char * topic_name = "/benchmark_take_sequence";
+  rmw_publisher_t * pub = node.create_publisher(ts, topic_name, qos_profile);
+  rmw_subscription_t * sub = node.create_subscription(ts, topic_name, qos_profile);
+  if (!node.ok()) {
+    return;
+  }
+
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rmw_message_sequence_t message_sequence = rmw_get_zero_initialized_message_sequence();
+  rmw_message_info_sequence_t info_sequence = rmw_get_zero_initialized_message_info_sequence();
+  if (!node.check(rmw_message_sequence_init(&message_sequence, batch_size, &allocator)) ||
+    !node.check(rmw_message_info_sequence_init(&info_sequence, batch_size, &allocator)))
+  {
+    rmw_message_sequence_fini(&message_sequence);
+    return;
+  }
+  std::vector<test_msgs__msg__BasicTypes> received(batch_size);
+  for (test_msgs__msg__BasicTypes & message : received) {
+    test_msgs__msg__BasicTypes__init(&message);
+  }
+  test_msgs__msg__BasicTypes msg;
+  test_msgs__msg__BasicTypes__init(&msg);
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    for (size_t i = 0; i < batch_size && node.ok(); ++i) {
+      msg.int64_value++;
+      node.check(rmw_publish(pub, &msg, nullptr));
+    }
+    state.ResumeTiming();
+
+    // Messages are delivered as they are published, so a single take is expected
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    size_t total = 0u;
+    while (total < batch_size && node.ok()) {
+      message_sequence.size = 0u;
+      info_sequence.size = 0u;
+      for (size_t i = 0; i < batch_size - total; ++i) {
+        message_sequence.data[i] = &received[total + i];
+      }
+      size_t taken = 0u;
+      node.check(
+        rmw_take_sequence(
+          sub, batch_size - total, &message_sequence, &info_sequence, &taken, nullptr));
+      total += taken;
+      if (total < batch_size && std::chrono::steady_clock::now() > deadline) {
+        node.fail("messages not received");
+      }
+    }
+    if (!node.ok()) {
+      break;
+    }
+  }
+  state.SetItemsProcessed(
+    static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(batch_size));
+
+  test_msgs__msg__BasicTypes__fini(&msg);
+  for (test_msgs__msg__BasicTypes & message : received) {
+    test_msgs__msg__BasicTypes__fini(&message);
+  }
+  rmw_message_info_sequence_fini(&info_sequence);
+  rmw_message_sequence_fini(&message_sequence);
+}
+BENCHMARK(BM_take_sequence)
+->ArgNames({"batch_size"})
+->Arg(1)->Arg(8)->Arg(64)
+->UseRealTime();
+
+// Plain messages published to a subscription on the same host, through data-sharing or through
+// the shared memory transport, using loans when they are available
+static void BM_plain_transport(benchmark::State & state)
+{
+  NodeOptions node_options;
+  node_options.data_sharing = 0 != state.range(0);
+  // Otherwise samples never leave the process
+  node_options.intraprocess_delivery = false;
+  Node node(state, node_options);
+  if (!node.ok()) {
+    return;
+  }
+
+  const rosidl_message_type_support_t * ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, BasicTypes);
+  const char * topic_name = "/benchmark_plain_transport";
+  rmw_publisher_t * pub = node.create_publisher(ts, topic_name);
+  rmw_subscription_t * sub = node.create_subscription(ts, topic_name);
+  if (!node.ok()) {
+    return;
+  }
+  state.counters["publisher_loans"] = pub->can_loan_messages ? 1 : 0;
+  state.counters["subscription_loans"] = sub->can_loan_messages ? 1 : 0;
+
+  test_msgs__msg__BasicTypes msg;
+  test_msgs__msg__BasicTypes__init(&msg);
+  test_msgs__msg__BasicTypes received;
+  test_msgs__msg__BasicTypes__init(&received);
+
+  for (auto _ : state) {
+    msg.int64_value++;
+    if (pub->can_loan_messages) {
+      void * loaned_message = nullptr;
+      if (!node.check(rmw_borrow_loaned_message(pub, ts, &loaned_message))) {
+        break;
+      }
+      *static_cast<test_msgs__msg__BasicTypes *>(loaned_message) = msg;
+      node.check(rmw_publish_loaned_message(pub, loaned_message, nullptr));
+    } else {
+      node.check(rmw_publish(pub, &msg, nullptr));
+    }
+    if (!node.ok()) {
+      break;
+    }
+
+    if (sub->can_loan_messages) {
+      const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+      void * loaned_message = nullptr;
+      bool taken = false;
+      while (!taken && node.ok()) {
+        node.check(rmw_take_loaned_message(sub, &loaned_message, &taken, nullptr));
+        if (!taken && std::chrono::steady_clock::now() > deadline) {
+          node.fail("message not received");
+        }
+      }
+      if (taken) {
+        node.check(rmw_return_loaned_message_from_subscription(sub, loaned_message));
+      }
+    } else {
+      node.take(sub, &received);
+    }
+    if (!node.ok()) {
+      break;
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+
+  test_msgs__msg__BasicTypes__fini(&received);
+  test_msgs__msg__BasicTypes__fini(&msg);
+}
+BENCHMARK(BM_plain_transport)
+->ArgNames({"data_sharing"})
+->Arg(0)->Arg(1)
+->UseRealTime();
+
+// Every client of a service sending a request at once, which the service answers, with the
+// responses to the other clients filtered out before they reach each client
+static void BM_service_clients(benchmark::State & state)
+{
+  const size_t client_count = static_cast<size_t>(state.range(0));
+  Node node(state);
+  if (!node.ok()) {
+    return;
+  }
+
+  const rosidl_service_type_support_t * ts =
+    ROSIDL_GET_SRV_TYPE_SUPPORT(test_msgs, srv, BasicTypes);
+  const char * service_name = "/benchmark_service_clients";
+  rmw_service_t * service = node.create_service(ts, service_name);
+  std::vector<rmw_client_t *> clients;
+  for (size_t i = 0; i < client_count && node.ok(); ++i) {
+    clients.push_back(node.create_client(ts, service_name));
+  }
+  if (!node.ok()) {
+    return;
+  }
+
+  test_msgs__srv__BasicTypes_Request request;
+  test_msgs__srv__BasicTypes_Request__init(&request);
+  test_msgs__srv__BasicTypes_Response response;
+  test_msgs__srv__BasicTypes_Response__init(&response);
+
+  for (auto _ : state) {
+    for (rmw_client_t * client : clients) {
+      int64_t sequence_number = 0;
+      node.check(rmw_send_request(client, &request, &sequence_number));
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    size_t replied = 0u;
+    while (replied < client_count && node.ok()) {
+      rmw_service_info_t header;
+      bool taken = false;
+      node.check(rmw_take_request(service, &header, &request, &taken));
+      if (taken) {
+        node.check(rmw_send_response(service, &header.request_id, &response));
+        ++replied;
+      } else if (std::chrono::steady_clock::now() > deadline) {
+        node.fail("request not received");
+      }
+    }
+
+    for (size_t i = 0; i < client_count && node.ok(); ++i) {
+      rmw_service_info_t header;
+      bool taken = false;
+      while (!taken && node.ok()) {
+        node.check(rmw_take_response(clients[i], &header, &response, &taken));
+        if (!taken && std::chrono::steady_clock::now() > deadline) {
+          node.fail("response not received");
+        }
+      }
+    }
+    if (!node.ok()) {
+      break;
+    }
+  }
+  state.SetItemsProcessed(
+    static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(client_count));
+
+  test_msgs__srv__BasicTypes_Response__fini(&response);
+  test_msgs__srv__BasicTypes_Request__fini(&request);
+}
+BENCHMARK(BM_service_clients)
+->ArgNames({"clients"})
+->Arg(1)->Arg(10)->Arg(40)
+->UseRealTime();
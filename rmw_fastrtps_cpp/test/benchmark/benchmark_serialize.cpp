@@ -0,0 +1,380 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "fastcdr/Cdr.h"
+#include "fastcdr/FastBuffer.h"
+
+#include "rcutils/allocator.h"
+
+#include "rmw/error_handling.h"
+#include "rmw/rmw.h"
+#include "rmw/serialized_message.h"
+
+#include "rmw_fastrtps_cpp/MessageTypeSupport.hpp"
+#include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
+
+#include "rosidl_typesupport_cpp/message_type_support.hpp"
+#include "rosidl_typesupport_fastrtps_cpp/identifier.hpp"
+
+#include "sensor_msgs/msg/imu.hpp"
+#include "sensor_msgs/msg/point_cloud2.hpp"
+#include "sensor_msgs/msg/point_field.hpp"
+
+#include "test_msgs/msg/arrays.hpp"
+#include "test_msgs/msg/basic_types.hpp"
+#include "test_msgs/msg/nested.hpp"
+#include "test_msgs/msg/strings.hpp"
+#include "test_msgs/msg/unbounded_sequences.hpp"
+
+// Cases named as in the benchmarks of the other type support package, to compare them
+
+namespace
+{
+
+template<typename MessageT>
+MessageT make_message()
+{
+  return MessageT();
+}
+
+template<>
+test_msgs::msg::UnboundedSequences make_message<test_msgs::msg::UnboundedSequences>()
+{
+  test_msgs::msg::UnboundedSequences msg;
+  msg.float64_values.assign(1000u, 1.5);
+  msg.int32_values.assign(1000u, -7);
+  msg.string_values.assign(100u, "value");
+  return msg;
+}
+
+template<>
+sensor_msgs::msg::Imu make_message<sensor_msgs::msg::Imu>()
+{
+  // The doubles following the frame id are aligned to 8 bytes with XCDR1 only
+  sensor_msgs::msg::Imu msg;
+  msg.header.frame_id = "imu_link";
+  msg.orientation.w = 1.0;
+  msg.linear_acceleration.z = 9.81;
+  return msg;
+}
+
+template<>
+sensor_msgs::msg::PointCloud2 make_message<sensor_msgs::msg::PointCloud2>()
+{
+  sensor_msgs::msg::PointCloud2 msg;
+  msg.header.frame_id = "lidar";
+  uint32_t offset = 0u;
+  for (const char * name : {"x", "y", "z", "intensity"}) {
+    sensor_msgs::msg::PointField field;
+    field.name = name;
+    field.offset = offset;
+    field.datatype = sensor_msgs::msg::PointField::FLOAT32;
+    field.count = 1u;
+    msg.fields.push_back(field);
+    offset += 4u;
+  }
+  msg.height = 1u;
+  msg.width = 1000u;
+  msg.point_step = offset;
+  msg.row_step = msg.width * msg.point_step;
+  msg.data.assign(msg.row_step, 0u);
+  msg.is_dense = true;
+  return msg;
+}
+
+template<typename MessageT>
+const message_type_support_callbacks_t * get_callbacks()
+{
+  const rosidl_message_type_support_t * ts = get_message_typesupport_handle(
+    rosidl_typesupport_cpp::get_message_type_support_handle<MessageT>(),
+    rosidl_typesupport_fastrtps_cpp::typesupport_identifier);
+  return nullptr == ts ? nullptr : static_cast<const message_type_support_callbacks_t *>(ts->data);
+}
+
+/// Serialized message for the lifetime of a benchmark.
+class SerializedMessage
+{
+public:
+  explicit SerializedMessage(benchmark::State & state)
+  {
+    rcutils_allocator_t allocator = rcutils_get_default_allocator();
+    if (RMW_RET_OK != rmw_serialized_message_init(&message, 0u, &allocator)) {
+      state.SkipWithError(rmw_get_error_string().str);
+      rmw_reset_error();
+    }
+  }
+
+  ~SerializedMessage()
+  {
+    rmw_serialized_message_fini(&message);
+  }
+
+  rmw_serialized_message_t message{rmw_get_zero_initialized_serialized_message()};
+};
+
+}  // namespace
+
+template<typename MessageT>
+static void BM_serialize(benchmark::State & state)
+{
+  const rosidl_message_type_support_t * ts =
+    rosidl_typesupport_cpp::get_message_type_support_handle<MessageT>();
+  const MessageT msg = make_message<MessageT>();
+  SerializedMessage serialized(state);
+
+  for (auto _ : state) {
+    if (RMW_RET_OK != rmw_serialize(&msg, ts, &serialized.message)) {
+      state.SkipWithError(rmw_get_error_string().str);
+      rmw_reset_error();
+      break;
+    }
+    benchmark::DoNotOptimize(serialized.message.buffer);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(
+    static_cast<int64_t>(state.iterations()) *
+    static_cast<int64_t>(serialized.message.buffer_length));
+}
+BENCHMARK_TEMPLATE(BM_serialize, test_msgs::msg::BasicTypes);
+BENCHMARK_TEMPLATE(BM_serialize, test_msgs::msg::Arrays);
+BENCHMARK_TEMPLATE(BM_serialize, test_msgs::msg::Nested);
+BENCHMARK_TEMPLATE(BM_serialize, test_msgs::msg::Strings);
+BENCHMARK_TEMPLATE(BM_serialize, test_msgs::msg::UnboundedSequences);
+
+template<typename MessageT>
+static void BM_deserialize(benchmark::State & state)
+{
+  const rosidl_message_type_support_t * ts =
+    rosidl_typesupport_cpp::get_message_type_support_handle<MessageT>();
+  const MessageT input = make_message<MessageT>();
+  SerializedMessage serialized(state);
+  if (RMW_RET_OK != rmw_serialize(&input, ts, &serialized.message)) {
+    state.SkipWithError(rmw_get_error_string().str);
+    rmw_reset_error();
+    return;
+  }
+  MessageT msg;
+
+  for (auto _ : state) {
+    if (RMW_RET_OK != rmw_deserialize(&serialized.message, ts, &msg)) {
+      state.SkipWithError(rmw_get_error_string().str);
+      rmw_reset_error();
+      break;
+    }
+    benchmark::DoNotOptimize(msg);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(
+    static_cast<int64_t>(state.iterations()) *
+    static_cast<int64_t>(serialized.message.buffer_length));
+}
+BENCHMARK_TEMPLATE(BM_deserialize, test_msgs::msg::BasicTypes);
+BENCHMARK_TEMPLATE(BM_deserialize, test_msgs::msg::Arrays);
+BENCHMARK_TEMPLATE(BM_deserialize, test_msgs::msg::Nested);
+BENCHMARK_TEMPLATE(BM_deserialize, test_msgs::msg::Strings);
+BENCHMARK_TEMPLATE(BM_deserialize, test_msgs::msg::UnboundedSequences);
+
+// Plain messages, copied as is or serialized by the generated code
+template<typename MessageT>
+static void BM_serialize_plain(benchmark::State & state)
+{
+  const bool copy = 0 != state.range(0);
+  const message_type_support_callbacks_t * callbacks = get_callbacks<MessageT>();
+  if (nullptr == callbacks) {
+    state.SkipWithError(rmw_get_error_string().str);
+    rmw_reset_error();
+    return;
+  }
+  rmw_fastrtps_cpp::MessageTypeSupport type_support(
+    callbacks, rosidl_typesupport_cpp::get_message_type_support_handle<MessageT>());
+  state.SetLabel(type_support.is_plain() ? "plain" : "not plain");
+  const MessageT msg = make_message<MessageT>();
+  std::vector<char> buffer(type_support.getEstimatedSerializedSize(&msg, callbacks));
+
+  for (auto _ : state) {
+    eprosima::fastcdr::FastBuffer fast_buffer(buffer.data(), buffer.size());
+    eprosima::fastcdr::Cdr ser(
+      fast_buffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN, eprosima::fastcdr::CdrVersion::XCDRv1);
+    ser.set_encoding_flag(eprosima::fastcdr::EncodingAlgorithmFlag::PLAIN_CDR);
+    bool ret = false;
+    if (copy) {
+      ret = type_support.serializeROSmessage(&msg, ser, callbacks);
+    } else {
+      ser.serialize_encapsulation();
+      ret = callbacks->cdr_serialize(&msg, ser);
+    }
+    if (!ret) {
+      state.SkipWithError("serialization failed");
+      break;
+    }
+    benchmark::DoNotOptimize(buffer.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(
+    static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(buffer.size()));
+}
+BENCHMARK_TEMPLATE(BM_serialize_plain, test_msgs::msg::BasicTypes)
+->ArgName("copy")->Arg(0)->Arg(1);
+BENCHMARK_TEMPLATE(BM_serialize_plain, test_msgs::msg::Nested)
+->ArgName("copy")->Arg(0)->Arg(1);
+
+template<typename MessageT>
+static void BM_deserialize_plain(benchmark::State & state)
+{
+  const bool copy = 0 != state.range(0);
+  const message_type_support_callbacks_t * callbacks = get_callbacks<MessageT>();
+  if (nullptr == callbacks) {
+    state.SkipWithError(rmw_get_error_string().str);
+    rmw_reset_error();
+    return;
+  }
+  rmw_fastrtps_cpp::MessageTypeSupport type_support(
+    callbacks, rosidl_typesupport_cpp::get_message_type_support_handle<MessageT>());
+  state.SetLabel(type_support.is_plain() ? "plain" : "not plain");
+  const MessageT input = make_message<MessageT>();
+  std::vector<char> buffer(type_support.getEstimatedSerializedSize(&input, callbacks));
+  {
+    eprosima::fastcdr::FastBuffer fast_buffer(buffer.data(), buffer.size());
+    eprosima::fastcdr::Cdr ser(
+      fast_buffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN, eprosima::fastcdr::CdrVersion::XCDRv1);
+    ser.set_encoding_flag(eprosima::fastcdr::EncodingAlgorithmFlag::PLAIN_CDR);
+    if (!type_support.serializeROSmessage(&input, ser, callbacks)) {
+      state.SkipWithError("serialization failed");
+      return;
+    }
+  }
+  MessageT msg;
+
+  for (auto _ : state) {
+    eprosima::fastcdr::FastBuffer fast_buffer(buffer.data(), buffer.size());
+    eprosima::fastcdr::Cdr deser(fast_buffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN);
+    bool ret = false;
+    if (copy) {
+      ret = type_support.deserializeROSmessage(deser, &msg, callbacks);
+    } else {
+      deser.read_encapsulation();
+      ret = callbacks->cdr_deserialize(deser, &msg);
+    }
+    if (!ret) {
+      state.SkipWithError("deserialization failed");
+      break;
+    }
+    benchmark::DoNotOptimize(msg);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(
+    static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(buffer.size()));
+}
+BENCHMARK_TEMPLATE(BM_deserialize_plain, test_msgs::msg::BasicTypes)
+->ArgName("copy")->Arg(0)->Arg(1);
+BENCHMARK_TEMPLATE(BM_deserialize_plain, test_msgs::msg::Nested)
+->ArgName("copy")->Arg(0)->Arg(1);
+
+// What rmw_serialize did before caching type supports: build one for each call.
+// Compare with BM_serialize of the same type.
+template<typename MessageT>
+static void BM_serialize_uncached(benchmark::State & state)
+{
+  const message_type_support_callbacks_t * callbacks = get_callbacks<MessageT>();
+  if (nullptr == callbacks) {
+    state.SkipWithError(rmw_get_error_string().str);
+    rmw_reset_error();
+    return;
+  }
+  const MessageT msg = make_message<MessageT>();
+  SerializedMessage serialized(state);
+
+  for (auto _ : state) {
+    rmw_fastrtps_cpp::MessageTypeSupport type_support(callbacks);
+    const size_t data_length = type_support.getEstimatedSerializedSize(&msg, callbacks);
+    if (serialized.message.buffer_capacity < data_length &&
+      RMW_RET_OK != rmw_serialized_message_resize(&serialized.message, data_length))
+    {
+      state.SkipWithError(rmw_get_error_string().str);
+      rmw_reset_error();
+      break;
+    }
+    eprosima::fastcdr::FastBuffer buffer(
+      reinterpret_cast<char *>(serialized.message.buffer), data_length);
+    eprosima::fastcdr::Cdr ser(
+      buffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN, eprosima::fastcdr::CdrVersion::XCDRv1);
+    ser.set_encoding_flag(eprosima::fastcdr::EncodingAlgorithmFlag::PLAIN_CDR);
+    if (!type_support.serializeROSmessage(&msg, ser, callbacks)) {
+      state.SkipWithError("serialization failed");
+      break;
+    }
+    serialized.message.buffer_length = data_length;
+    benchmark::DoNotOptimize(serialized.message.buffer);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(
+    static_cast<int64_t>(state.iterations()) *
+    static_cast<int64_t>(serialized.message.buffer_length));
+}
+BENCHMARK_TEMPLATE(BM_serialize_uncached, test_msgs::msg::BasicTypes);
+BENCHMARK_TEMPLATE(BM_serialize_uncached, test_msgs::msg::Strings);
+
+// Payloads written with XCDR1 or XCDR2, and their size
+template<typename MessageT>
+static void BM_serialize_payload(benchmark::State & state)
+{
+  const bool xcdr2 = 0 != state.range(0);
+  const message_type_support_callbacks_t * callbacks = get_callbacks<MessageT>();
+  if (nullptr == callbacks) {
+    state.SkipWithError(rmw_get_error_string().str);
+    rmw_reset_error();
+    return;
+  }
+  rmw_fastrtps_cpp::MessageTypeSupport type_support(callbacks);
+  // Publishers only use XCDR2 for some types, even when enabled
+  if (type_support.is_plain()) {
+    state.SetLabel("plain");
+  } else if (!rmw_fastrtps_shared_cpp::is_xcdr2_interoperable(
+      rosidl_typesupport_cpp::get_message_type_support_handle<MessageT>()))
+  {
+    state.SetLabel("not interoperable over XCDR2");
+  }
+  MessageT msg = make_message<MessageT>();
+  rmw_fastrtps_shared_cpp::SerializedData data;
+  data.type = FASTRTPS_SERIALIZED_DATA_TYPE_ROS_MESSAGE;
+  data.data = &msg;
+  data.impl = callbacks;
+  eprosima::fastrtps::rtps::SerializedPayload_t payload(
+    static_cast<uint32_t>(type_support.getEstimatedSerializedSize(&msg, callbacks)));
+  const eprosima::fastdds::dds::DataRepresentationId_t data_representation = xcdr2 ?
+    eprosima::fastdds::dds::XCDR2_DATA_REPRESENTATION :
+    eprosima::fastdds::dds::XCDR_DATA_REPRESENTATION;
+
+  for (auto _ : state) {
+    if (!type_support.serialize(&data, &payload, data_representation)) {
+      state.SkipWithError("serialization failed");
+      break;
+    }
+    benchmark::DoNotOptimize(payload.data);
+    benchmark::ClobberMemory();
+  }
+  state.counters["payload_bytes"] = payload.length;
+  state.SetBytesProcessed(
+    static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(payload.length));
+}
+// Imu is serialized with XCDR2 when enabled, PointCloud2 keeps XCDR1 for its sequence of fields
+BENCHMARK_TEMPLATE(BM_serialize_payload, sensor_msgs::msg::Imu)
+->ArgName("xcdr2")->Arg(0)->Arg(1);
+BENCHMARK_TEMPLATE(BM_serialize_payload, sensor_msgs::msg::PointCloud2)
+->ArgName("xcdr2")->Arg(0)->Arg(1);
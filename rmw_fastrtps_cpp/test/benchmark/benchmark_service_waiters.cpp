@@ -0,0 +1,158 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "fastdds/dds/core/status/PublicationMatchedStatus.hpp"
+#include "fastdds/rtps/common/Guid.h"
+#include "fastdds/rtps/common/InstanceHandle.h"
+
+#include "rmw_fastrtps_shared_cpp/custom_service_info.hpp"
+
+namespace
+{
+
+// GUID of the response reader of the client `index`, from a participant of its own
+eprosima::fastrtps::rtps::GUID_t
+make_reader_guid(size_t index)
+{
+  eprosima::fastrtps::rtps::GUID_t guid;
+  for (size_t i = 0; i < sizeof(index); ++i) {
+    guid.guidPrefix.value[i] = static_cast<eprosima::fastrtps::rtps::octet>(index >> (8 * i));
+  }
+  guid.entityId = eprosima::fastrtps::rtps::EntityId_t(0x104);
+  return guid;
+}
+
+// Have the listener of a response writer see a reader being matched or unmatched
+void
+match(
+  ServicePubListener & listener,
+  const eprosima::fastrtps::rtps::GUID_t & guid,
+  int32_t count_change)
+{
+  eprosima::fastdds::dds::PublicationMatchedStatus status;
+  status.current_count_change = count_change;
+  status.last_subscription_handle = eprosima::fastrtps::rtps::InstanceHandle_t(guid);
+  // The writer is only used to flush deferred responses, and there are none
+  listener.on_publication_matched(nullptr, status);
+}
+
+}  // namespace
+
+// Many first-time clients whose responses wait for their response reader to be matched, as when
+// a service answers requests which arrived before the matching of their clients. Each match only
+// wakes up the thread waiting for that reader.
+static void BM_service_match_waiters(benchmark::State & state)
+{
+  const size_t waiter_count = static_cast<size_t>(state.range(0));
+  ServicePubListener listener(nullptr);
+  std::vector<eprosima::fastrtps::rtps::GUID_t> guids;
+  for (size_t i = 0; i < waiter_count; ++i) {
+    guids.push_back(make_reader_guid(i));
+  }
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  uint64_t round = 0u;
+  size_t waiting = 0u;
+  size_t done = 0u;
+  bool stop = false;
+  std::atomic<bool> timed_out{false};
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < waiter_count; ++i) {
+    threads.emplace_back(
+      [&, i]() {
+        uint64_t last_round = 0u;
+        while (true) {
+          {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&]() {return stop || round != last_round;});
+            if (stop) {
+              return;
+            }
+            last_round = round;
+            ++waiting;
+          }
+          cv.notify_all();
+
+          if (!listener.wait_for_subscription(guids[i], std::chrono::seconds(10))) {
+            timed_out = true;
+          }
+
+          {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++done;
+          }
+          cv.notify_all();
+        }
+      });
+  }
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      waiting = 0u;
+      done = 0u;
+      ++round;
+      cv.notify_all();
+      // Most of them are blocked waiting by the time their reader is matched
+      cv.wait(lock, [&]() {return waiting == waiter_count;});
+    }
+    state.ResumeTiming();
+
+    for (const eprosima::fastrtps::rtps::GUID_t & guid : guids) {
+      match(listener, guid, 1);
+    }
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [&]() {return done == waiter_count;});
+    }
+
+    state.PauseTiming();
+    // Next round, the clients are new again
+    for (const eprosima::fastrtps::rtps::GUID_t & guid : guids) {
+      match(listener, guid, -1);
+    }
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(
+    static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(waiter_count));
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+  }
+  cv.notify_all();
+  for (std::thread & thread : threads) {
+    thread.join();
+  }
+  if (timed_out) {
+    state.SkipWithError("a reader was matched without waking up its waiter");
+  }
+}
+BENCHMARK(BM_service_match_waiters)
+->ArgNames({"clients"})
+->Arg(16)->Arg(128)->Arg(512)
+->UseRealTime();
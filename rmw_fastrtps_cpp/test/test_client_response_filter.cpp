@@ -0,0 +1,183 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "fastdds/dds/publisher/DataWriter.hpp"
+
+#include "osrf_testing_tools_cpp/scope_exit.hpp"
+
+#include "rcutils/allocator.h"
+#include "rcutils/strdup.h"
+
+#include "rmw/error_handling.h"
+#include "rmw/rmw.h"
+
+#include "rmw_fastrtps_shared_cpp/custom_service_info.hpp"
+
+#include "test_msgs/srv/basic_types.h"
+
+namespace
+{
+
+// More clients than the reader filters Fast DDS keeps per writer by default
+constexpr size_t client_count = 40u;
+
+}  // namespace
+
+class TestClientResponseFilter : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    rmw_init_options_t options = rmw_get_zero_initialized_init_options();
+    rmw_ret_t ret = rmw_init_options_init(&options, rcutils_get_default_allocator());
+    ASSERT_EQ(RMW_RET_OK, ret) << rcutils_get_error_string().str;
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      rmw_ret_t ret = rmw_init_options_fini(&options);
+      EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    });
+    options.enclave = rcutils_strdup("/", rcutils_get_default_allocator());
+    ASSERT_STREQ("/", options.enclave);
+    options.discovery_options.automatic_discovery_range = RMW_AUTOMATIC_DISCOVERY_RANGE_OFF;
+    ret = rmw_init(&options, &context);
+    ASSERT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    node = rmw_create_node(&context, "my_node", "/my_ns");
+    ASSERT_NE(nullptr, node) << rmw_get_error_string().str;
+
+    rmw_qos_profile_t qos_profile = rmw_qos_profile_services_default;
+    service = rmw_create_service(node, ts, service_name, &qos_profile);
+    ASSERT_NE(nullptr, service) << rmw_get_error_string().str;
+    for (size_t i = 0; i < client_count; ++i) {
+      rmw_client_t * client = rmw_create_client(node, ts, service_name, &qos_profile);
+      ASSERT_NE(nullptr, client) << rmw_get_error_string().str;
+      clients.push_back(client);
+    }
+    for (rmw_client_t * client : clients) {
+      bool is_available = false;
+      for (int i = 0; i < 100 && !is_available; ++i) {
+        ASSERT_EQ(RMW_RET_OK, rmw_service_server_is_available(node, client, &is_available));
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+      ASSERT_TRUE(is_available);
+    }
+  }
+
+  void TearDown() override
+  {
+    rmw_ret_t ret = RMW_RET_OK;
+    for (rmw_client_t * client : clients) {
+      ret = rmw_destroy_client(node, client);
+      EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    }
+    if (nullptr != service) {
+      ret = rmw_destroy_service(node, service);
+      EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    }
+    ret = rmw_destroy_node(node);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    ret = rmw_shutdown(&context);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    ret = rmw_context_fini(&context);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+  }
+
+  const rosidl_service_type_support_t * ts{
+    ROSIDL_GET_SRV_TYPE_SUPPORT(test_msgs, srv, BasicTypes)};
+  const char * service_name{"/test_client_response_filter"};
+  rmw_context_t context{rmw_get_zero_initialized_context()};
+  rmw_node_t * node{nullptr};
+  rmw_service_t * service{nullptr};
+  std::vector<rmw_client_t *> clients;
+};
+
+TEST_F(TestClientResponseFilter, response_writer_filters_for_every_client) {
+  auto info = static_cast<CustomServiceInfo *>(service->data);
+  const auto & limits = info->response_writer_->get_qos().writer_resource_limits();
+  EXPECT_LE(client_count, limits.reader_filters_allocation.maximum);
+  EXPECT_EQ(
+    limits.matched_subscriber_allocation.maximum, limits.reader_filters_allocation.maximum);
+}
+
+TEST_F(TestClientResponseFilter, each_client_only_takes_its_response) {
+  for (size_t i = 0; i < client_count; ++i) {
+    test_msgs__srv__BasicTypes_Request request;
+    ASSERT_TRUE(test_msgs__srv__BasicTypes_Request__init(&request));
+    request.int64_value = static_cast<int64_t>(i);
+    int64_t sequence_number = 0;
+    EXPECT_EQ(RMW_RET_OK, rmw_send_request(clients[i], &request, &sequence_number)) <<
+      rmw_get_error_string().str;
+    test_msgs__srv__BasicTypes_Request__fini(&request);
+  }
+
+  // Reply to each request with twice its value
+  test_msgs__srv__BasicTypes_Request request;
+  ASSERT_TRUE(test_msgs__srv__BasicTypes_Request__init(&request));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__srv__BasicTypes_Request__fini(&request);
+  });
+  size_t replied = 0u;
+  for (int i = 0; i < 100 && replied < client_count; ++i) {
+    rmw_service_info_t header;
+    bool taken = false;
+    ASSERT_EQ(RMW_RET_OK, rmw_take_request(service, &header, &request, &taken)) <<
+      rmw_get_error_string().str;
+    if (!taken) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      continue;
+    }
+    test_msgs__srv__BasicTypes_Response response;
+    ASSERT_TRUE(test_msgs__srv__BasicTypes_Response__init(&response));
+    response.int64_value = 2 * request.int64_value;
+    EXPECT_EQ(RMW_RET_OK, rmw_send_response(service, &header.request_id, &response)) <<
+      rmw_get_error_string().str;
+    test_msgs__srv__BasicTypes_Response__fini(&response);
+    ++replied;
+  }
+  ASSERT_EQ(client_count, replied);
+
+  test_msgs__srv__BasicTypes_Response response;
+  ASSERT_TRUE(test_msgs__srv__BasicTypes_Response__init(&response));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__srv__BasicTypes_Response__fini(&response);
+  });
+  for (size_t i = 0; i < client_count; ++i) {
+    rmw_service_info_t header;
+    bool taken = false;
+    for (int j = 0; j < 100 && !taken; ++j) {
+      ASSERT_EQ(RMW_RET_OK, rmw_take_response(clients[i], &header, &response, &taken)) <<
+        rmw_get_error_string().str;
+      if (!taken) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+    }
+    ASSERT_TRUE(taken) << "client " << i;
+    EXPECT_EQ(2 * static_cast<int64_t>(i), response.int64_value);
+  }
+
+  // None of them got the response of another client
+  for (rmw_client_t * client : clients) {
+    rmw_service_info_t header;
+    bool taken = false;
+    EXPECT_EQ(RMW_RET_OK, rmw_take_response(client, &header, &response, &taken));
+    EXPECT_FALSE(taken);
+  }
+}
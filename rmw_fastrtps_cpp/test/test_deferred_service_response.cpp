@@ -0,0 +1,276 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "fastdds/dds/core/status/PublicationMatchedStatus.hpp"
+#include "fastdds/rtps/common/InstanceHandle.h"
+
+#include "osrf_testing_tools_cpp/scope_exit.hpp"
+
+#include "rcutils/allocator.h"
+#include "rcutils/env.h"
+#include "rcutils/strdup.h"
+
+#include "rmw/error_handling.h"
+#include "rmw/rmw.h"
+
+#include "rmw_fastrtps_shared_cpp/custom_client_info.hpp"
+#include "rmw_fastrtps_shared_cpp/custom_service_info.hpp"
+
+#include "test_msgs/srv/basic_types.h"
+
+class TestDeferredServiceResponse : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // Only read when the participant is created
+    ASSERT_TRUE(rcutils_set_env("RMW_FASTRTPS_DEFER_SERVICE_RESPONSES", "1"));
+
+    rmw_init_options_t options = rmw_get_zero_initialized_init_options();
+    rmw_ret_t ret = rmw_init_options_init(&options, rcutils_get_default_allocator());
+    ASSERT_EQ(RMW_RET_OK, ret) << rcutils_get_error_string().str;
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      rmw_ret_t ret = rmw_init_options_fini(&options);
+      EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    });
+    options.enclave = rcutils_strdup("/", rcutils_get_default_allocator());
+    ASSERT_STREQ("/", options.enclave);
+    options.discovery_options.automatic_discovery_range = RMW_AUTOMATIC_DISCOVERY_RANGE_OFF;
+    ret = rmw_init(&options, &context);
+    ASSERT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    node = rmw_create_node(&context, "my_node", "/my_ns");
+    ASSERT_NE(nullptr, node) << rmw_get_error_string().str;
+
+    rmw_qos_profile_t qos_profile = rmw_qos_profile_services_default;
+    service = rmw_create_service(node, ts, service_name, &qos_profile);
+    ASSERT_NE(nullptr, service) << rmw_get_error_string().str;
+    client = rmw_create_client(node, ts, service_name, &qos_profile);
+    ASSERT_NE(nullptr, client) << rmw_get_error_string().str;
+    bool is_available = false;
+    for (int i = 0; i < 100 && !is_available; ++i) {
+      ASSERT_EQ(RMW_RET_OK, rmw_service_server_is_available(node, client, &is_available));
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_TRUE(is_available);
+
+    auto service_info = static_cast<CustomServiceInfo *>(service->data);
+    ASSERT_TRUE(service_info->defer_responses_);
+  }
+
+  void TearDown() override
+  {
+    rmw_ret_t ret = rmw_destroy_client(node, client);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    if (nullptr != service) {
+      ret = rmw_destroy_service(node, service);
+      EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    }
+    ret = rmw_destroy_node(node);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    ret = rmw_shutdown(&context);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    ret = rmw_context_fini(&context);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    EXPECT_TRUE(rcutils_set_env("RMW_FASTRTPS_DEFER_SERVICE_RESPONSES", nullptr));
+  }
+
+  /// Send a request from the client, and take it with the service.
+  void send_and_take_request(rmw_service_info_t * header)
+  {
+    test_msgs__srv__BasicTypes_Request request;
+    ASSERT_TRUE(test_msgs__srv__BasicTypes_Request__init(&request));
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      test_msgs__srv__BasicTypes_Request__fini(&request);
+    });
+    int64_t sequence_number = 0;
+    ASSERT_EQ(RMW_RET_OK, rmw_send_request(client, &request, &sequence_number)) <<
+      rmw_get_error_string().str;
+    bool taken = false;
+    for (int i = 0; i < 100 && !taken; ++i) {
+      ASSERT_EQ(RMW_RET_OK, rmw_take_request(service, header, &request, &taken)) <<
+        rmw_get_error_string().str;
+      if (!taken) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+    }
+    ASSERT_TRUE(taken);
+  }
+
+  void send_response(rmw_service_info_t & header, int64_t value)
+  {
+    test_msgs__srv__BasicTypes_Response response;
+    ASSERT_TRUE(test_msgs__srv__BasicTypes_Response__init(&response));
+    response.int64_value = value;
+    EXPECT_EQ(RMW_RET_OK, rmw_send_response(service, &header.request_id, &response)) <<
+      rmw_get_error_string().str;
+    test_msgs__srv__BasicTypes_Response__fini(&response);
+  }
+
+  /// Have the service see the response reader of the client being matched or unmatched.
+  void match_client_reader(int32_t count_change)
+  {
+    auto service_info = static_cast<CustomServiceInfo *>(service->data);
+    auto client_info = static_cast<CustomClientInfo *>(client->data);
+    eprosima::fastdds::dds::PublicationMatchedStatus status;
+    status.current_count_change = count_change;
+    status.last_subscription_handle =
+      eprosima::fastrtps::rtps::InstanceHandle_t(client_info->reader_guid_);
+    service_info->pub_listener_->on_publication_matched(service_info->response_writer_, status);
+    if (count_change < 0) {
+      // The client is still there, only its reader is not matched yet
+      service_info->pub_listener_->endpoint_add_reader_and_writer(
+        client_info->reader_guid_, client_info->writer_guid_);
+    }
+  }
+
+  client_present_t client_state()
+  {
+    auto service_info = static_cast<CustomServiceInfo *>(service->data);
+    auto client_info = static_cast<CustomClientInfo *>(client->data);
+    return service_info->pub_listener_->check_for_deferred_subscription(
+      client_info->reader_guid_);
+  }
+
+  bool take_response(int64_t * value)
+  {
+    test_msgs__srv__BasicTypes_Response response;
+    EXPECT_TRUE(test_msgs__srv__BasicTypes_Response__init(&response));
+    rmw_service_info_t header;
+    bool taken = false;
+    EXPECT_EQ(RMW_RET_OK, rmw_take_response(client, &header, &response, &taken)) <<
+      rmw_get_error_string().str;
+    *value = response.int64_value;
+    test_msgs__srv__BasicTypes_Response__fini(&response);
+    return taken;
+  }
+
+  const rosidl_service_type_support_t * ts{
+    ROSIDL_GET_SRV_TYPE_SUPPORT(test_msgs, srv, BasicTypes)};
+  const char * service_name{"/test_deferred_service_response"};
+  rmw_context_t context{rmw_get_zero_initialized_context()};
+  rmw_node_t * node{nullptr};
+  rmw_service_t * service{nullptr};
+  rmw_client_t * client{nullptr};
+};
+
+TEST_F(TestDeferredServiceResponse, matched_clients_get_responses_right_away) {
+  rmw_service_info_t header;
+  send_and_take_request(&header);
+  ASSERT_EQ(client_present_t::YES, client_state());
+  send_response(header, 1);
+
+  int64_t value = 0;
+  bool taken = false;
+  for (int i = 0; i < 100 && !taken; ++i) {
+    taken = take_response(&value);
+    if (!taken) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+  ASSERT_TRUE(taken);
+  EXPECT_EQ(1, value);
+}
+
+TEST_F(TestDeferredServiceResponse, responses_wait_for_the_client_reader) {
+  rmw_service_info_t header;
+  send_and_take_request(&header);
+  match_client_reader(-1);
+  ASSERT_EQ(client_present_t::MAYBE, client_state());
+
+  // Sending does not wait for the reader, the responses are queued instead
+  const auto start = std::chrono::steady_clock::now();
+  for (int64_t value = 1; value <= 3; ++value) {
+    send_response(header, value);
+  }
+  EXPECT_GT(std::chrono::milliseconds(100), std::chrono::steady_clock::now() - start);
+  EXPECT_EQ(client_present_t::MAYBE, client_state());
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  int64_t value = 0;
+  EXPECT_FALSE(take_response(&value));
+
+  // They are written in the order they were sent once it is matched
+  match_client_reader(1);
+  for (int64_t expected = 1; expected <= 3; ++expected) {
+    bool taken = false;
+    for (int i = 0; i < 100 && !taken; ++i) {
+      taken = take_response(&value);
+      if (!taken) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+    }
+    ASSERT_TRUE(taken);
+    EXPECT_EQ(expected, value);
+  }
+  for (int i = 0; i < 100 && client_present_t::YES != client_state(); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(client_present_t::YES, client_state());
+}
+
+TEST_F(TestDeferredServiceResponse, responses_to_gone_clients_are_dropped) {
+  rmw_service_info_t header;
+  send_and_take_request(&header);
+  match_client_reader(-1);
+  send_response(header, 1);
+
+  // The client going away drops what was queued for it
+  auto service_info = static_cast<CustomServiceInfo *>(service->data);
+  auto client_info = static_cast<CustomClientInfo *>(client->data);
+  service_info->pub_listener_->endpoint_erase_if_exists(client_info->writer_guid_);
+  EXPECT_EQ(client_present_t::GONE, client_state());
+  send_response(header, 2);
+}
+
+TEST_F(TestDeferredServiceResponse, destroy_service_with_queued_responses) {
+  rmw_service_info_t header;
+  send_and_take_request(&header);
+  match_client_reader(-1);
+  for (int64_t value = 1; value <= 3; ++value) {
+    send_response(header, value);
+  }
+
+  rmw_ret_t ret = rmw_destroy_service(node, service);
+  service = nullptr;
+  EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+}
+
+TEST_F(TestDeferredServiceResponse, destroy_service_while_flushing) {
+  rmw_service_info_t header;
+  send_and_take_request(&header);
+  match_client_reader(-1);
+  for (int64_t value = 1; value <= 100; ++value) {
+    send_response(header, value);
+  }
+
+  // The flushing thread is woken up, and may still be writing them when the service goes away
+  match_client_reader(1);
+  rmw_ret_t ret = rmw_destroy_service(node, service);
+  service = nullptr;
+  EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+
+  // Whatever was written arrived in order
+  int64_t previous = 0;
+  int64_t value = 0;
+  while (take_response(&value)) {
+    EXPECT_LT(previous, value);
+    previous = value;
+  }
+}
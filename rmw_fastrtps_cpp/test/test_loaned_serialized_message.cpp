@@ -0,0 +1,225 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "osrf_testing_tools_cpp/scope_exit.hpp"
+
+#include "rcutils/allocator.h"
+#include "rcutils/strdup.h"
+
+#include "rmw/error_handling.h"
+#include "rmw/rmw.h"
+#include "rmw/serialized_message.h"
+
+#include "rmw_fastrtps_cpp/loaned_serialized_message.hpp"
+
+#include "rosidl_runtime_c/string_functions.h"
+
+#include "test_msgs/msg/basic_types.h"
+#include "test_msgs/msg/strings.h"
+
+using rmw_fastrtps_cpp::return_loaned_serialized_message;
+using rmw_fastrtps_cpp::take_loaned_serialized_message;
+
+class TestLoanedSerializedMessage : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    rmw_init_options_t options = rmw_get_zero_initialized_init_options();
+    rmw_ret_t ret = rmw_init_options_init(&options, rcutils_get_default_allocator());
+    ASSERT_EQ(RMW_RET_OK, ret) << rcutils_get_error_string().str;
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      rmw_ret_t ret = rmw_init_options_fini(&options);
+      EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    });
+    options.enclave = rcutils_strdup("/", rcutils_get_default_allocator());
+    ASSERT_STREQ("/", options.enclave);
+    options.discovery_options.automatic_discovery_range = RMW_AUTOMATIC_DISCOVERY_RANGE_OFF;
+    ret = rmw_init(&options, &context);
+    ASSERT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    node = rmw_create_node(&context, "my_node", "/my_ns");
+    ASSERT_NE(nullptr, node) << rmw_get_error_string().str;
+
+    rmw_qos_profile_t qos_profile = rmw_qos_profile_default;
+    rmw_publisher_options_t pub_options = rmw_get_default_publisher_options();
+    pub = rmw_create_publisher(node, ts, topic_name, &qos_profile, &pub_options);
+    ASSERT_NE(nullptr, pub) << rmw_get_error_string().str;
+    rmw_subscription_options_t sub_options = rmw_get_default_subscription_options();
+    sub = rmw_create_subscription(node, ts, topic_name, &qos_profile, &sub_options);
+    ASSERT_NE(nullptr, sub) << rmw_get_error_string().str;
+
+    size_t count = 0u;
+    for (int i = 0; i < 100 && 0u == count; ++i) {
+      ASSERT_EQ(RMW_RET_OK, rmw_subscription_count_matched_publishers(sub, &count));
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(1u, count);
+  }
+
+  void TearDown() override
+  {
+    rmw_ret_t ret = RMW_RET_OK;
+    if (nullptr != sub) {
+      ret = rmw_destroy_subscription(node, sub);
+      EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    }
+    ret = rmw_destroy_publisher(node, pub);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    ret = rmw_destroy_node(node);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    ret = rmw_shutdown(&context);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    ret = rmw_context_fini(&context);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+  }
+
+  void publish(const char * value)
+  {
+    test_msgs__msg__Strings msg;
+    ASSERT_TRUE(test_msgs__msg__Strings__init(&msg));
+    ASSERT_TRUE(rosidl_runtime_c__String__assign(&msg.string_value, value));
+    EXPECT_EQ(RMW_RET_OK, rmw_publish(pub, &msg, nullptr)) << rmw_get_error_string().str;
+    test_msgs__msg__Strings__fini(&msg);
+  }
+
+  // Wait for a message to be loaned
+  void take_loan(rmw_serialized_message_t * serialized_message)
+  {
+    bool taken = false;
+    for (int i = 0; i < 100 && !taken; ++i) {
+      ASSERT_EQ(
+        RMW_RET_OK,
+        take_loaned_serialized_message(sub, serialized_message, &taken, nullptr)) <<
+        rmw_get_error_string().str;
+      if (!taken) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+    }
+    ASSERT_TRUE(taken);
+  }
+
+  const rosidl_message_type_support_t * ts{
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Strings)};
+  const char * topic_name{"/test_loaned_serialized_message"};
+  rmw_context_t context{rmw_get_zero_initialized_context()};
+  rmw_node_t * node{nullptr};
+  rmw_publisher_t * pub{nullptr};
+  rmw_subscription_t * sub{nullptr};
+};
+
+TEST_F(TestLoanedSerializedMessage, take_and_return) {
+  publish("first");
+  publish("second");
+
+  test_msgs__msg__Strings msg;
+  ASSERT_TRUE(test_msgs__msg__Strings__init(&msg));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__msg__Strings__fini(&msg);
+  });
+
+  // Both can be on loan at once
+  rmw_serialized_message_t first = rmw_get_zero_initialized_serialized_message();
+  take_loan(&first);
+  rmw_serialized_message_t second = rmw_get_zero_initialized_serialized_message();
+  take_loan(&second);
+  ASSERT_NE(first.buffer, second.buffer);
+
+  ASSERT_EQ(RMW_RET_OK, rmw_deserialize(&first, ts, &msg)) << rmw_get_error_string().str;
+  EXPECT_STREQ("first", msg.string_value.data);
+  ASSERT_EQ(RMW_RET_OK, rmw_deserialize(&second, ts, &msg)) << rmw_get_error_string().str;
+  EXPECT_STREQ("second", msg.string_value.data);
+
+  // The view cannot be resized
+  EXPECT_NE(RMW_RET_OK, rmw_serialized_message_resize(&first, first.buffer_capacity + 1u));
+  rmw_reset_error();
+
+  EXPECT_EQ(RMW_RET_OK, return_loaned_serialized_message(sub, &second)) <<
+    rmw_get_error_string().str;
+  EXPECT_EQ(nullptr, second.buffer);
+  EXPECT_EQ(0u, second.buffer_length);
+
+  // Only what is still on loan can be returned
+  rmw_serialized_message_t not_loaned = first;
+  uint8_t byte = 0u;
+  not_loaned.buffer = &byte;
+  EXPECT_EQ(RMW_RET_ERROR, return_loaned_serialized_message(sub, &not_loaned));
+  rmw_reset_error();
+  EXPECT_EQ(RMW_RET_OK, return_loaned_serialized_message(sub, &first)) <<
+    rmw_get_error_string().str;
+
+  bool taken = true;
+  rmw_serialized_message_t none = rmw_get_zero_initialized_serialized_message();
+  EXPECT_EQ(RMW_RET_OK, take_loaned_serialized_message(sub, &none, &taken, nullptr));
+  EXPECT_FALSE(taken);
+  EXPECT_FALSE(rmw_error_is_set());
+}
+
+TEST_F(TestLoanedSerializedMessage, samples_are_reused_once_returned) {
+  // More messages than the DataReader keeps samples for, if the loans were not given back
+  for (int i = 0; i < 100; ++i) {
+    publish("again");
+    rmw_serialized_message_t serialized_message = rmw_get_zero_initialized_serialized_message();
+    take_loan(&serialized_message);
+    EXPECT_EQ(RMW_RET_OK, return_loaned_serialized_message(sub, &serialized_message)) <<
+      rmw_get_error_string().str;
+  }
+}
+
+TEST_F(TestLoanedSerializedMessage, destroy_subscription_with_outstanding_loans) {
+  publish("first");
+  publish("second");
+
+  rmw_serialized_message_t first = rmw_get_zero_initialized_serialized_message();
+  take_loan(&first);
+  rmw_serialized_message_t second = rmw_get_zero_initialized_serialized_message();
+  take_loan(&second);
+  ASSERT_EQ(RMW_RET_OK, return_loaned_serialized_message(sub, &second));
+
+  // The loan still outstanding is given back with the subscription
+  rmw_ret_t ret = rmw_destroy_subscription(node, sub);
+  sub = nullptr;
+  EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+}
+
+TEST_F(TestLoanedSerializedMessage, plain_types_loan_ros_messages) {
+  const rosidl_message_type_support_t * plain_ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, BasicTypes);
+  rmw_qos_profile_t qos_profile = rmw_qos_profile_default;
+  rmw_subscription_options_t sub_options = rmw_get_default_subscription_options();
+  rmw_subscription_t * plain_sub = rmw_create_subscription(
+    node, plain_ts, "/test_loaned_serialized_message_plain", &qos_profile, &sub_options);
+  ASSERT_NE(nullptr, plain_sub) << rmw_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RMW_RET_OK, rmw_destroy_subscription(node, plain_sub));
+  });
+  if (!plain_sub->can_loan_messages) {
+    GTEST_SKIP() << "messages of plain types are not loaned with this type support";
+  }
+
+  rmw_serialized_message_t serialized_message = rmw_get_zero_initialized_serialized_message();
+  bool taken = false;
+  EXPECT_EQ(
+    RMW_RET_UNSUPPORTED,
+    take_loaned_serialized_message(plain_sub, &serialized_message, &taken, nullptr));
+  EXPECT_TRUE(rmw_error_is_set());
+  rmw_reset_error();
+}
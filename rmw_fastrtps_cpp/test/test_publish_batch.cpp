@@ -0,0 +1,178 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "osrf_testing_tools_cpp/scope_exit.hpp"
+
+#include "rcutils/allocator.h"
+#include "rcutils/strdup.h"
+
+#include "rmw/error_handling.h"
+#include "rmw/rmw.h"
+
+#include "rmw_fastrtps_cpp/publish_batch.hpp"
+
+#include "test_msgs/msg/basic_types.h"
+
+namespace
+{
+
+constexpr size_t batch_count = 20u;
+constexpr size_t batch_size = 8u;
+constexpr size_t single_count = 200u;
+
+}  // namespace
+
+class TestPublishBatch : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    rmw_init_options_t options = rmw_get_zero_initialized_init_options();
+    rmw_ret_t ret = rmw_init_options_init(&options, rcutils_get_default_allocator());
+    ASSERT_EQ(RMW_RET_OK, ret) << rcutils_get_error_string().str;
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      rmw_ret_t ret = rmw_init_options_fini(&options);
+      EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    });
+    options.enclave = rcutils_strdup("/", rcutils_get_default_allocator());
+    ASSERT_STREQ("/", options.enclave);
+    options.discovery_options.automatic_discovery_range = RMW_AUTOMATIC_DISCOVERY_RANGE_OFF;
+    ret = rmw_init(&options, &context);
+    ASSERT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    node = rmw_create_node(&context, "my_node", "/my_ns");
+    ASSERT_NE(nullptr, node) << rmw_get_error_string().str;
+
+    // Nothing is dropped, so that every message can be checked
+    rmw_qos_profile_t qos_profile = rmw_qos_profile_default;
+    qos_profile.history = RMW_QOS_POLICY_HISTORY_KEEP_ALL;
+    qos_profile.reliability = RMW_QOS_POLICY_RELIABILITY_RELIABLE;
+    rmw_publisher_options_t pub_options = rmw_get_default_publisher_options();
+    pub = rmw_create_publisher(node, ts, topic_name, &qos_profile, &pub_options);
+    ASSERT_NE(nullptr, pub) << rmw_get_error_string().str;
+    rmw_subscription_options_t sub_options = rmw_get_default_subscription_options();
+    sub = rmw_create_subscription(node, ts, topic_name, &qos_profile, &sub_options);
+    ASSERT_NE(nullptr, sub) << rmw_get_error_string().str;
+
+    size_t count = 0u;
+    for (int i = 0; i < 100 && 0u == count; ++i) {
+      ASSERT_EQ(RMW_RET_OK, rmw_subscription_count_matched_publishers(sub, &count));
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(1u, count);
+  }
+
+  void TearDown() override
+  {
+    rmw_ret_t ret = rmw_destroy_subscription(node, sub);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    ret = rmw_destroy_publisher(node, pub);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    ret = rmw_destroy_node(node);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    ret = rmw_shutdown(&context);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    ret = rmw_context_fini(&context);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+  }
+
+  const rosidl_message_type_support_t * ts{
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, BasicTypes)};
+  const char * topic_name{"/test_publish_batch"};
+  rmw_context_t context{rmw_get_zero_initialized_context()};
+  rmw_node_t * node{nullptr};
+  rmw_publisher_t * pub{nullptr};
+  rmw_subscription_t * sub{nullptr};
+};
+
+TEST_F(TestPublishBatch, batches_arrive_in_order_and_together) {
+  // Single messages are negative, and those of a batch are numbered from its index
+  std::thread single_publisher(
+    [this]() {
+      test_msgs__msg__BasicTypes msg;
+      ASSERT_TRUE(test_msgs__msg__BasicTypes__init(&msg));
+      for (size_t i = 0; i < single_count; ++i) {
+        msg.int64_value = -1 - static_cast<int64_t>(i);
+        EXPECT_EQ(RMW_RET_OK, rmw_publish(pub, &msg, nullptr)) << rmw_get_error_string().str;
+      }
+      test_msgs__msg__BasicTypes__fini(&msg);
+    });
+
+  test_msgs__msg__BasicTypes msgs[batch_size];
+  const void * ros_messages[batch_size];
+  for (size_t j = 0; j < batch_size; ++j) {
+    ASSERT_TRUE(test_msgs__msg__BasicTypes__init(&msgs[j]));
+    ros_messages[j] = &msgs[j];
+  }
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    for (size_t j = 0; j < batch_size; ++j) {
+      test_msgs__msg__BasicTypes__fini(&msgs[j]);
+    }
+  });
+  for (size_t i = 0; i < batch_count; ++i) {
+    for (size_t j = 0; j < batch_size; ++j) {
+      msgs[j].int64_value = static_cast<int64_t>(i * batch_size + j);
+    }
+    EXPECT_EQ(
+      RMW_RET_OK, rmw_fastrtps_cpp::publish_batch(pub, ros_messages, batch_size, nullptr)) <<
+      rmw_get_error_string().str;
+  }
+  single_publisher.join();
+
+  std::vector<int64_t> values;
+  test_msgs__msg__BasicTypes msg;
+  ASSERT_TRUE(test_msgs__msg__BasicTypes__init(&msg));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__msg__BasicTypes__fini(&msg);
+  });
+  const size_t total = batch_count * batch_size + single_count;
+  for (int i = 0; i < 100 && values.size() < total; ) {
+    bool taken = false;
+    ASSERT_EQ(RMW_RET_OK, rmw_take(sub, &msg, &taken, nullptr)) << rmw_get_error_string().str;
+    if (taken) {
+      values.push_back(msg.int64_value);
+    } else {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      ++i;
+    }
+  }
+  ASSERT_EQ(total, values.size());
+
+  int64_t next_batched = 0;
+  int64_t next_single = -1;
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (values[i] < 0) {
+      EXPECT_EQ(next_single--, values[i]);
+      continue;
+    }
+    // The first message of a batch is followed by the rest of it
+    ASSERT_EQ(next_batched, values[i]);
+    ASSERT_EQ(0, values[i] % static_cast<int64_t>(batch_size));
+    ASSERT_LE(i + batch_size, values.size());
+    for (size_t j = 0; j < batch_size; ++j) {
+      EXPECT_EQ(next_batched++, values[i + j]) << "batch " << values[i] / batch_size;
+    }
+    i += batch_size - 1u;
+  }
+  EXPECT_EQ(static_cast<int64_t>(batch_count * batch_size), next_batched);
+  EXPECT_EQ(-1 - static_cast<int64_t>(single_count), next_single);
+}
@@ -0,0 +1,182 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "osrf_testing_tools_cpp/scope_exit.hpp"
+
+#include "rcutils/allocator.h"
+#include "rcutils/strdup.h"
+
+#include "rmw/error_handling.h"
+#include "rmw/event.h"
+#include "rmw/rmw.h"
+#include "rmw/serialized_message.h"
+
+#include "rmw_fastrtps_cpp/publish_batch.hpp"
+#include "rmw_fastrtps_shared_cpp/custom_publisher_info.hpp"
+
+#include "test_msgs/msg/basic_types.h"
+
+class TestPublishUnmatched : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    rmw_init_options_t options = rmw_get_zero_initialized_init_options();
+    rmw_ret_t ret = rmw_init_options_init(&options, rcutils_get_default_allocator());
+    ASSERT_EQ(RMW_RET_OK, ret) << rcutils_get_error_string().str;
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      rmw_ret_t ret = rmw_init_options_fini(&options);
+      EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    });
+    options.enclave = rcutils_strdup("/", rcutils_get_default_allocator());
+    ASSERT_STREQ("/", options.enclave);
+    options.discovery_options.automatic_discovery_range = RMW_AUTOMATIC_DISCOVERY_RANGE_OFF;
+    ret = rmw_init(&options, &context);
+    ASSERT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    node = rmw_create_node(&context, "my_node", "/my_ns");
+    ASSERT_NE(nullptr, node) << rmw_get_error_string().str;
+    ASSERT_TRUE(test_msgs__msg__BasicTypes__init(&msg));
+  }
+
+  void TearDown() override
+  {
+    test_msgs__msg__BasicTypes__fini(&msg);
+    rmw_ret_t ret = RMW_RET_OK;
+    if (nullptr != pub) {
+      ret = rmw_destroy_publisher(node, pub);
+      EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    }
+    ret = rmw_destroy_node(node);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    ret = rmw_shutdown(&context);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    ret = rmw_context_fini(&context);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+  }
+
+  void create_publisher(const rmw_qos_profile_t & qos_profile)
+  {
+    rmw_publisher_options_t pub_options = rmw_get_default_publisher_options();
+    pub = rmw_create_publisher(node, ts, topic_name, &qos_profile, &pub_options);
+    ASSERT_NE(nullptr, pub) << rmw_get_error_string().str;
+  }
+
+  bool skips_writes() const
+  {
+    return static_cast<CustomPublisherInfo *>(pub->data)->skip_write_when_unmatched_;
+  }
+
+  const rosidl_message_type_support_t * ts{
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, BasicTypes)};
+  const char * topic_name{"/test_publish_unmatched"};
+  rmw_context_t context{rmw_get_zero_initialized_context()};
+  rmw_node_t * node{nullptr};
+  rmw_publisher_t * pub{nullptr};
+  test_msgs__msg__BasicTypes msg;
+};
+
+TEST_F(TestPublishUnmatched, volatile_publisher_drops_messages) {
+  create_publisher(rmw_qos_profile_default);
+  EXPECT_TRUE(skips_writes());
+
+  // Every way of publishing succeeds without anything to write to
+  EXPECT_EQ(RMW_RET_OK, rmw_publish(pub, &msg, nullptr)) << rmw_get_error_string().str;
+  const void * ros_messages[] = {&msg, &msg};
+  EXPECT_EQ(RMW_RET_OK, rmw_fastrtps_cpp::publish_batch(pub, ros_messages, 2u, nullptr)) <<
+    rmw_get_error_string().str;
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rmw_serialized_message_t serialized_message = rmw_get_zero_initialized_serialized_message();
+  ASSERT_EQ(RMW_RET_OK, rmw_serialized_message_init(&serialized_message, 0u, &allocator));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RMW_RET_OK, rmw_serialized_message_fini(&serialized_message));
+  });
+  ASSERT_EQ(RMW_RET_OK, rmw_serialize(&msg, ts, &serialized_message));
+  EXPECT_EQ(RMW_RET_OK, rmw_publish_serialized_message(pub, &serialized_message, nullptr)) <<
+    rmw_get_error_string().str;
+
+  // Messages are written again once a subscription is matched
+  rmw_subscription_options_t sub_options = rmw_get_default_subscription_options();
+  rmw_subscription_t * sub =
+    rmw_create_subscription(node, ts, topic_name, &rmw_qos_profile_default, &sub_options);
+  ASSERT_NE(nullptr, sub) << rmw_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RMW_RET_OK, rmw_destroy_subscription(node, sub));
+  });
+  size_t count = 0u;
+  for (int i = 0; i < 100 && 0u == count; ++i) {
+    ASSERT_EQ(RMW_RET_OK, rmw_publisher_count_matched_subscriptions(pub, &count));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_EQ(1u, count);
+
+  msg.int64_value = 42;
+  ASSERT_EQ(RMW_RET_OK, rmw_publish(pub, &msg, nullptr)) << rmw_get_error_string().str;
+  test_msgs__msg__BasicTypes output;
+  ASSERT_TRUE(test_msgs__msg__BasicTypes__init(&output));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__msg__BasicTypes__fini(&output);
+  });
+  bool taken = false;
+  for (int i = 0; i < 100 && !taken; ++i) {
+    ASSERT_EQ(RMW_RET_OK, rmw_take(sub, &output, &taken, nullptr));
+    if (!taken) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+  ASSERT_TRUE(taken);
+  EXPECT_EQ(42, output.int64_value);
+}
+
+TEST_F(TestPublishUnmatched, transient_local_publisher_keeps_writing) {
+  rmw_qos_profile_t qos_profile = rmw_qos_profile_default;
+  qos_profile.durability = RMW_QOS_POLICY_DURABILITY_TRANSIENT_LOCAL;
+  create_publisher(qos_profile);
+  EXPECT_FALSE(skips_writes());
+}
+
+TEST_F(TestPublishUnmatched, deadline_is_met_without_subscriptions) {
+  rmw_qos_profile_t qos_profile = rmw_qos_profile_default;
+  qos_profile.deadline = {0, 100000000};  // 100 ms
+  create_publisher(qos_profile);
+  EXPECT_FALSE(skips_writes());
+
+  rmw_event_t event = rmw_get_zero_initialized_event();
+  ASSERT_EQ(
+    RMW_RET_OK, rmw_publisher_event_init(&event, pub, RMW_EVENT_OFFERED_DEADLINE_MISSED)) <<
+    rmw_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RMW_RET_OK, rmw_event_fini(&event));
+  });
+
+  // Published well within the deadline, for several deadline periods
+  for (int i = 0; i < 30; ++i) {
+    ASSERT_EQ(RMW_RET_OK, rmw_publish(pub, &msg, nullptr)) << rmw_get_error_string().str;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  rmw_offered_deadline_missed_status_t status{};
+  bool taken = false;
+  ASSERT_EQ(RMW_RET_OK, rmw_take_event(&event, &status, &taken)) << rmw_get_error_string().str;
+  EXPECT_EQ(0, status.total_count);
+}
@@ -0,0 +1,327 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "osrf_testing_tools_cpp/scope_exit.hpp"
+
+#include "rcutils/allocator.h"
+#include "rcutils/env.h"
+#include "rcutils/strdup.h"
+
+#include "rmw/error_handling.h"
+#include "rmw/rmw.h"
+#include "rmw/subscription_content_filter_options.h"
+
+#include "test_msgs/msg/basic_types.h"
+
+class TestSharedDataReader : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // Only read when the participant is created
+    ASSERT_TRUE(rcutils_set_env("RMW_FASTRTPS_SHARE_DATA_READERS", "1"));
+
+    rmw_init_options_t options = rmw_get_zero_initialized_init_options();
+    rmw_ret_t ret = rmw_init_options_init(&options, rcutils_get_default_allocator());
+    ASSERT_EQ(RMW_RET_OK, ret) << rcutils_get_error_string().str;
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      rmw_ret_t ret = rmw_init_options_fini(&options);
+      EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    });
+    options.enclave = rcutils_strdup("/", rcutils_get_default_allocator());
+    ASSERT_STREQ("/", options.enclave);
+    options.discovery_options.automatic_discovery_range = RMW_AUTOMATIC_DISCOVERY_RANGE_OFF;
+    ret = rmw_init(&options, &context);
+    ASSERT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    node = rmw_create_node(&context, "my_node", "/my_ns");
+    ASSERT_NE(nullptr, node) << rmw_get_error_string().str;
+  }
+
+  void TearDown() override
+  {
+    rmw_ret_t ret = RMW_RET_OK;
+    for (rmw_subscription_t * sub : subs) {
+      ret = rmw_destroy_subscription(node, sub);
+      EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    }
+    if (nullptr != pub) {
+      ret = rmw_destroy_publisher(node, pub);
+      EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    }
+    ret = rmw_destroy_node(node);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    ret = rmw_shutdown(&context);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    ret = rmw_context_fini(&context);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    EXPECT_TRUE(rcutils_set_env("RMW_FASTRTPS_SHARE_DATA_READERS", nullptr));
+  }
+
+  void create_publisher()
+  {
+    rmw_publisher_options_t options = rmw_get_default_publisher_options();
+    pub = rmw_create_publisher(node, ts, topic_name, &qos_profile, &options);
+    ASSERT_NE(nullptr, pub) << rmw_get_error_string().str;
+  }
+
+  rmw_subscription_t * create_subscription(
+    const rmw_subscription_options_t & options = rmw_get_default_subscription_options())
+  {
+    rmw_subscription_t * sub =
+      rmw_create_subscription(node, ts, topic_name, &qos_profile, &options);
+    EXPECT_NE(nullptr, sub) << rmw_get_error_string().str;
+    if (nullptr != sub) {
+      subs.push_back(sub);
+    }
+    return sub;
+  }
+
+  void destroy_subscription(rmw_subscription_t * sub)
+  {
+    for (auto it = subs.begin(); it != subs.end(); ++it) {
+      if (*it == sub) {
+        subs.erase(it);
+        break;
+      }
+    }
+    EXPECT_EQ(RMW_RET_OK, rmw_destroy_subscription(node, sub)) << rmw_get_error_string().str;
+  }
+
+  /// Number of DataReaders matched with the publisher, once it stops changing.
+  size_t count_matched_readers(size_t expected)
+  {
+    size_t count = 0u;
+    for (int i = 0; i < 100 && count != expected; ++i) {
+      EXPECT_EQ(RMW_RET_OK, rmw_publisher_count_matched_subscriptions(pub, &count));
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    // Give other readers the time to show up
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(RMW_RET_OK, rmw_publisher_count_matched_subscriptions(pub, &count));
+    return count;
+  }
+
+  void publish(int64_t value)
+  {
+    test_msgs__msg__BasicTypes msg;
+    ASSERT_TRUE(test_msgs__msg__BasicTypes__init(&msg));
+    msg.int64_value = value;
+    EXPECT_EQ(RMW_RET_OK, rmw_publish(pub, &msg, nullptr)) << rmw_get_error_string().str;
+    test_msgs__msg__BasicTypes__fini(&msg);
+  }
+
+  /// Take the next message of `sub`, waiting for up to a second, or return -1.
+  int64_t take(const rmw_subscription_t * sub)
+  {
+    test_msgs__msg__BasicTypes msg;
+    EXPECT_TRUE(test_msgs__msg__BasicTypes__init(&msg));
+    int64_t value = -1;
+    bool taken = false;
+    for (int i = 0; i < 100 && !taken; ++i) {
+      EXPECT_EQ(RMW_RET_OK, rmw_take(sub, &msg, &taken, nullptr)) << rmw_get_error_string().str;
+      if (taken) {
+        value = msg.int64_value;
+      } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+    }
+    test_msgs__msg__BasicTypes__fini(&msg);
+    return value;
+  }
+
+  /// Whether `sub` has no message to take.
+  bool nothing_to_take(const rmw_subscription_t * sub)
+  {
+    test_msgs__msg__BasicTypes msg;
+    EXPECT_TRUE(test_msgs__msg__BasicTypes__init(&msg));
+    bool taken = false;
+    EXPECT_EQ(RMW_RET_OK, rmw_take(sub, &msg, &taken, nullptr)) << rmw_get_error_string().str;
+    test_msgs__msg__BasicTypes__fini(&msg);
+    return !taken;
+  }
+
+  const rosidl_message_type_support_t * ts{
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, BasicTypes)};
+  const char * topic_name{"/test_shared_data_reader"};
+  rmw_qos_profile_t qos_profile{rmw_qos_profile_default};
+  rmw_context_t context{rmw_get_zero_initialized_context()};
+  rmw_node_t * node{nullptr};
+  rmw_publisher_t * pub{nullptr};
+  std::vector<rmw_subscription_t *> subs;
+};
+
+TEST_F(TestSharedDataReader, one_to_several_sharers_and_back) {
+  create_publisher();
+  rmw_subscription_t * sub_a = create_subscription();
+  ASSERT_NE(nullptr, sub_a);
+  ASSERT_EQ(1u, count_matched_readers(1u));
+
+  // A single sharer takes from the DataReader itself
+  publish(1);
+  EXPECT_EQ(1, take(sub_a));
+
+  // Samples received before the second sharer attached are only for the first one
+  publish(2);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  rmw_subscription_t * sub_b = create_subscription();
+  ASSERT_NE(nullptr, sub_b);
+  EXPECT_EQ(1u, count_matched_readers(1u));
+  EXPECT_EQ(2, take(sub_a));
+  EXPECT_TRUE(nothing_to_take(sub_b));
+
+  // Each sharer gets every sample from then on
+  publish(3);
+  publish(4);
+  EXPECT_EQ(3, take(sub_a));
+  EXPECT_EQ(3, take(sub_b));
+  EXPECT_EQ(4, take(sub_b));
+
+  // Once the other one is gone, the samples still queued are taken first
+  destroy_subscription(sub_b);
+  publish(5);
+  EXPECT_EQ(4, take(sub_a));
+  EXPECT_EQ(5, take(sub_a));
+  EXPECT_TRUE(nothing_to_take(sub_a));
+}
+
+TEST_F(TestSharedDataReader, keep_all_sharers_get_every_sample) {
+  qos_profile.history = RMW_QOS_POLICY_HISTORY_KEEP_ALL;
+  qos_profile.reliability = RMW_QOS_POLICY_RELIABILITY_RELIABLE;
+  create_publisher();
+  rmw_subscription_t * sub_a = create_subscription();
+  rmw_subscription_t * sub_b = create_subscription();
+  ASSERT_NE(nullptr, sub_a);
+  ASSERT_NE(nullptr, sub_b);
+  ASSERT_EQ(1u, count_matched_readers(1u));
+
+  // The slow sharer does not make the other one lose samples, nor loses any itself
+  constexpr int64_t count = 200;
+  for (int64_t value = 1; value <= count; ++value) {
+    publish(value);
+    if (0 == value % 10) {
+      for (int64_t i = value - 9; i <= value; ++i) {
+        EXPECT_EQ(i, take(sub_a));
+      }
+    }
+  }
+  for (int64_t value = 1; value <= count; ++value) {
+    ASSERT_EQ(value, take(sub_b));
+  }
+  EXPECT_TRUE(nothing_to_take(sub_a));
+  EXPECT_TRUE(nothing_to_take(sub_b));
+}
+
+TEST_F(TestSharedDataReader, detach_while_taking) {
+  qos_profile.history = RMW_QOS_POLICY_HISTORY_KEEP_ALL;
+  qos_profile.reliability = RMW_QOS_POLICY_RELIABILITY_RELIABLE;
+  create_publisher();
+  rmw_subscription_t * sub_a = create_subscription();
+  ASSERT_NE(nullptr, sub_a);
+  ASSERT_EQ(1u, count_matched_readers(1u));
+
+  // Other sharers come and go while sub_a keeps taking
+  constexpr int64_t count = 100;
+  std::atomic<bool> failed{false};
+  std::thread taker([this, sub_a, &failed]() {
+      for (int64_t value = 1; value <= count; ++value) {
+        if (value != take(sub_a)) {
+          failed = true;
+          return;
+        }
+      }
+    });
+  for (int64_t value = 1; value <= count; ++value) {
+    rmw_subscription_t * sub_b = nullptr;
+    if (0 == value % 2) {
+      sub_b = create_subscription();
+    }
+    publish(value);
+    if (nullptr != sub_b) {
+      destroy_subscription(sub_b);
+    }
+  }
+  taker.join();
+  EXPECT_FALSE(failed);
+  EXPECT_TRUE(nothing_to_take(sub_a));
+}
+
+TEST_F(TestSharedDataReader, ignore_local_publications) {
+  create_publisher();
+  rmw_subscription_t * sub = create_subscription();
+  rmw_subscription_options_t options = rmw_get_default_subscription_options();
+  options.ignore_local_publications = true;
+  rmw_subscription_t * ignoring_sub = create_subscription(options);
+  ASSERT_NE(nullptr, sub);
+  ASSERT_NE(nullptr, ignoring_sub);
+  // They still share the DataReader
+  ASSERT_EQ(1u, count_matched_readers(1u));
+
+  publish(1);
+  EXPECT_EQ(1, take(sub));
+  EXPECT_TRUE(nothing_to_take(ignoring_sub));
+}
+
+TEST_F(TestSharedDataReader, content_filter_gets_its_own_reader) {
+  create_publisher();
+  rmw_subscription_t * sub = create_subscription();
+  ASSERT_NE(nullptr, sub);
+
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rmw_subscription_content_filter_options_t filter_options =
+    rmw_get_zero_initialized_content_filter_options();
+  ASSERT_EQ(
+    RMW_RET_OK, rmw_subscription_content_filter_options_init(
+      "int64_value > 1", 0u, nullptr, &allocator, &filter_options));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(
+      RMW_RET_OK, rmw_subscription_content_filter_options_fini(&filter_options, &allocator));
+  });
+  rmw_subscription_options_t options = rmw_get_default_subscription_options();
+  options.content_filter_options = &filter_options;
+  rmw_subscription_t * filtered_sub = create_subscription(options);
+  ASSERT_NE(nullptr, filtered_sub);
+  ASSERT_EQ(2u, count_matched_readers(2u));
+
+  publish(1);
+  publish(2);
+  EXPECT_EQ(1, take(sub));
+  EXPECT_EQ(2, take(sub));
+  EXPECT_EQ(2, take(filtered_sub));
+  EXPECT_TRUE(nothing_to_take(filtered_sub));
+}
+
+TEST_F(TestSharedDataReader, unique_network_flow_gets_its_own_reader) {
+  create_publisher();
+  rmw_subscription_t * sub = create_subscription();
+  rmw_subscription_options_t options = rmw_get_default_subscription_options();
+  options.require_unique_network_flow_endpoints =
+    RMW_UNIQUE_NETWORK_FLOW_ENDPOINTS_OPTIONALLY_REQUIRED;
+  rmw_subscription_t * unique_sub = create_subscription(options);
+  ASSERT_NE(nullptr, sub);
+  ASSERT_NE(nullptr, unique_sub);
+  ASSERT_EQ(2u, count_matched_readers(2u));
+
+  publish(1);
+  EXPECT_EQ(1, take(sub));
+  EXPECT_EQ(1, take(unique_sub));
+}
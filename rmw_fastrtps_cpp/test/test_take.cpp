@@ -0,0 +1,282 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "osrf_testing_tools_cpp/memory_tools/memory_tools.hpp"
+#include "osrf_testing_tools_cpp/scope_exit.hpp"
+
+#include "rcutils/allocator.h"
+#include "rcutils/strdup.h"
+
+#include "rmw/error_handling.h"
+#include "rmw/rmw.h"
+
+#include "test_msgs/msg/basic_types.h"
+
+class TestTake : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    rmw_init_options_t options = rmw_get_zero_initialized_init_options();
+    rmw_ret_t ret = rmw_init_options_init(&options, rcutils_get_default_allocator());
+    ASSERT_EQ(RMW_RET_OK, ret) << rcutils_get_error_string().str;
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      rmw_ret_t ret = rmw_init_options_fini(&options);
+      EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    });
+    options.enclave = rcutils_strdup("/", rcutils_get_default_allocator());
+    ASSERT_STREQ("/", options.enclave);
+    options.discovery_options.automatic_discovery_range = RMW_AUTOMATIC_DISCOVERY_RANGE_OFF;
+    ret = rmw_init(&options, &context);
+    ASSERT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    node = rmw_create_node(&context, "my_node", "/my_ns");
+    ASSERT_NE(nullptr, node) << rmw_get_error_string().str;
+
+    rmw_qos_profile_t qos_profile = rmw_qos_profile_default;
+    rmw_publisher_options_t pub_options = rmw_get_default_publisher_options();
+    pub = rmw_create_publisher(node, ts, topic_name, &qos_profile, &pub_options);
+    ASSERT_NE(nullptr, pub) << rmw_get_error_string().str;
+    rmw_subscription_options_t sub_options = rmw_get_default_subscription_options();
+    sub = rmw_create_subscription(node, ts, topic_name, &qos_profile, &sub_options);
+    ASSERT_NE(nullptr, sub) << rmw_get_error_string().str;
+
+    size_t count = 0u;
+    for (int i = 0; i < 100 && 0u == count; ++i) {
+      ASSERT_EQ(RMW_RET_OK, rmw_subscription_count_matched_publishers(sub, &count));
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(1u, count);
+  }
+
+  void TearDown() override
+  {
+    rmw_ret_t ret = rmw_destroy_subscription(node, sub);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    ret = rmw_destroy_publisher(node, pub);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    ret = rmw_destroy_node(node);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    ret = rmw_shutdown(&context);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    ret = rmw_context_fini(&context);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+  }
+
+  void publish(int64_t value)
+  {
+    test_msgs__msg__BasicTypes msg;
+    ASSERT_TRUE(test_msgs__msg__BasicTypes__init(&msg));
+    msg.int64_value = value;
+    EXPECT_EQ(RMW_RET_OK, rmw_publish(pub, &msg, nullptr)) << rmw_get_error_string().str;
+    test_msgs__msg__BasicTypes__fini(&msg);
+  }
+
+  const rosidl_message_type_support_t * ts{
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, BasicTypes)};
+  const char * topic_name{"/test_take"};
+  rmw_context_t context{rmw_get_zero_initialized_context()};
+  rmw_node_t * node{nullptr};
+  rmw_publisher_t * pub{nullptr};
+  rmw_subscription_t * sub{nullptr};
+};
+
+TEST_F(TestTake, sequence_and_single_takes_share_an_allocation) {
+  rmw_subscription_allocation_t allocation;
+  ASSERT_EQ(
+    RMW_RET_OK, rmw_init_subscription_allocation(ts, nullptr, &allocation)) <<
+    rmw_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RMW_RET_OK, rmw_fini_subscription_allocation(&allocation));
+  });
+
+  constexpr size_t count = 3u;
+  test_msgs__msg__BasicTypes msgs[count];
+  rmw_message_sequence_t message_sequence = rmw_get_zero_initialized_message_sequence();
+  rmw_message_info_sequence_t info_sequence = rmw_get_zero_initialized_message_info_sequence();
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  ASSERT_EQ(RMW_RET_OK, rmw_message_sequence_init(&message_sequence, count, &allocator));
+  ASSERT_EQ(RMW_RET_OK, rmw_message_info_sequence_init(&info_sequence, count, &allocator));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    for (size_t i = 0; i < count; ++i) {
+      test_msgs__msg__BasicTypes__fini(&msgs[i]);
+    }
+    EXPECT_EQ(RMW_RET_OK, rmw_message_sequence_fini(&message_sequence));
+    EXPECT_EQ(RMW_RET_OK, rmw_message_info_sequence_fini(&info_sequence));
+  });
+  for (size_t i = 0; i < count; ++i) {
+    ASSERT_TRUE(test_msgs__msg__BasicTypes__init(&msgs[i]));
+    message_sequence.data[i] = &msgs[i];
+  }
+
+  for (int64_t value = 1; value <= 4; ++value) {
+    publish(value);
+  }
+
+  // Take the first three messages, which grows the allocation scratch beyond a single sample
+  size_t taken = 0u;
+  for (int i = 0; i < 100 && taken < count; ++i) {
+    size_t taken_now = 0u;
+    message_sequence.size = 0u;
+    info_sequence.size = 0u;
+    for (size_t j = 0; j < count - taken; ++j) {
+      message_sequence.data[j] = &msgs[taken + j];
+    }
+    ASSERT_EQ(
+      RMW_RET_OK, rmw_take_sequence(
+        sub, count - taken, &message_sequence, &info_sequence, &taken_now, &allocation)) <<
+      rmw_get_error_string().str;
+    taken += taken_now;
+    if (taken < count) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+  ASSERT_EQ(count, taken);
+  for (size_t i = 0; i < count; ++i) {
+    EXPECT_EQ(static_cast<int64_t>(i + 1), msgs[i].int64_value);
+  }
+
+  // A single take with the same allocation still gets the last message
+  test_msgs__msg__BasicTypes msg;
+  ASSERT_TRUE(test_msgs__msg__BasicTypes__init(&msg));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__msg__BasicTypes__fini(&msg);
+  });
+  bool single_taken = false;
+  for (int i = 0; i < 100 && !single_taken; ++i) {
+    ASSERT_EQ(
+      RMW_RET_OK, rmw_take(sub, &msg, &single_taken, &allocation)) << rmw_get_error_string().str;
+    if (!single_taken) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+  ASSERT_TRUE(single_taken);
+  EXPECT_EQ(4, msg.int64_value);
+}
+
+TEST_F(TestTake, steady_state_takes_do_not_allocate) {
+  osrf_testing_tools_cpp::memory_tools::initialize();
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    osrf_testing_tools_cpp::memory_tools::uninitialize();
+  });
+  if (!osrf_testing_tools_cpp::memory_tools::is_working()) {
+    GTEST_SKIP() << "memory tools are not preloaded";
+  }
+
+  rmw_subscription_allocation_t allocation;
+  ASSERT_EQ(
+    RMW_RET_OK, rmw_init_subscription_allocation(ts, nullptr, &allocation)) <<
+    rmw_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RMW_RET_OK, rmw_fini_subscription_allocation(&allocation));
+  });
+
+  constexpr size_t count = 2u;
+  test_msgs__msg__BasicTypes msgs[count];
+  rmw_message_sequence_t message_sequence = rmw_get_zero_initialized_message_sequence();
+  rmw_message_info_sequence_t info_sequence = rmw_get_zero_initialized_message_info_sequence();
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  ASSERT_EQ(RMW_RET_OK, rmw_message_sequence_init(&message_sequence, count, &allocator));
+  ASSERT_EQ(RMW_RET_OK, rmw_message_info_sequence_init(&info_sequence, count, &allocator));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    for (size_t i = 0; i < count; ++i) {
+      test_msgs__msg__BasicTypes__fini(&msgs[i]);
+    }
+    EXPECT_EQ(RMW_RET_OK, rmw_message_sequence_fini(&message_sequence));
+    EXPECT_EQ(RMW_RET_OK, rmw_message_info_sequence_fini(&info_sequence));
+  });
+  for (size_t i = 0; i < count; ++i) {
+    ASSERT_TRUE(test_msgs__msg__BasicTypes__init(&msgs[i]));
+  }
+
+  rmw_message_info_t message_info = rmw_get_zero_initialized_message_info();
+  // Take a single message when asked to, then `count` messages.
+  // Messages are published beforehand, and the takes retry until they arrive.
+  auto take_all = [&](rmw_subscription_allocation_t * take_allocation, bool single) {
+      bool taken = !single;
+      for (int i = 0; i < 100 && !taken; ++i) {
+        if (RMW_RET_OK != rmw_take_with_info(
+            sub, &msgs[0], &taken, &message_info, take_allocation))
+        {
+          return false;
+        }
+        if (!taken) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+      }
+      size_t total = 0u;
+      for (int i = 0; i < 100 && total < count; ++i) {
+        message_sequence.size = 0u;
+        info_sequence.size = 0u;
+        for (size_t j = 0; j < count; ++j) {
+          message_sequence.data[j] = &msgs[j];
+        }
+        size_t taken_now = 0u;
+        if (RMW_RET_OK != rmw_take_sequence(
+            sub, count - total, &message_sequence, &info_sequence, &taken_now,
+            take_allocation))
+        {
+          return false;
+        }
+        total += taken_now;
+        if (total < count) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+      }
+      return taken && count == total;
+    };
+
+  // The first takes grow the scratch of the allocation and of the subscription.
+  // Single takes without an allocation are left out, as they allocate their SampleInfoSeq.
+  for (int64_t value = 1; value <= 5; ++value) {
+    publish(value);
+  }
+  ASSERT_TRUE(take_all(&allocation, true)) << rmw_get_error_string().str;
+  ASSERT_TRUE(take_all(nullptr, false)) << rmw_get_error_string().str;
+
+  for (int64_t value = 6; value <= 10; ++value) {
+    publish(value);
+  }
+  auto on_unexpected_operation =
+    [](osrf_testing_tools_cpp::memory_tools::MemoryToolsService & service) {
+      ADD_FAILURE() << "unexpected memory operation while taking";
+      service.print_backtrace();
+    };
+  osrf_testing_tools_cpp::memory_tools::on_unexpected_malloc(on_unexpected_operation);
+  osrf_testing_tools_cpp::memory_tools::on_unexpected_realloc(on_unexpected_operation);
+  osrf_testing_tools_cpp::memory_tools::on_unexpected_calloc(on_unexpected_operation);
+  osrf_testing_tools_cpp::memory_tools::on_unexpected_free(on_unexpected_operation);
+  osrf_testing_tools_cpp::memory_tools::enable_monitoring();
+  bool with_allocation = false;
+  bool without_allocation = false;
+  EXPECT_NO_MEMORY_OPERATIONS(
+  {
+    with_allocation = take_all(&allocation, true);
+    without_allocation = take_all(nullptr, false);
+  });
+  osrf_testing_tools_cpp::memory_tools::disable_monitoring();
+  EXPECT_TRUE(with_allocation);
+  EXPECT_TRUE(without_allocation);
+}
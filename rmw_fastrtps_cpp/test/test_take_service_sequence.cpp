@@ -0,0 +1,271 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "osrf_testing_tools_cpp/scope_exit.hpp"
+
+#include "rcutils/allocator.h"
+#include "rcutils/strdup.h"
+
+#include "rmw/error_handling.h"
+#include "rmw/rmw.h"
+
+#include "rmw_fastrtps_cpp/take_service_sequence.hpp"
+
+#include "test_msgs/srv/basic_types.h"
+
+namespace
+{
+
+constexpr size_t max_count = 8u;
+
+}  // namespace
+
+class TestTakeServiceSequence : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    rmw_init_options_t options = rmw_get_zero_initialized_init_options();
+    rmw_ret_t ret = rmw_init_options_init(&options, rcutils_get_default_allocator());
+    ASSERT_EQ(RMW_RET_OK, ret) << rcutils_get_error_string().str;
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      rmw_ret_t ret = rmw_init_options_fini(&options);
+      EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    });
+    options.enclave = rcutils_strdup("/", rcutils_get_default_allocator());
+    ASSERT_STREQ("/", options.enclave);
+    options.discovery_options.automatic_discovery_range = RMW_AUTOMATIC_DISCOVERY_RANGE_OFF;
+    ret = rmw_init(&options, &context);
+    ASSERT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    node = rmw_create_node(&context, "my_node", "/my_ns");
+    ASSERT_NE(nullptr, node) << rmw_get_error_string().str;
+
+    rmw_qos_profile_t qos_profile = rmw_qos_profile_services_default;
+    service = rmw_create_service(node, ts, service_name, &qos_profile);
+    ASSERT_NE(nullptr, service) << rmw_get_error_string().str;
+    client_a = rmw_create_client(node, ts, service_name, &qos_profile);
+    ASSERT_NE(nullptr, client_a) << rmw_get_error_string().str;
+    client_b = rmw_create_client(node, ts, service_name, &qos_profile);
+    ASSERT_NE(nullptr, client_b) << rmw_get_error_string().str;
+
+    for (rmw_client_t * client : {client_a, client_b}) {
+      bool is_available = false;
+      for (int i = 0; i < 100 && !is_available; ++i) {
+        ASSERT_EQ(RMW_RET_OK, rmw_service_server_is_available(node, client, &is_available));
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+      ASSERT_TRUE(is_available);
+    }
+
+    for (size_t i = 0; i < max_count; ++i) {
+      ASSERT_TRUE(test_msgs__srv__BasicTypes_Request__init(&requests[i]));
+      ASSERT_TRUE(test_msgs__srv__BasicTypes_Response__init(&responses[i]));
+    }
+  }
+
+  void TearDown() override
+  {
+    for (size_t i = 0; i < max_count; ++i) {
+      test_msgs__srv__BasicTypes_Request__fini(&requests[i]);
+      test_msgs__srv__BasicTypes_Response__fini(&responses[i]);
+    }
+    rmw_ret_t ret = RMW_RET_OK;
+    if (nullptr != client_b) {
+      ret = rmw_destroy_client(node, client_b);
+      EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    }
+    ret = rmw_destroy_client(node, client_a);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    ret = rmw_destroy_service(node, service);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    ret = rmw_destroy_node(node);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    ret = rmw_shutdown(&context);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+    ret = rmw_context_fini(&context);
+    EXPECT_EQ(RMW_RET_OK, ret) << rmw_get_error_string().str;
+  }
+
+  int64_t send_request(const rmw_client_t * client, int64_t value)
+  {
+    test_msgs__srv__BasicTypes_Request request;
+    EXPECT_TRUE(test_msgs__srv__BasicTypes_Request__init(&request));
+    request.int64_value = value;
+    int64_t sequence_number = 0;
+    EXPECT_EQ(RMW_RET_OK, rmw_send_request(client, &request, &sequence_number)) <<
+      rmw_get_error_string().str;
+    test_msgs__srv__BasicTypes_Request__fini(&request);
+    return sequence_number;
+  }
+
+  /// Take requests into `ros_requests` until `expected` of them were taken, or time runs out.
+  size_t take_requests(size_t expected, void ** ros_requests, rmw_service_info_t * headers)
+  {
+    size_t taken = 0u;
+    for (int i = 0; i < 100 && taken < expected; ++i) {
+      size_t taken_now = 0u;
+      EXPECT_EQ(
+        RMW_RET_OK, rmw_fastrtps_cpp::take_request_sequence(
+          service, max_count - taken, &ros_requests[taken], &headers[taken], &taken_now)) <<
+        rmw_get_error_string().str;
+      taken += taken_now;
+      if (taken < expected) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+    }
+    return taken;
+  }
+
+  /// Take responses into `ros_responses` until `expected` of them were taken, or time runs out.
+  size_t take_responses(
+    const rmw_client_t * client, size_t expected, void ** ros_responses,
+    rmw_service_info_t * headers)
+  {
+    size_t taken = 0u;
+    for (int i = 0; i < 100 && taken < expected; ++i) {
+      size_t taken_now = 0u;
+      EXPECT_EQ(
+        RMW_RET_OK, rmw_fastrtps_cpp::take_response_sequence(
+          client, max_count - taken, &ros_responses[taken], &headers[taken], &taken_now)) <<
+        rmw_get_error_string().str;
+      taken += taken_now;
+      if (taken < expected) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+    }
+    return taken;
+  }
+
+  bool is_from(const rmw_client_t * client, const rmw_service_info_t & header)
+  {
+    rmw_gid_t gid;
+    EXPECT_EQ(RMW_RET_OK, rmw_get_gid_for_client(client, &gid));
+    return 0 == std::memcmp(
+      gid.data, header.request_id.writer_guid, sizeof(header.request_id.writer_guid));
+  }
+
+  const rosidl_service_type_support_t * ts{
+    ROSIDL_GET_SRV_TYPE_SUPPORT(test_msgs, srv, BasicTypes)};
+  const char * service_name{"/test_take_service_sequence"};
+  rmw_context_t context{rmw_get_zero_initialized_context()};
+  rmw_node_t * node{nullptr};
+  rmw_service_t * service{nullptr};
+  rmw_client_t * client_a{nullptr};
+  rmw_client_t * client_b{nullptr};
+  test_msgs__srv__BasicTypes_Request requests[max_count];
+  test_msgs__srv__BasicTypes_Response responses[max_count];
+};
+
+TEST_F(TestTakeServiceSequence, take_requests_and_responses) {
+  const int64_t sequence_b = send_request(client_b, 10);
+  int64_t sequence_a[3];
+  for (int64_t i = 0; i < 3; ++i) {
+    sequence_a[i] = send_request(client_a, i + 1);
+  }
+
+  void * ros_requests[max_count];
+  for (size_t i = 0; i < max_count; ++i) {
+    ros_requests[i] = &requests[i];
+  }
+  rmw_service_info_t request_headers[max_count];
+  ASSERT_EQ(4u, take_requests(4u, ros_requests, request_headers));
+
+  // Nothing else is left
+  size_t taken = 0u;
+  ASSERT_EQ(
+    RMW_RET_OK, rmw_fastrtps_cpp::take_request_sequence(
+      service, max_count, ros_requests, request_headers, &taken));
+  EXPECT_EQ(0u, taken);
+
+  // Reply to each request with twice its value
+  for (size_t i = 0; i < 4u; ++i) {
+    auto request = static_cast<test_msgs__srv__BasicTypes_Request *>(ros_requests[i]);
+    if (is_from(client_b, request_headers[i])) {
+      EXPECT_EQ(10, request->int64_value);
+      EXPECT_EQ(sequence_b, request_headers[i].request_id.sequence_number);
+    } else {
+      ASSERT_TRUE(is_from(client_a, request_headers[i]));
+      ASSERT_LE(1, request->int64_value);
+      ASSERT_GE(3, request->int64_value);
+      EXPECT_EQ(
+        sequence_a[request->int64_value - 1], request_headers[i].request_id.sequence_number);
+    }
+    test_msgs__srv__BasicTypes_Response response;
+    ASSERT_TRUE(test_msgs__srv__BasicTypes_Response__init(&response));
+    response.int64_value = 2 * request->int64_value;
+    EXPECT_EQ(
+      RMW_RET_OK, rmw_send_response(service, &request_headers[i].request_id, &response)) <<
+      rmw_get_error_string().str;
+    test_msgs__srv__BasicTypes_Response__fini(&response);
+  }
+
+  // Each client only takes the responses to its own requests
+  void * ros_responses[max_count];
+  for (size_t i = 0; i < max_count; ++i) {
+    ros_responses[i] = &responses[i];
+  }
+  rmw_service_info_t response_headers[max_count];
+  ASSERT_EQ(3u, take_responses(client_a, 3u, ros_responses, response_headers));
+  for (size_t i = 0; i < 3u; ++i) {
+    auto response = static_cast<test_msgs__srv__BasicTypes_Response *>(ros_responses[i]);
+    ASSERT_LE(2, response->int64_value);
+    ASSERT_GE(6, response->int64_value);
+    EXPECT_EQ(
+      sequence_a[response->int64_value / 2 - 1], response_headers[i].request_id.sequence_number);
+  }
+  ASSERT_EQ(1u, take_responses(client_b, 1u, ros_responses, response_headers));
+  EXPECT_EQ(20, static_cast<test_msgs__srv__BasicTypes_Response *>(ros_responses[0])->int64_value);
+  EXPECT_EQ(sequence_b, response_headers[0].request_id.sequence_number);
+}
+
+TEST_F(TestTakeServiceSequence, take_skips_samples_without_data) {
+  // Removing a client leaves the request reader without that writer, which may be reported
+  // with samples that carry no request. Those must not be taken as requests.
+  send_request(client_b, 10);
+  void * ros_requests[max_count];
+  for (size_t i = 0; i < max_count; ++i) {
+    ros_requests[i] = &requests[i];
+  }
+  rmw_service_info_t request_headers[max_count];
+  ASSERT_EQ(1u, take_requests(1u, ros_requests, request_headers));
+  ASSERT_EQ(RMW_RET_OK, rmw_destroy_client(node, client_b)) << rmw_get_error_string().str;
+  client_b = nullptr;
+
+  for (int64_t i = 0; i < 3; ++i) {
+    send_request(client_a, i + 1);
+  }
+  // Give both the requests and the removal of the client time to arrive
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  ASSERT_EQ(3u, take_requests(3u, ros_requests, request_headers));
+  int64_t sum = 0;
+  for (size_t i = 0; i < 3u; ++i) {
+    EXPECT_TRUE(is_from(client_a, request_headers[i]));
+    sum += static_cast<test_msgs__srv__BasicTypes_Request *>(ros_requests[i])->int64_value;
+  }
+  EXPECT_EQ(6, sum);
+
+  size_t taken = 0u;
+  ASSERT_EQ(
+    RMW_RET_OK, rmw_fastrtps_cpp::take_request_sequence(
+      service, max_count, ros_requests, request_headers, &taken));
+  EXPECT_EQ(0u, taken);
+}
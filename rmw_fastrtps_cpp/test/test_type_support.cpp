@@ -0,0 +1,248 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "fastcdr/Cdr.h"
+#include "fastcdr/FastBuffer.h"
+
+#include "rcutils/allocator.h"
+
+#include "rmw/error_handling.h"
+#include "rmw/rmw.h"
+#include "rmw/serialized_message.h"
+
+#include "rmw_fastrtps_cpp/MessageTypeSupport.hpp"
+#include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
+
+#include "rosidl_typesupport_cpp/message_type_support.hpp"
+#include "rosidl_typesupport_fastrtps_c/identifier.h"
+#include "rosidl_typesupport_fastrtps_cpp/identifier.hpp"
+
+#include "test_msgs/msg/arrays.h"
+#include "test_msgs/msg/arrays.hpp"
+#include "test_msgs/msg/basic_types.h"
+#include "test_msgs/msg/basic_types.hpp"
+#include "test_msgs/msg/nested.h"
+#include "test_msgs/msg/nested.hpp"
+#include "test_msgs/msg/strings.h"
+#include "test_msgs/msg/strings.hpp"
+#include "test_msgs/msg/unbounded_sequences.h"
+#include "test_msgs/msg/unbounded_sequences.hpp"
+#include "test_msgs/msg/w_strings.h"
+#include "test_msgs/msg/w_strings.hpp"
+
+using rmw_fastrtps_shared_cpp::is_xcdr2_interoperable;
+
+TEST(TestTypeSupport, xcdr2_interoperable_c) {
+  EXPECT_TRUE(is_xcdr2_interoperable(ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, BasicTypes)));
+  EXPECT_TRUE(is_xcdr2_interoperable(ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Strings)));
+  EXPECT_TRUE(is_xcdr2_interoperable(ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Nested)));
+  EXPECT_FALSE(is_xcdr2_interoperable(ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Arrays)));
+  EXPECT_FALSE(
+    is_xcdr2_interoperable(ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, UnboundedSequences)));
+  EXPECT_FALSE(is_xcdr2_interoperable(ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, WStrings)));
+  EXPECT_FALSE(rmw_error_is_set());
+}
+
+TEST(TestTypeSupport, xcdr2_interoperable_cpp) {
+  using rosidl_typesupport_cpp::get_message_type_support_handle;
+  EXPECT_TRUE(
+    is_xcdr2_interoperable(get_message_type_support_handle<test_msgs::msg::BasicTypes>()));
+  EXPECT_TRUE(is_xcdr2_interoperable(get_message_type_support_handle<test_msgs::msg::Strings>()));
+  EXPECT_TRUE(is_xcdr2_interoperable(get_message_type_support_handle<test_msgs::msg::Nested>()));
+  EXPECT_FALSE(is_xcdr2_interoperable(get_message_type_support_handle<test_msgs::msg::Arrays>()));
+  EXPECT_FALSE(
+    is_xcdr2_interoperable(
+      get_message_type_support_handle<test_msgs::msg::UnboundedSequences>()));
+  EXPECT_FALSE(
+    is_xcdr2_interoperable(get_message_type_support_handle<test_msgs::msg::WStrings>()));
+  EXPECT_FALSE(rmw_error_is_set());
+}
+
+namespace
+{
+
+const message_type_support_callbacks_t * get_fastrtps_c_callbacks(
+  const rosidl_message_type_support_t * type_support)
+{
+  const rosidl_message_type_support_t * ts = get_message_typesupport_handle(
+    type_support, rosidl_typesupport_fastrtps_c__identifier);
+  return nullptr == ts ? nullptr : static_cast<const message_type_support_callbacks_t *>(ts->data);
+}
+
+const message_type_support_callbacks_t * get_fastrtps_cpp_callbacks(
+  const rosidl_message_type_support_t * type_support)
+{
+  const rosidl_message_type_support_t * ts = get_message_typesupport_handle(
+    type_support, rosidl_typesupport_fastrtps_cpp::typesupport_identifier);
+  return nullptr == ts ? nullptr : static_cast<const message_type_support_callbacks_t *>(ts->data);
+}
+
+void fill_basic_types(test_msgs__msg__BasicTypes & msg)
+{
+  // Zero the padding too, so that copying the message gives the same bytes as serializing it
+  std::memset(&msg, 0, sizeof(msg));
+  msg.bool_value = true;
+  msg.byte_value = 0x12;
+  msg.char_value = 0x34;
+  msg.float32_value = 1.125f;
+  msg.float64_value = -2.5e10;
+  msg.int8_value = -5;
+  msg.uint8_value = 250u;
+  msg.int16_value = -1234;
+  msg.uint16_value = 54321u;
+  msg.int32_value = -12345678;
+  msg.uint32_value = 3456789012u;
+  msg.int64_value = -1234567890123LL;
+  msg.uint64_value = 12345678901234ULL;
+}
+
+void expect_basic_types_eq(
+  const test_msgs__msg__BasicTypes & expected, const test_msgs__msg__BasicTypes & actual)
+{
+  EXPECT_EQ(expected.bool_value, actual.bool_value);
+  EXPECT_EQ(expected.byte_value, actual.byte_value);
+  EXPECT_EQ(expected.char_value, actual.char_value);
+  EXPECT_EQ(expected.float32_value, actual.float32_value);
+  EXPECT_EQ(expected.float64_value, actual.float64_value);
+  EXPECT_EQ(expected.int8_value, actual.int8_value);
+  EXPECT_EQ(expected.uint8_value, actual.uint8_value);
+  EXPECT_EQ(expected.int16_value, actual.int16_value);
+  EXPECT_EQ(expected.uint16_value, actual.uint16_value);
+  EXPECT_EQ(expected.int32_value, actual.int32_value);
+  EXPECT_EQ(expected.uint32_value, actual.uint32_value);
+  EXPECT_EQ(expected.int64_value, actual.int64_value);
+  EXPECT_EQ(expected.uint64_value, actual.uint64_value);
+}
+
+}  // namespace
+
+TEST(TestTypeSupport, plain_copy_matches_generated_code) {
+  const rosidl_message_type_support_t * ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, BasicTypes);
+  const message_type_support_callbacks_t * callbacks = get_fastrtps_c_callbacks(ts);
+  ASSERT_NE(nullptr, callbacks);
+  rmw_fastrtps_cpp::MessageTypeSupport type_support(callbacks, ts);
+  if (!type_support.is_plain()) {
+    GTEST_SKIP() << "messages are not copied as is with this type support";
+  }
+
+  test_msgs__msg__BasicTypes msg;
+  fill_basic_types(msg);
+
+  // Serialized by the generated code
+  std::vector<char> expected(type_support.getEstimatedSerializedSize(&msg, callbacks), 0);
+  eprosima::fastcdr::FastBuffer buffer(expected.data(), expected.size());
+  eprosima::fastcdr::Cdr ser(
+    buffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN, eprosima::fastcdr::CdrVersion::XCDRv1);
+  ser.set_encoding_flag(eprosima::fastcdr::EncodingAlgorithmFlag::PLAIN_CDR);
+  ser.serialize_encapsulation();
+  ASSERT_TRUE(callbacks->cdr_serialize(&msg, ser));
+  const size_t expected_length = ser.get_serialized_data_length();
+
+  // Serialized by copying the message as is
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rmw_serialized_message_t serialized_message = rmw_get_zero_initialized_serialized_message();
+  ASSERT_EQ(RMW_RET_OK, rmw_serialized_message_init(&serialized_message, 0u, &allocator));
+  ASSERT_EQ(RMW_RET_OK, rmw_serialize(&msg, ts, &serialized_message)) << rmw_get_error_string().str;
+  ASSERT_LE(expected_length, serialized_message.buffer_length);
+  EXPECT_EQ(0, std::memcmp(expected.data(), serialized_message.buffer, expected_length));
+
+  // Copied back, from what both wrote
+  test_msgs__msg__BasicTypes output;
+  std::memset(&output, 0, sizeof(output));
+  ASSERT_EQ(RMW_RET_OK, rmw_deserialize(&serialized_message, ts, &output));
+  expect_basic_types_eq(msg, output);
+
+  EXPECT_EQ(RMW_RET_OK, rmw_serialized_message_fini(&serialized_message));
+  EXPECT_FALSE(rmw_error_is_set());
+}
+
+TEST(TestTypeSupport, plain_layout_checks_every_member) {
+  using rmw_fastrtps_shared_cpp::has_plain_layout;
+  using rosidl_typesupport_cpp::get_message_type_support_handle;
+  const rosidl_message_type_support_t * type_supports[] = {
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, BasicTypes),
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Nested),
+    get_message_type_support_handle<test_msgs::msg::BasicTypes>(),
+    get_message_type_support_handle<test_msgs::msg::Nested>(),
+  };
+  for (const rosidl_message_type_support_t * ts : type_supports) {
+    const message_type_support_callbacks_t * callbacks = get_fastrtps_c_callbacks(ts);
+    if (nullptr == callbacks) {
+      rmw_reset_error();
+      callbacks = get_fastrtps_cpp_callbacks(ts);
+    }
+    ASSERT_NE(nullptr, callbacks);
+    rmw_fastrtps_cpp::MessageTypeSupport type_support(callbacks, ts);
+    if (!type_support.is_plain()) {
+      continue;
+    }
+    EXPECT_TRUE(has_plain_layout(ts, type_support.get_plain_size()));
+    // Not where the last member ends
+    EXPECT_FALSE(has_plain_layout(ts, type_support.get_plain_size() + 8u));
+  }
+
+  // Strings are not stored inline
+  EXPECT_FALSE(has_plain_layout(ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Strings), 0u));
+  EXPECT_FALSE(
+    has_plain_layout(get_message_type_support_handle<test_msgs::msg::UnboundedSequences>(), 0u));
+  EXPECT_FALSE(rmw_error_is_set());
+}
+
+TEST(TestTypeSupport, serialized_message_size) {
+  size_t size = 0u;
+
+  // Bounded types are as large as what publishers preallocate for them
+  const rosidl_message_type_support_t * ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, BasicTypes);
+  const message_type_support_callbacks_t * callbacks = get_fastrtps_c_callbacks(ts);
+  ASSERT_NE(nullptr, callbacks);
+  rmw_fastrtps_cpp::MessageTypeSupport type_support(callbacks, ts);
+  ASSERT_EQ(RMW_RET_OK, rmw_get_serialized_message_size(ts, nullptr, &size)) <<
+    rmw_get_error_string().str;
+  EXPECT_EQ(type_support.m_typeSize, size);
+
+  test_msgs__msg__BasicTypes msg;
+  fill_basic_types(msg);
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rmw_serialized_message_t serialized_message = rmw_get_zero_initialized_serialized_message();
+  ASSERT_EQ(RMW_RET_OK, rmw_serialized_message_init(&serialized_message, 0u, &allocator));
+  ASSERT_EQ(RMW_RET_OK, rmw_serialize(&msg, ts, &serialized_message)) << rmw_get_error_string().str;
+  EXPECT_LE(serialized_message.buffer_length, size);
+  EXPECT_EQ(RMW_RET_OK, rmw_serialized_message_fini(&serialized_message));
+
+  // Unbounded types have no such size
+  size = 0u;
+  EXPECT_EQ(
+    RMW_RET_UNSUPPORTED,
+    rmw_get_serialized_message_size(
+      ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, UnboundedSequences), nullptr, &size));
+  EXPECT_TRUE(rmw_error_is_set());
+  rmw_reset_error();
+  EXPECT_EQ(0u, size);
+
+  EXPECT_EQ(
+    RMW_RET_UNSUPPORTED,
+    rmw_get_serialized_message_size(
+      rosidl_typesupport_cpp::get_message_type_support_handle<test_msgs::msg::Strings>(),
+      nullptr, &size));
+  EXPECT_TRUE(rmw_error_is_set());
+  rmw_reset_error();
+  EXPECT_EQ(0u, size);
+}
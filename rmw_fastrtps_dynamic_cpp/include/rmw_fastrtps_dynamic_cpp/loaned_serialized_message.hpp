@@ -0,0 +1,70 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_DYNAMIC_CPP__LOANED_SERIALIZED_MESSAGE_HPP_
+#define RMW_FASTRTPS_DYNAMIC_CPP__LOANED_SERIALIZED_MESSAGE_HPP_
+
+#include "rmw/rmw.h"
+#include "rmw_fastrtps_dynamic_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_dynamic_cpp
+{
+
+/// Take a serialized message loaned from the subscription's DataReader.
+/**
+ * On success, `serialized_message` is a read-only view of the loaned sample.
+ * It must not be resized nor finalized, and has to be given back with
+ * return_loaned_serialized_message() once it is no longer needed.
+ * Messages still on loan when the subscription is destroyed are given back with it, and must not
+ * be used afterwards.
+ *
+ * Subscriptions of plain types do not support this, and should loan the ROS message instead.
+ *
+ * \param[in] subscription subscription to take from.
+ * \param[out] serialized_message view of the loaned serialized message.
+ * \param[out] taken true if a message was taken.
+ * \param[out] message_info optional information about the taken message, may be `NULL`.
+ * \return `RMW_RET_OK` if successful, or
+ * \return `RMW_RET_INVALID_ARGUMENT` if an argument is `NULL`, or
+ * \return `RMW_RET_INCORRECT_RMW_IMPLEMENTATION` if the subscription is from a different
+ *   rmw implementation, or
+ * \return `RMW_RET_UNSUPPORTED` if the subscription loans ROS messages instead.
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+take_loaned_serialized_message(
+  const rmw_subscription_t * subscription,
+  rmw_serialized_message_t * serialized_message,
+  bool * taken,
+  rmw_message_info_t * message_info);
+
+/// Return a serialized message previously loaned by take_loaned_serialized_message().
+/**
+ * \param[in] subscription subscription the message was taken from.
+ * \param[inout] serialized_message loaned message, zero initialized on success.
+ * \return `RMW_RET_OK` if successful, or
+ * \return `RMW_RET_INVALID_ARGUMENT` if an argument is `NULL`, or
+ * \return `RMW_RET_INCORRECT_RMW_IMPLEMENTATION` if the subscription is from a different
+ *   rmw implementation, or
+ * \return `RMW_RET_ERROR` if the message was not loaned by this subscription.
+ */
+RMW_FASTRTPS_DYNAMIC_CPP_PUBLIC
+rmw_ret_t
+return_loaned_serialized_message(
+  const rmw_subscription_t * subscription,
+  rmw_serialized_message_t * serialized_message);
+
+}  // namespace rmw_fastrtps_dynamic_cpp
+
+#endif  // RMW_FASTRTPS_DYNAMIC_CPP__LOANED_SERIALIZED_MESSAGE_HPP_
@@ -60,8 +60,12 @@ MessageTypeSupport<MembersType>::MessageTypeSupport(
   } else {
     this->m_typeSize++;
   }
+  // Plain messages are laid out in memory as in CDR, without the encapsulation
+  this->plain_size_ = this->is_plain_ ? this->m_typeSize - 4 : 0u;
   // Account for RTPS submessage alignment
   this->m_typeSize = (this->m_typeSize + 3) & ~3;
+
+  this->buildSerializationPlan();
 }
 
 }  // namespace rmw_fastrtps_dynamic_cpp
@@ -16,13 +16,17 @@
 #define TYPESUPPORT_HPP_
 
 #include <cassert>
+#include <map>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #include "rosidl_runtime_c/string.h"
 #include "rosidl_runtime_c/string_functions.h"
 
 #include "fastcdr/FastBuffer.h"
 #include "fastcdr/Cdr.h"
+#include "fastcdr/exceptions/NotEnoughMemoryException.h"
 
 #include "rcutils/logging_macros.h"
 
@@ -48,8 +52,8 @@ namespace rmw_fastrtps_dynamic_cpp
 template<typename MembersType>
 struct StringHelper;
 
-// For C introspection typesupport we create intermediate instances of std::string so that
-// eprosima::fastcdr::Cdr can handle the string properly.
+// For C introspection typesupport strings are written and read straight from their buffer, with
+// the same representation eprosima::fastcdr::Cdr gives to std::string.
 template<>
 struct StringHelper<rosidl_typesupport_introspection_c__MessageMembers>
 {
@@ -76,35 +80,35 @@ struct StringHelper<rosidl_typesupport_introspection_c__MessageMembers>
     return current_alignment + strlen(c_string->data) + 1;
   }
 
-  static std::string convert_to_std_string(void * data)
+  static void serialize(eprosima::fastcdr::Cdr & ser, const rosidl_runtime_c__String & str)
   {
-    auto c_string = static_cast<rosidl_runtime_c__String *>(data);
-    if (!c_string) {
-      RCUTILS_LOG_ERROR_NAMED(
-        "rmw_fastrtps_dynamic_cpp",
-        "Failed to cast data as rosidl_runtime_c__String");
-      return "";
-    }
-    if (!c_string->data) {
+    const char * data = str.data;
+    if (!data) {
       RCUTILS_LOG_ERROR_NAMED(
         "rmw_fastrtps_dynamic_cpp",
         "rosidl_generator_c_String had invalid data");
-      return "";
+      data = "";
     }
-    return std::string(c_string->data);
+    ser.serialize(data);
   }
 
-  static std::string convert_to_std_string(rosidl_runtime_c__String & data)
+  static void deserialize(eprosima::fastcdr::Cdr & deser, rosidl_runtime_c__String & str)
   {
-    return std::string(data.data);
-  }
-
-  static void assign(eprosima::fastcdr::Cdr & deser, void * field)
-  {
-    std::string str;
-    deser >> str;
-    rosidl_runtime_c__String * c_str = static_cast<rosidl_runtime_c__String *>(field);
-    rosidl_runtime_c__String__assign(c_str, str.c_str());
+    uint32_t length = 0;
+    deser >> length;
+    const char * data = deser.get_current_position();
+    if (!deser.jump(length)) {
+      using eprosima::fastcdr::exception::NotEnoughMemoryException;
+      throw NotEnoughMemoryException(NotEnoughMemoryException::NOT_ENOUGH_MEMORY_MESSAGE_DEFAULT);
+    }
+    // The length accounts for the null terminator, when there is one
+    size_t size = length;
+    if (size > 0u && '\0' == data[size - 1]) {
+      --size;
+    }
+    if (!rosidl_runtime_c__String__assignn(&str, data, size)) {
+      throw std::runtime_error("unable to assign rosidl_runtime_c__String");
+    }
   }
 };
 
@@ -175,23 +179,67 @@ protected:
 
   size_t calculateMaxSerializedSize(const MembersType * members, size_t current_alignment);
 
+  /// Compile the serialization plan of members_, which must already be set.
+  void buildSerializationPlan();
+
   const MembersType * members_;
 
 private:
+  using MemberType = typename std::remove_const<
+    typename std::remove_pointer<decltype(MembersType::members_)>::type>::type;
+
+  /// Step of the serialization plan of a message type.
+  /**
+   * Plans are compiled once per type, so that (de)serializing a message does not need to walk
+   * the introspection members and dispatch on the type of each one of them.
+   * Nested messages are inlined in the plan of their parent, and runs of primitives of the same
+   * size which are contiguous in memory are merged into a single step.
+   */
+  struct PlanOp
+  {
+    enum Code : uint8_t
+    {
+      /// `count` primitives of `size` bytes each, contiguous in memory.
+      PRIMITIVES,
+      /// Single member handled on its own, like strings, sequences and booleans.
+      MEMBER,
+      /// Array or sequence of messages, each one handled with `plan`.
+      MESSAGES,
+    };
+
+    Code code;
+    uint8_t size;
+    uint32_t count;
+    /// Offset from the start of the message the plan is run on.
+    size_t offset;
+    const MemberType * member;
+    const std::vector<PlanOp> * plan;
+  };
+
+  using Plan = std::vector<PlanOp>;
+
+  void compilePlan(const MembersType * members, size_t base_offset, Plan & plan);
+
+  const Plan * getNestedPlan(const MembersType * members);
+
   size_t getEstimatedSerializedSize(
-    const MembersType * members,
+    const Plan & plan,
     const void * ros_message,
     size_t current_alignment) const;
 
   bool serializeROSmessage(
     eprosima::fastcdr::Cdr & ser,
-    const MembersType * members,
+    const Plan & plan,
     const void * ros_message) const;
 
   bool deserializeROSmessage(
     eprosima::fastcdr::Cdr & deser,
-    const MembersType * members,
+    const Plan & plan,
     void * ros_message) const;
+
+  Plan plan_;
+  // Plans of the messages in arrays and sequences, which steps of other plans point to
+  std::map<const MembersType *, Plan> nested_plans_;
 };
 
 }  // namespace rmw_fastrtps_dynamic_cpp
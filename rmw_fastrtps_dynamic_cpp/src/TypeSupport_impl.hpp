@@ -136,33 +136,25 @@ void serialize_field<std::string>(
 {
   using CStringHelper = StringHelper<rosidl_typesupport_introspection_c__MessageMembers>;
   if (!member->is_array_) {
-    auto && str = CStringHelper::convert_to_std_string(field);
+    auto & str = *static_cast<rosidl_runtime_c__String *>(field);
     // Control maximum length.
-    if (member->string_upper_bound_ && str.length() > member->string_upper_bound_ + 1) {
+    if (member->string_upper_bound_ && str.data &&
+      strlen(str.data) > member->string_upper_bound_ + 1)
+    {
       throw std::runtime_error("string overcomes the maximum length");
     }
-    ser << str;
+    CStringHelper::serialize(ser, str);
+  } else if (member->array_size_ && !member->is_upper_bound_) {
+    auto string_field = static_cast<rosidl_runtime_c__String *>(field);
+    for (size_t i = 0; i < member->array_size_; ++i) {
+      CStringHelper::serialize(ser, string_field[i]);
+    }
   } else {
-    // First, cast field to rosidl_generator_c
-    // Then convert to a std::string using StringHelper and serialize the std::string
-    if (member->array_size_ && !member->is_upper_bound_) {
-      // tmpstring is defined here and not below to avoid
-      // memory allocation in every iteration of the for loop
-      std::string tmpstring;
-      auto string_field = static_cast<rosidl_runtime_c__String *>(field);
-      for (size_t i = 0; i < member->array_size_; ++i) {
-        tmpstring = string_field[i].data;
-        ser.serialize(tmpstring);
-      }
-    } else {
-      auto & string_sequence_field =
-        *reinterpret_cast<rosidl_runtime_c__String__Sequence *>(field);
-      std::vector<std::string> cpp_string_vector;
-      for (size_t i = 0; i < string_sequence_field.size; ++i) {
-        cpp_string_vector.push_back(
-          CStringHelper::convert_to_std_string(string_sequence_field.data[i]));
-      }
-      ser << cpp_string_vector;
+    auto & string_sequence_field =
+      *reinterpret_cast<rosidl_runtime_c__String__Sequence *>(field);
+    ser << static_cast<uint32_t>(string_sequence_field.size);
+    for (size_t i = 0; i < string_sequence_field.size; ++i) {
+      CStringHelper::serialize(ser, string_sequence_field.data[i]);
     }
   }
 }
@@ -191,99 +183,132 @@ void serialize_field<std::wstring>(
   }
 }
 
+template<typename MemberType>
+void serialize_member(
+  const MemberType * member,
+  void * field,
+  eprosima::fastcdr::Cdr & ser)
+{
+  switch (member->type_id_) {
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BOOL:
+      if (!member->is_array_) {
+        // don't cast to bool here because if the bool is
+        // uninitialized the random value can't be deserialized
+        ser << (*static_cast<uint8_t *>(field) ? true : false);
+      } else {
+        serialize_field<bool>(member, field, ser);
+      }
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BYTE:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8:
+      serialize_field<uint8_t>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_CHAR:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT8:
+      serialize_field<char>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT32:
+      serialize_field<float>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64:
+      serialize_field<double>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT16:
+      serialize_field<int16_t>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT16:
+      serialize_field<uint16_t>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32:
+      serialize_field<int32_t>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32:
+      serialize_field<uint32_t>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT64:
+      serialize_field<int64_t>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT64:
+      serialize_field<uint64_t>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING:
+      serialize_field<std::string>(member, field, ser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_WSTRING:
+      serialize_field<std::wstring>(member, field, ser);
+      break;
+    default:
+      throw std::runtime_error("unknown type");
+  }
+}
+
+inline void serialize_primitives(
+  eprosima::fastcdr::Cdr & ser, const void * data, size_t size, size_t count)
+{
+  switch (size) {
+    case 1:
+      ser.serialize_array(static_cast<const uint8_t *>(data), count);
+      break;
+    case 2:
+      ser.serialize_array(static_cast<const uint16_t *>(data), count);
+      break;
+    case 4:
+      ser.serialize_array(static_cast<const uint32_t *>(data), count);
+      break;
+    case 8:
+      ser.serialize_array(static_cast<const uint64_t *>(data), count);
+      break;
+    default:
+      throw std::runtime_error("unexpected primitive size");
+  }
+}
+
 template<typename MembersType>
 bool TypeSupport<MembersType>::serializeROSmessage(
   eprosima::fastcdr::Cdr & ser,
-  const MembersType * members,
+  const Plan & plan,
   const void * ros_message) const
 {
-  assert(members);
   assert(ros_message);
 
-  for (uint32_t i = 0; i < members->member_count_; ++i) {
-    const auto member = members->members_ + i;
-    void * field = const_cast<char *>(static_cast<const char *>(ros_message)) + member->offset_;
-    switch (member->type_id_) {
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BOOL:
-        if (!member->is_array_) {
-          // don't cast to bool here because if the bool is
-          // uninitialized the random value can't be deserialized
-          ser << (*static_cast<uint8_t *>(field) ? true : false);
-        } else {
-          serialize_field<bool>(member, field, ser);
-        }
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BYTE:
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8:
-        serialize_field<uint8_t>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_CHAR:
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT8:
-        serialize_field<char>(member, field, ser);
+  for (const PlanOp & op : plan) {
+    void * field = const_cast<char *>(static_cast<const char *>(ros_message)) + op.offset;
+    switch (op.code) {
+      case PlanOp::PRIMITIVES:
+        serialize_primitives(ser, field, op.size, op.count);
         break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT32:
-        serialize_field<float>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64:
-        serialize_field<double>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT16:
-        serialize_field<int16_t>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT16:
-        serialize_field<uint16_t>(member, field, ser);
+      case PlanOp::MEMBER:
+        serialize_member(op.member, field, ser);
         break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32:
-        serialize_field<int32_t>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32:
-        serialize_field<uint32_t>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT64:
-        serialize_field<int64_t>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT64:
-        serialize_field<uint64_t>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING:
-        serialize_field<std::string>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_WSTRING:
-        serialize_field<std::wstring>(member, field, ser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE:
+      case PlanOp::MESSAGES:
         {
-          auto sub_members = static_cast<const MembersType *>(member->members_->data);
-          if (!member->is_array_) {
-            serializeROSmessage(ser, sub_members, field);
+          const auto * member = op.member;
+          size_t array_size = 0;
+
+          if (member->array_size_ && !member->is_upper_bound_) {
+            array_size = member->array_size_;
           } else {
-            size_t array_size = 0;
-
-            if (member->array_size_ && !member->is_upper_bound_) {
-              array_size = member->array_size_;
-            } else {
-              if (!member->size_function) {
-                RMW_SET_ERROR_MSG("unexpected error: size function is null");
-                return false;
-              }
-              array_size = member->size_function(field);
-
-              // Serialize length
-              ser << (uint32_t)array_size;
+            if (!member->size_function) {
+              RMW_SET_ERROR_MSG("unexpected error: size function is null");
+              return false;
             }
+            array_size = member->size_function(field);
 
-            if (array_size != 0 && !member->get_function) {
-              RMW_SET_ERROR_MSG("unexpected error: get_function function is null");
+            // Serialize length
+            ser << (uint32_t)array_size;
+          }
+
+          if (array_size != 0 && !member->get_function) {
+            RMW_SET_ERROR_MSG("unexpected error: get_function function is null");
+            return false;
+          }
+          for (size_t index = 0; index < array_size; ++index) {
+            if (!serializeROSmessage(ser, *op.plan, member->get_function(field, index))) {
               return false;
             }
-            for (size_t index = 0; index < array_size; ++index) {
-              serializeROSmessage(ser, sub_members, member->get_function(field, index));
-            }
           }
         }
         break;
-      default:
-        throw std::runtime_error("unknown type");
     }
   }
 
@@ -454,98 +479,110 @@ size_t next_field_align_string<std::wstring>(
   return current_alignment;
 }
 
+template<typename MemberType>
+size_t next_member_align(
+  const MemberType * member,
+  void * field,
+  size_t current_alignment)
+{
+  switch (member->type_id_) {
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BOOL:
+      current_alignment = next_field_align<bool>(member, field, current_alignment);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BYTE:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8:
+      current_alignment = next_field_align<uint8_t>(member, field, current_alignment);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_CHAR:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT8:
+      current_alignment = next_field_align<char>(member, field, current_alignment);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT32:
+      current_alignment = next_field_align<float>(member, field, current_alignment);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64:
+      current_alignment = next_field_align<double>(member, field, current_alignment);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT16:
+      current_alignment = next_field_align<int16_t>(member, field, current_alignment);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT16:
+      current_alignment = next_field_align<uint16_t>(member, field, current_alignment);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32:
+      current_alignment = next_field_align<int32_t>(member, field, current_alignment);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32:
+      current_alignment = next_field_align<uint32_t>(member, field, current_alignment);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT64:
+      current_alignment = next_field_align<int64_t>(member, field, current_alignment);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT64:
+      current_alignment = next_field_align<uint64_t>(member, field, current_alignment);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING:
+      current_alignment = next_field_align_string<std::string>(member, field, current_alignment);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_WSTRING:
+      current_alignment = next_field_align_string<std::wstring>(member, field, current_alignment);
+      break;
+    default:
+      throw std::runtime_error("unknown type");
+  }
+  return current_alignment;
+}
+
 template<typename MembersType>
 size_t TypeSupport<MembersType>::getEstimatedSerializedSize(
-  const MembersType * members,
+  const Plan & plan,
   const void * ros_message,
   size_t current_alignment) const
 {
-  assert(members);
   assert(ros_message);
 
   size_t initial_alignment = current_alignment;
 
-  for (uint32_t i = 0; i < members->member_count_; ++i) {
-    const auto member = members->members_ + i;
-    void * field = const_cast<char *>(static_cast<const char *>(ros_message)) + member->offset_;
-    switch (member->type_id_) {
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BOOL:
-        current_alignment = next_field_align<bool>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BYTE:
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8:
-        current_alignment = next_field_align<uint8_t>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_CHAR:
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT8:
-        current_alignment = next_field_align<char>(member, field, current_alignment);
+  for (const PlanOp & op : plan) {
+    void * field = const_cast<char *>(static_cast<const char *>(ros_message)) + op.offset;
+    switch (op.code) {
+      case PlanOp::PRIMITIVES:
+        current_alignment += eprosima::fastcdr::Cdr::alignment(current_alignment, op.size);
+        current_alignment += op.size * op.count;
         break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT32:
-        current_alignment = next_field_align<float>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64:
-        current_alignment = next_field_align<double>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT16:
-        current_alignment = next_field_align<int16_t>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT16:
-        current_alignment = next_field_align<uint16_t>(member, field, current_alignment);
+      case PlanOp::MEMBER:
+        current_alignment = next_member_align(op.member, field, current_alignment);
         break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32:
-        current_alignment = next_field_align<int32_t>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32:
-        current_alignment = next_field_align<uint32_t>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT64:
-        current_alignment = next_field_align<int64_t>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT64:
-        current_alignment = next_field_align<uint64_t>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING:
-        current_alignment = next_field_align_string<std::string>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_WSTRING:
-        current_alignment = next_field_align_string<std::wstring>(member, field, current_alignment);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE:
+      case PlanOp::MESSAGES:
         {
-          auto sub_members = static_cast<const MembersType *>(member->members_->data);
-          if (!member->is_array_) {
-            current_alignment += getEstimatedSerializedSize(sub_members, field, current_alignment);
-          } else {
-            size_t array_size = 0;
-
-            if (member->array_size_ && !member->is_upper_bound_) {
-              array_size = member->array_size_;
-            } else {
-              if (!member->size_function) {
-                RMW_SET_ERROR_MSG("unexpected error: size function is null");
-                return false;
-              }
-              array_size = member->size_function(field);
-
-              // Length serialization
-              current_alignment += 4 + eprosima::fastcdr::Cdr::alignment(current_alignment, 4);
-            }
+          const auto * member = op.member;
+          size_t array_size = 0;
 
-            if (array_size != 0 && !member->get_function) {
-              RMW_SET_ERROR_MSG("unexpected error: get_function function is null");
+          if (member->array_size_ && !member->is_upper_bound_) {
+            array_size = member->array_size_;
+          } else {
+            if (!member->size_function) {
+              RMW_SET_ERROR_MSG("unexpected error: size function is null");
               return false;
             }
-            for (size_t index = 0; index < array_size; ++index) {
-              current_alignment += getEstimatedSerializedSize(
-                sub_members,
-                member->get_function(field, index),
-                current_alignment);
-            }
+            array_size = member->size_function(field);
+
+            // Length serialization
+            current_alignment += 4 + eprosima::fastcdr::Cdr::alignment(current_alignment, 4);
+          }
+
+          if (array_size != 0 && !member->get_function) {
+            RMW_SET_ERROR_MSG("unexpected error: get_function function is null");
+            return false;
+          }
+          for (size_t index = 0; index < array_size; ++index) {
+            current_alignment += getEstimatedSerializedSize(
+              *op.plan,
+              member->get_function(field, index),
+              current_alignment);
           }
         }
         break;
-      default:
-        throw std::runtime_error("unknown type");
     }
   }
 
@@ -634,42 +671,30 @@ inline void deserialize_field<std::string>(
   void * field,
   eprosima::fastcdr::Cdr & deser)
 {
+  using CStringHelper = StringHelper<rosidl_typesupport_introspection_c__MessageMembers>;
   if (!member->is_array_) {
-    using CStringHelper = StringHelper<rosidl_typesupport_introspection_c__MessageMembers>;
-    CStringHelper::assign(deser, field);
+    CStringHelper::deserialize(deser, *static_cast<rosidl_runtime_c__String *>(field));
+  } else if (member->array_size_ && !member->is_upper_bound_) {
+    auto deser_field = static_cast<rosidl_runtime_c__String *>(field);
+    for (size_t i = 0; i < member->array_size_; ++i) {
+      CStringHelper::deserialize(deser, deser_field[i]);
+    }
   } else {
-    if (member->array_size_ && !member->is_upper_bound_) {
-      auto deser_field = static_cast<rosidl_runtime_c__String *>(field);
-      // tmpstring is defined here and not below to avoid
-      // memory allocation in every iteration of the for loop
-      std::string tmpstring;
-      for (size_t i = 0; i < member->array_size_; ++i) {
-        deser.deserialize(tmpstring);
-        if (!rosidl_runtime_c__String__assign(&deser_field[i], tmpstring.c_str())) {
-          throw std::runtime_error("unable to assign rosidl_runtime_c__String");
-        }
-      }
-    } else {
-      std::vector<std::string> cpp_string_vector;
-      deser >> cpp_string_vector;
+    uint32_t size = 0;
+    deser >> size;
 
-      auto & string_sequence_field =
-        *reinterpret_cast<rosidl_runtime_c__String__Sequence *>(field);
-      if (
-        !rosidl_runtime_c__String__Sequence__init(
-          &string_sequence_field, cpp_string_vector.size()))
-      {
+    auto & string_sequence_field =
+      *reinterpret_cast<rosidl_runtime_c__String__Sequence *>(field);
+    // Strings already in the sequence are reused when its size does not change
+    if (string_sequence_field.size != size) {
+      rosidl_runtime_c__String__Sequence__fini(&string_sequence_field);
+      if (!rosidl_runtime_c__String__Sequence__init(&string_sequence_field, size)) {
         throw std::runtime_error("unable to initialize rosidl_runtime_c__String array");
       }
+    }
 
-      for (size_t i = 0; i < cpp_string_vector.size(); ++i) {
-        if (
-          !rosidl_runtime_c__String__assign(
-            &string_sequence_field.data[i], cpp_string_vector[i].c_str()))
-        {
-          throw std::runtime_error("unable to assign rosidl_runtime_c__String");
-        }
-      }
+    for (size_t i = 0; i < string_sequence_field.size; ++i) {
+      CStringHelper::deserialize(deser, string_sequence_field.data[i]);
     }
   }
 }
@@ -700,98 +725,127 @@ inline void deserialize_field<std::wstring>(
   }
 }
 
+template<typename MemberType>
+void deserialize_member(
+  const MemberType * member,
+  void * field,
+  eprosima::fastcdr::Cdr & deser)
+{
+  switch (member->type_id_) {
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BOOL:
+      deserialize_field<bool>(member, field, deser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BYTE:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8:
+      deserialize_field<uint8_t>(member, field, deser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_CHAR:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT8:
+      deserialize_field<char>(member, field, deser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT32:
+      deserialize_field<float>(member, field, deser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64:
+      deserialize_field<double>(member, field, deser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT16:
+      deserialize_field<int16_t>(member, field, deser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT16:
+      deserialize_field<uint16_t>(member, field, deser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32:
+      deserialize_field<int32_t>(member, field, deser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32:
+      deserialize_field<uint32_t>(member, field, deser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT64:
+      deserialize_field<int64_t>(member, field, deser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT64:
+      deserialize_field<uint64_t>(member, field, deser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING:
+      deserialize_field<std::string>(member, field, deser);
+      break;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_WSTRING:
+      deserialize_field<std::wstring>(member, field, deser);
+      break;
+    default:
+      throw std::runtime_error("unknown type");
+  }
+}
+
+inline void deserialize_primitives(
+  eprosima::fastcdr::Cdr & deser, void * data, size_t size, size_t count)
+{
+  switch (size) {
+    case 1:
+      deser.deserialize_array(static_cast<uint8_t *>(data), count);
+      break;
+    case 2:
+      deser.deserialize_array(static_cast<uint16_t *>(data), count);
+      break;
+    case 4:
+      deser.deserialize_array(static_cast<uint32_t *>(data), count);
+      break;
+    case 8:
+      deser.deserialize_array(static_cast<uint64_t *>(data), count);
+      break;
+    default:
+      throw std::runtime_error("unexpected primitive size");
+  }
+}
+
 template<typename MembersType>
 bool TypeSupport<MembersType>::deserializeROSmessage(
   eprosima::fastcdr::Cdr & deser,
-  const MembersType * members,
+  const Plan & plan,
   void * ros_message) const
 {
-  assert(members);
   assert(ros_message);
 
-  for (uint32_t i = 0; i < members->member_count_; ++i) {
-    const auto * member = members->members_ + i;
-    void * field = static_cast<char *>(ros_message) + member->offset_;
-    switch (member->type_id_) {
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BOOL:
-        deserialize_field<bool>(member, field, deser);
+  for (const PlanOp & op : plan) {
+    void * field = static_cast<char *>(ros_message) + op.offset;
+    switch (op.code) {
+      case PlanOp::PRIMITIVES:
+        deserialize_primitives(deser, field, op.size, op.count);
         break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BYTE:
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8:
-        deserialize_field<uint8_t>(member, field, deser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_CHAR:
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT8:
-        deserialize_field<char>(member, field, deser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT32:
-        deserialize_field<float>(member, field, deser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64:
-        deserialize_field<double>(member, field, deser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT16:
-        deserialize_field<int16_t>(member, field, deser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT16:
-        deserialize_field<uint16_t>(member, field, deser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32:
-        deserialize_field<int32_t>(member, field, deser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32:
-        deserialize_field<uint32_t>(member, field, deser);
+      case PlanOp::MEMBER:
+        deserialize_member(op.member, field, deser);
         break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT64:
-        deserialize_field<int64_t>(member, field, deser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT64:
-        deserialize_field<uint64_t>(member, field, deser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING:
-        deserialize_field<std::string>(member, field, deser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_WSTRING:
-        deserialize_field<std::wstring>(member, field, deser);
-        break;
-      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE:
+      case PlanOp::MESSAGES:
         {
-          auto sub_members = static_cast<const MembersType *>(member->members_->data);
-          if (!member->is_array_) {
-            if (!deserializeROSmessage(deser, sub_members, field)) {
-              return false;
-            }
+          const auto * member = op.member;
+          size_t array_size = 0;
+
+          if (member->array_size_ && !member->is_upper_bound_) {
+            array_size = member->array_size_;
           } else {
-            size_t array_size = 0;
-
-            if (member->array_size_ && !member->is_upper_bound_) {
-              array_size = member->array_size_;
-            } else {
-              uint32_t num_elems = 0;
-              deser >> num_elems;
-              array_size = static_cast<size_t>(num_elems);
-
-              if (!member->resize_function) {
-                RMW_SET_ERROR_MSG("unexpected error: resize function is null");
-                return false;
-              }
-              member->resize_function(field, array_size);
-            }
+            uint32_t num_elems = 0;
+            deser >> num_elems;
+            array_size = static_cast<size_t>(num_elems);
 
-            if (array_size != 0 && !member->get_function) {
-              RMW_SET_ERROR_MSG("unexpected error: get_function function is null");
+            if (!member->resize_function) {
+              RMW_SET_ERROR_MSG("unexpected error: resize function is null");
               return false;
             }
-            for (size_t index = 0; index < array_size; ++index) {
-              if (!deserializeROSmessage(deser, sub_members, member->get_function(field, index))) {
-                return false;
-              }
+            member->resize_function(field, array_size);
+          }
+
+          if (array_size != 0 && !member->get_function) {
+            RMW_SET_ERROR_MSG("unexpected error: get_function function is null");
+            return false;
+          }
+          for (size_t index = 0; index < array_size; ++index) {
+            if (!deserializeROSmessage(deser, *op.plan, member->get_function(field, index))) {
+              return false;
             }
           }
         }
         break;
-      default:
-        throw std::runtime_error("unknown type");
     }
   }
 
@@ -901,6 +955,99 @@ size_t TypeSupport<MembersType>::calculateMaxSerializedSize(
   return ret_val;
 }
 
+// Size of the primitives of a type which can be (de)serialized as raw arrays, 0 otherwise.
+// Booleans are left out, as they are normalized when serialized.
+inline size_t mergeable_primitive_size(uint8_t type_id)
+{
+  switch (type_id) {
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BYTE:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_CHAR:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT8:
+      return 1u;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT16:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT16:
+      return 2u;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT32:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32:
+      return 4u;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT64:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT64:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT64:
+      return 8u;
+    default:
+      return 0u;
+  }
+}
+
+template<typename MembersType>
+void TypeSupport<MembersType>::compilePlan(
+  const MembersType * members, size_t base_offset, Plan & plan)
+{
+  assert(members);
+
+  for (uint32_t i = 0; i < members->member_count_; ++i) {
+    const auto * member = members->members_ + i;
+    const size_t offset = base_offset + member->offset_;
+
+    if (::rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE == member->type_id_) {
+      auto sub_members = static_cast<const MembersType *>(member->members_->data);
+      if (!member->is_array_) {
+        // Inlined, so that its primitives can merge with the surrounding ones
+        compilePlan(sub_members, offset, plan);
+      } else {
+        plan.push_back({PlanOp::MESSAGES, 0u, 0u, offset, member, getNestedPlan(sub_members)});
+      }
+      continue;
+    }
+
+    const size_t size = mergeable_primitive_size(member->type_id_);
+    const bool is_sequence =
+      member->is_array_ && (0u == member->array_size_ || member->is_upper_bound_);
+    if (0u == size || is_sequence) {
+      plan.push_back({PlanOp::MEMBER, 0u, 0u, offset, member, nullptr});
+      continue;
+    }
+
+    // CDR aligns a run of primitives of the same size once, as it does an array of them
+    const uint32_t count = member->is_array_ ? static_cast<uint32_t>(member->array_size_) : 1u;
+    if (!plan.empty()) {
+      PlanOp & last = plan.back();
+      if (PlanOp::PRIMITIVES == last.code && size == last.size &&
+        last.offset + last.size * last.count == offset)
+      {
+        last.count += count;
+        continue;
+      }
+    }
+    plan.push_back(
+      {PlanOp::PRIMITIVES, static_cast<uint8_t>(size), count, offset, nullptr, nullptr});
+  }
+}
+
+template<typename MembersType>
+auto TypeSupport<MembersType>::getNestedPlan(const MembersType * members) -> const Plan *
+{
+  auto it = nested_plans_.find(members);
+  if (nested_plans_.end() == it) {
+    // References to the elements of a map stay valid while compiling the plan
+    it = nested_plans_.emplace(members, Plan()).first;
+    compilePlan(members, 0u, it->second);
+  }
+  return &it->second;
+}
+
+template<typename MembersType>
+void TypeSupport<MembersType>::buildSerializationPlan()
+{
+  assert(members_);
+
+  plan_.clear();
+  nested_plans_.clear();
+  compilePlan(members_, 0u, plan_);
+}
+
 template<typename MembersType>
 size_t TypeSupport<MembersType>::getEstimatedSerializedSize(
   const void * ros_message, const void * impl) const
@@ -917,7 +1064,7 @@ size_t TypeSupport<MembersType>::getEstimatedSerializedSize(
 
   (void)impl;
   if (members_->member_count_ != 0) {
-    ret_val += TypeSupport::getEstimatedSerializedSize(members_, ros_message, 0);
+    ret_val += TypeSupport::getEstimatedSerializedSize(plan_, ros_message, 0);
   } else {
     ret_val += 1;
   }
@@ -937,7 +1084,7 @@ bool TypeSupport<MembersType>::serializeROSmessage(
 
   (void)impl;
   if (members_->member_count_ != 0) {
-    TypeSupport::serializeROSmessage(ser, members_, ros_message);
+    TypeSupport::serializeROSmessage(ser, plan_, ros_message);
   } else {
     ser << (uint8_t)0;
   }
@@ -958,7 +1105,7 @@ bool TypeSupport<MembersType>::deserializeROSmessage(
 
     (void)impl;
     if (members_->member_count_ != 0) {
-      return TypeSupport::deserializeROSmessage(deser, members_, ros_message);
+      return TypeSupport::deserializeROSmessage(deser, plan_, ros_message);
     }
 
     uint8_t dump = 0;
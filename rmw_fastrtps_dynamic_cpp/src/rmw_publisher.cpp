@@ -48,21 +48,35 @@ rmw_init_publisher_allocation(
   const rosidl_runtime_c__Sequence__bound * message_bounds,
   rmw_publisher_allocation_t * allocation)
 {
-  // Unused in current implementation.
-  (void) type_support;
+  RMW_CHECK_ARGUMENT_FOR_NULL(type_support, RMW_RET_INVALID_ARGUMENT);
+  const rosidl_message_type_support_t * ts = get_message_typesupport_handle(
+    type_support, rosidl_typesupport_introspection_c__identifier);
+  if (!ts) {
+    ts = get_message_typesupport_handle(
+      type_support, rosidl_typesupport_introspection_cpp::typesupport_identifier);
+    if (!ts) {
+      RMW_SET_ERROR_MSG("type support not from this implementation");
+      return RMW_RET_ERROR;
+    }
+  }
+
+  // The type support does not take sequence bounds into account, so only messages
+  // that are bounded as a whole have a known maximum size.
   (void) message_bounds;
-  (void) allocation;
-  RMW_SET_ERROR_MSG("unimplemented");
-  return RMW_RET_UNSUPPORTED;
+  TypeSupportRegistry & type_registry = TypeSupportRegistry::get_instance();
+  auto tss = type_registry.get_message_type_support(ts);
+  size_t max_serialized_size = tss->is_bounded() ? tss->m_typeSize : 0u;
+  type_registry.return_message_type_support(ts);
+
+  return rmw_fastrtps_shared_cpp::__rmw_init_publisher_allocation(
+    eprosima_fastrtps_identifier, max_serialized_size, allocation);
 }
 
 rmw_ret_t
 rmw_fini_publisher_allocation(rmw_publisher_allocation_t * allocation)
 {
-  // Unused in current implementation.
-  (void) allocation;
-  RMW_SET_ERROR_MSG("unimplemented");
-  return RMW_RET_UNSUPPORTED;
+  return rmw_fastrtps_shared_cpp::__rmw_fini_publisher_allocation(
+    eprosima_fastrtps_identifier, allocation);
 }
 
 rmw_publisher_t *
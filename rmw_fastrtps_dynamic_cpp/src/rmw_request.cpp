@@ -19,6 +19,7 @@
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
 
 #include "rmw_fastrtps_dynamic_cpp/identifier.hpp"
+#include "rmw_fastrtps_dynamic_cpp/take_service_sequence.hpp"
 
 extern "C"
 {
@@ -43,3 +44,20 @@ rmw_take_request(
     eprosima_fastrtps_identifier, service, request_header, ros_request, taken);
 }
 }  // extern "C"
+
+namespace rmw_fastrtps_dynamic_cpp
+{
+
+rmw_ret_t
+take_request_sequence(
+  const rmw_service_t * service,
+  size_t count,
+  void ** ros_requests,
+  rmw_service_info_t * request_headers,
+  size_t * taken)
+{
+  return rmw_fastrtps_shared_cpp::__rmw_take_request_sequence(
+    eprosima_fastrtps_identifier, service, count, ros_requests, request_headers, taken);
+}
+
+}  // namespace rmw_fastrtps_dynamic_cpp
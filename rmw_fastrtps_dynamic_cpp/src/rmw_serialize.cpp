@@ -15,6 +15,7 @@
 #include "fastcdr/FastBuffer.h"
 
 #include "rmw/error_handling.h"
+#include "rmw/impl/cpp/macros.hpp"
 #include "rmw/serialized_message.h"
 #include "rmw/rmw.h"
 
@@ -95,11 +96,40 @@ rmw_deserialize(
 
 rmw_ret_t
 rmw_get_serialized_message_size(
-  const rosidl_message_type_support_t * /*type_support*/,
-  const rosidl_runtime_c__Sequence__bound * /*message_bounds*/,
-  size_t * /*size*/)
+  const rosidl_message_type_support_t * type_support,
+  const rosidl_runtime_c__Sequence__bound * message_bounds,
+  size_t * size)
 {
-  RMW_SET_ERROR_MSG("unimplemented");
-  return RMW_RET_UNSUPPORTED;
+  RMW_CHECK_ARGUMENT_FOR_NULL(type_support, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_ARGUMENT_FOR_NULL(size, RMW_RET_INVALID_ARGUMENT);
+
+  const rosidl_message_type_support_t * ts = get_message_typesupport_handle(
+    type_support, rosidl_typesupport_introspection_c__identifier);
+  if (!ts) {
+    ts = get_message_typesupport_handle(
+      type_support, rosidl_typesupport_introspection_cpp::typesupport_identifier);
+    if (!ts) {
+      RMW_SET_ERROR_MSG("type support not from this implementation");
+      return RMW_RET_ERROR;
+    }
+  }
+
+  TypeSupportRegistry & type_registry = TypeSupportRegistry::get_instance();
+  auto tss = type_registry.get_message_type_support(ts);
+  const bool is_bounded = tss->is_bounded();
+  const size_t max_size = tss->m_typeSize;
+  type_registry.return_message_type_support(ts);
+
+  if (!is_bounded) {
+    // The layout of the data of sequence bounds is not defined by rosidl, so they cannot
+    // be used to bound the members of the type
+    (void)message_bounds;
+    RMW_SET_ERROR_MSG("serialized size of unbounded types is not supported");
+    return RMW_RET_UNSUPPORTED;
+  }
+
+  // Same size publishers preallocate, encapsulation included
+  *size = max_size;
+  return RMW_RET_OK;
 }
 }  // extern "C"
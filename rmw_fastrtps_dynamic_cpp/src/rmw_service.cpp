@@ -52,6 +52,7 @@
 #include "rosidl_typesupport_introspection_c/identifier.h"
 
 #include "rmw_fastrtps_shared_cpp/rmw_context_impl.hpp"
+#include "rmw_fastrtps_shared_cpp/client_response_filter.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_service_info.hpp"
 #include "rmw_fastrtps_shared_cpp/names.hpp"
@@ -215,6 +216,7 @@ rmw_create_service(
     });
 
   info->typesupport_identifier_ = type_support->typesupport_identifier;
+  info->defer_responses_ = participant_info->defer_service_responses;
 
   /////
   // Create the Type Support structs
@@ -368,6 +370,10 @@ rmw_create_service(
   info->request_reader_->get_statuscondition().set_enabled_statuses(
     eprosima::fastdds::dds::StatusMask::data_available());
 
+  if (participant_info->track_data_readiness) {
+    info->data_readiness_.enable(info->request_reader_, info->listener_);
+  }
+
   // lambda to delete datareader
   auto cleanup_datareader = rcpputils::make_scope_exit(
     [subscriber, info]() {
@@ -415,6 +421,9 @@ rmw_create_service(
     return nullptr;
   }
 
+  // Clients filter the responses on this writer, however many of them there are
+  rmw_fastrtps_shared_cpp::allow_client_response_filters(writer_qos);
+
   // Creates DataWriter
   info->response_writer_ = publisher->create_datawriter(
     info->response_topic_,
@@ -44,21 +44,35 @@ rmw_init_subscription_allocation(
   const rosidl_runtime_c__Sequence__bound * message_bounds,
   rmw_subscription_allocation_t * allocation)
 {
-  // Unused in current implementation.
-  (void) type_support;
+  RMW_CHECK_ARGUMENT_FOR_NULL(type_support, RMW_RET_INVALID_ARGUMENT);
+  const rosidl_message_type_support_t * ts = get_message_typesupport_handle(
+    type_support, rosidl_typesupport_introspection_c__identifier);
+  if (!ts) {
+    ts = get_message_typesupport_handle(
+      type_support, rosidl_typesupport_introspection_cpp::typesupport_identifier);
+    if (!ts) {
+      RMW_SET_ERROR_MSG("type support not from this implementation");
+      return RMW_RET_ERROR;
+    }
+  }
+
+  // The type support does not take sequence bounds into account, so only messages
+  // that are bounded as a whole have a known maximum size.
   (void) message_bounds;
-  (void) allocation;
-  RMW_SET_ERROR_MSG("unimplemented");
-  return RMW_RET_UNSUPPORTED;
+  TypeSupportRegistry & type_registry = TypeSupportRegistry::get_instance();
+  auto tss = type_registry.get_message_type_support(ts);
+  size_t max_serialized_size = tss->is_bounded() ? tss->m_typeSize : 0u;
+  type_registry.return_message_type_support(ts);
+
+  return rmw_fastrtps_shared_cpp::__rmw_init_subscription_allocation(
+    eprosima_fastrtps_identifier, max_serialized_size, allocation);
 }
 
 rmw_ret_t
 rmw_fini_subscription_allocation(rmw_subscription_allocation_t * allocation)
 {
-  // Unused in current implementation.
-  (void) allocation;
-  RMW_SET_ERROR_MSG("unimplemented");
-  return RMW_RET_UNSUPPORTED;
+  return rmw_fastrtps_shared_cpp::__rmw_fini_subscription_allocation(
+    eprosima_fastrtps_identifier, allocation);
 }
 
 rmw_subscription_t *
@@ -122,6 +136,17 @@ rmw_create_subscription(
   {
     return nullptr;
   }
+  if (info->synthetic_gid_) {
+    // Discovery only reports the shared DataReader, so this subscription is added by hand
+    common_context->graph_cache.add_entity(
+      info->subscription_gid_,
+      info->topic_->get_name(),
+      info->topic_->get_type_name(),
+      *type_supports->get_type_hash_func(type_supports),
+      common_context->gid,
+      adapted_qos_policies,
+      true);
+  }
 
   info->node_ = node;
   info->common_context_ = common_context;
@@ -15,9 +15,16 @@
 #ifndef SERIALIZATION_HELPERS_HPP_
 #define SERIALIZATION_HELPERS_HPP_
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <limits>
 #include <string>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #define SPECIALIZE_GENERIC_C_SEQUENCE(C_NAME, C_TYPE) \
   template<> \
   struct GenericCSequence<C_TYPE> \
@@ -33,6 +40,75 @@
     } \
   };
 
+namespace rmw_fastrtps_dynamic_cpp
+{
+
+// Wide characters are converted in blocks of this many, on the stack
+constexpr size_t u16_block_size = 256u;
+
+/// Widen UTF-16 code units to the 32 bits characters of CDR wide strings.
+inline void widen_u16(const char16_t * src, uint32_t * dst, size_t count)
+{
+  size_t i = 0u;
+#if defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 8u <= count; i += 8u) {
+    const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_unpacklo_epi16(chars, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i + 4u), _mm_unpackhi_epi16(chars, zero));
+  }
+#endif
+  for (; i < count; ++i) {
+    dst[i] = static_cast<uint32_t>(src[i]);
+  }
+}
+
+/// Narrow the 32 bits characters of CDR wide strings to UTF-16 code units.
+inline void narrow_u16(const uint32_t * src, char16_t * dst, size_t count)
+{
+  size_t i = 0u;
+#if defined(__SSE2__)
+  for (; i + 8u <= count; i += 8u) {
+    __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 4u));
+    // Sign extend the lower 16 bits, so that packing truncates instead of saturating
+    low = _mm_srai_epi32(_mm_slli_epi32(low, 16), 16);
+    high = _mm_srai_epi32(_mm_slli_epi32(high, 16), 16);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packs_epi32(low, high));
+  }
+#endif
+  for (; i < count; ++i) {
+    dst[i] = static_cast<char16_t>(src[i]);
+  }
+}
+
+inline void serialize_u16(eprosima::fastcdr::Cdr & cdr, const char16_t * data, size_t size)
+{
+  cdr << static_cast<uint32_t>(size);
+  uint32_t block[u16_block_size];
+  while (size > 0u) {
+    const size_t count = (std::min)(size, u16_block_size);
+    widen_u16(data, block, count);
+    cdr.serialize_array(block, count);
+    data += count;
+    size -= count;
+  }
+}
+
+inline void deserialize_u16(eprosima::fastcdr::Cdr & cdr, char16_t * data, size_t size)
+{
+  uint32_t block[u16_block_size];
+  while (size > 0u) {
+    const size_t count = (std::min)(size, u16_block_size);
+    cdr.deserialize_array(block, count);
+    narrow_u16(block, data, count);
+    data += count;
+    size -= count;
+  }
+}
+
+}  // namespace rmw_fastrtps_dynamic_cpp
+
 namespace eprosima
 {
 namespace fastcdr
@@ -41,24 +117,15 @@ namespace fastcdr
 inline eprosima::fastcdr::Cdr & operator<<(
   eprosima::fastcdr::Cdr & cdr, const std::u16string & u16str)
 {
-  auto ptr = u16str.c_str();
-  auto len = static_cast<uint32_t>(u16str.size());
-  cdr << len;
-  for (; len > 0; --len) {
-    cdr << static_cast<uint32_t>(*ptr++);
-  }
+  rmw_fastrtps_dynamic_cpp::serialize_u16(cdr, u16str.data(), u16str.size());
   return cdr;
 }
 
 inline eprosima::fastcdr::Cdr & operator<<(
   eprosima::fastcdr::Cdr & cdr, const rosidl_runtime_c__U16String & u16str)
 {
-  auto ptr = u16str.data;
-  auto len = static_cast<uint32_t>(u16str.size);
-  cdr << len;
-  for (; len > 0; --len) {
-    cdr << static_cast<uint32_t>(*ptr++);
-  }
+  rmw_fastrtps_dynamic_cpp::serialize_u16(
+    cdr, reinterpret_cast<const char16_t *>(u16str.data), u16str.size);
   return cdr;
 }
 
@@ -68,11 +135,7 @@ inline eprosima::fastcdr::Cdr & operator>>(
   uint32_t len;
   cdr >> len;
   u16str.resize(len);
-  for (uint32_t i = 0; i < len; ++i) {
-    uint32_t c;
-    cdr >> c;
-    u16str[i] = static_cast<char16_t>(c);
-  }
+  rmw_fastrtps_dynamic_cpp::deserialize_u16(cdr, u16str.data(), len);
 
   return cdr;
 }
@@ -85,12 +148,8 @@ inline eprosima::fastcdr::Cdr & operator>>(
   if (!rosidl_runtime_c__U16String__resize(&u16str, len)) {
     throw std::bad_alloc();
   }
-
-  for (uint32_t i = 0; i < len; ++i) {
-    uint32_t c;
-    cdr >> c;
-    u16str.data[i] = static_cast<char16_t>(c);
-  }
+  rmw_fastrtps_dynamic_cpp::deserialize_u16(
+    cdr, reinterpret_cast<char16_t *>(u16str.data), len);
 
   return cdr;
 }
@@ -38,10 +38,12 @@
 
 #include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_subscriber_info.hpp"
+#include "rmw_fastrtps_shared_cpp/local_delivery.hpp"
 #include "rmw_fastrtps_shared_cpp/names.hpp"
 #include "rmw_fastrtps_shared_cpp/namespace_prefix.hpp"
 #include "rmw_fastrtps_shared_cpp/qos.hpp"
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+#include "rmw_fastrtps_shared_cpp/shared_data_reader.hpp"
 #include "rmw_fastrtps_shared_cpp/subscription.hpp"
 #include "rmw_fastrtps_shared_cpp/utils.hpp"
 
@@ -276,65 +278,99 @@ create_subscription(
     return nullptr;
   }
 
-  eprosima::fastdds::dds::DataReaderQos original_qos = reader_qos;
-  switch (subscription_options->require_unique_network_flow_endpoints) {
-    default:
-    case RMW_UNIQUE_NETWORK_FLOW_ENDPOINTS_SYSTEM_DEFAULT:
-    case RMW_UNIQUE_NETWORK_FLOW_ENDPOINTS_NOT_REQUIRED:
-      // Unique network flow endpoints not required. We leave the decission to the XML profile.
-      break;
-
-    case RMW_UNIQUE_NETWORK_FLOW_ENDPOINTS_OPTIONALLY_REQUIRED:
-    case RMW_UNIQUE_NETWORK_FLOW_ENDPOINTS_STRICTLY_REQUIRED:
-      // Ensure we request unique network flow endpoints
-      if (nullptr ==
-        PropertyPolicyHelper::find_property(
-          reader_qos.properties(),
-          "fastdds.unique_network_flows"))
-      {
-        reader_qos.properties().properties().emplace_back("fastdds.unique_network_flows", "");
-      }
-      break;
+  if (participant_info->data_sharing_for_plain_types && info->type_support_->is_plain()) {
+    enable_data_sharing(reader_qos);
+  }
+
+  // Subscriptions match publishers using XCDR2 as well as those using XCDR1
+  if (!participant_info->leave_middleware_default_qos && !info->type_support_->is_plain() &&
+    rmw_fastrtps_shared_cpp::is_xcdr2_interoperable(type_supports))
+  {
+    enable_xcdr2(reader_qos);
   }
 
-  // Creates DataReader (with subscriber name to not change name policy)
-  info->data_reader_ = subscriber->create_datareader(
-    des_topic,
-    reader_qos,
-    info->data_reader_listener_,
-    eprosima::fastdds::dds::StatusMask::subscription_matched());
-  if (!info->data_reader_ &&
-    (RMW_UNIQUE_NETWORK_FLOW_ENDPOINTS_OPTIONALLY_REQUIRED ==
-    subscription_options->require_unique_network_flow_endpoints))
+  if (participant_info->share_data_readers &&
+    rmw_fastrtps_shared_cpp::can_share_datareader(subscription_options))
   {
+    info->subscriber_ = subscriber;
+    info->datareader_qos_ = reader_qos;
+
+    // Also creates the RMW GID
+    if (!rmw_fastrtps_shared_cpp::attach_to_shared_datareader(
+        eprosima_fastrtps_identifier, participant_info, info, subscription_options))
+    {
+      RMW_SET_ERROR_MSG("create_subscription() could not attach to shared data reader");
+      return nullptr;
+    }
+  } else {
+    eprosima::fastdds::dds::DataReaderQos original_qos = reader_qos;
+    switch (subscription_options->require_unique_network_flow_endpoints) {
+      default:
+      case RMW_UNIQUE_NETWORK_FLOW_ENDPOINTS_SYSTEM_DEFAULT:
+      case RMW_UNIQUE_NETWORK_FLOW_ENDPOINTS_NOT_REQUIRED:
+        // Unique network flow endpoints not required. We leave the decission to the XML profile.
+        break;
+
+      case RMW_UNIQUE_NETWORK_FLOW_ENDPOINTS_OPTIONALLY_REQUIRED:
+      case RMW_UNIQUE_NETWORK_FLOW_ENDPOINTS_STRICTLY_REQUIRED:
+        // Ensure we request unique network flow endpoints
+        if (nullptr ==
+          PropertyPolicyHelper::find_property(
+            reader_qos.properties(),
+            "fastdds.unique_network_flows"))
+        {
+          reader_qos.properties().properties().emplace_back("fastdds.unique_network_flows", "");
+        }
+        break;
+    }
+
+    // Creates DataReader (with subscriber name to not change name policy)
     info->data_reader_ = subscriber->create_datareader(
       des_topic,
-      original_qos,
+      reader_qos,
       info->data_reader_listener_,
       eprosima::fastdds::dds::StatusMask::subscription_matched());
-  }
+    if (!info->data_reader_ &&
+      (RMW_UNIQUE_NETWORK_FLOW_ENDPOINTS_OPTIONALLY_REQUIRED ==
+      subscription_options->require_unique_network_flow_endpoints))
+    {
+      info->data_reader_ = subscriber->create_datareader(
+        des_topic,
+        original_qos,
+        info->data_reader_listener_,
+        eprosima::fastdds::dds::StatusMask::subscription_matched());
+    }
 
-  if (!info->data_reader_) {
-    RMW_SET_ERROR_MSG("create_subscription() could not create data reader");
-    return nullptr;
-  }
+    if (!info->data_reader_) {
+      RMW_SET_ERROR_MSG("create_subscription() could not create data reader");
+      return nullptr;
+    }
+
+    // Initialize DataReader's StatusCondition to be notified when new data is available
+    info->data_reader_->get_statuscondition().set_enabled_statuses(
+      eprosima::fastdds::dds::StatusMask::data_available());
+
+    if (participant_info->track_data_readiness) {
+      info->data_readiness_.enable(info->data_reader_, info->data_reader_listener_);
+    }
 
-  // Initialize DataReader's StatusCondition to be notified when new data is available
-  info->data_reader_->get_statuscondition().set_enabled_statuses(
-    eprosima::fastdds::dds::StatusMask::data_available());
+    /////
+    // Create RMW GID
+    info->subscription_gid_ = rmw_fastrtps_shared_cpp::create_rmw_gid(
+      eprosima_fastrtps_identifier, info->data_reader_->guid());
+  }
 
   // lambda to delete datareader
   auto cleanup_datareader = rcpputils::make_scope_exit(
-    [subscriber, info]()
+    [subscriber, participant_info, info]()
     {
-      subscriber->delete_datareader(info->data_reader_);
+      if (info->shared_reader_) {
+        rmw_fastrtps_shared_cpp::detach_from_shared_datareader(participant_info, info);
+      } else {
+        subscriber->delete_datareader(info->data_reader_);
+      }
     });
 
-  /////
-  // Create RMW GID
-  info->subscription_gid_ = rmw_fastrtps_shared_cpp::create_rmw_gid(
-    eprosima_fastrtps_identifier, info->data_reader_->guid());
-
   rmw_subscription_t * rmw_subscription = rmw_subscription_allocate();
   if (!rmw_subscription) {
     RMW_SET_ERROR_MSG("create_subscription() failed to allocate subscription");
@@ -359,6 +395,9 @@ create_subscription(
   memcpy(const_cast<char *>(rmw_subscription->topic_name), topic_name, strlen(topic_name) + 1);
 
   rmw_subscription->options = *subscription_options;
+  if (participant_info->local_delivery_) {
+    participant_info->local_delivery_->add_subscription(info, subscription_options);
+  }
   rmw_fastrtps_shared_cpp::__init_subscription_for_loans(rmw_subscription);
   // TODO(iuhilnehc-ynos): update after rmw_fastrtps_cpp is confirmed
   rmw_subscription->is_cft_enabled = false;
@@ -0,0 +1,183 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "benchmark/benchmark.h"
+
+#include "rcutils/allocator.h"
+
+#include "rmw/error_handling.h"
+#include "rmw/rmw.h"
+#include "rmw/serialized_message.h"
+
+#include "rosidl_typesupport_cpp/message_type_support.hpp"
+
+#include "test_msgs/msg/arrays.hpp"
+#include "test_msgs/msg/basic_types.hpp"
+#include "test_msgs/msg/nested.hpp"
+#include "test_msgs/msg/strings.hpp"
+#include "test_msgs/msg/unbounded_sequences.hpp"
+#include "test_msgs/msg/w_strings.hpp"
+
+// Cases named as in the benchmarks of the other type support package, to compare them
+
+namespace
+{
+
+template<typename MessageT>
+MessageT make_message()
+{
+  return MessageT();
+}
+
+template<>
+test_msgs::msg::UnboundedSequences make_message<test_msgs::msg::UnboundedSequences>()
+{
+  test_msgs::msg::UnboundedSequences msg;
+  msg.float64_values.assign(1000u, 1.5);
+  msg.int32_values.assign(1000u, -7);
+  msg.string_values.assign(100u, "value");
+  return msg;
+}
+
+/// Serialized message for the lifetime of a benchmark.
+class SerializedMessage
+{
+public:
+  explicit SerializedMessage(benchmark::State & state)
+  {
+    rcutils_allocator_t allocator = rcutils_get_default_allocator();
+    if (RMW_RET_OK != rmw_serialized_message_init(&message, 0u, &allocator)) {
+      state.SkipWithError(rmw_get_error_string().str);
+      rmw_reset_error();
+    }
+  }
+
+  ~SerializedMessage()
+  {
+    rmw_serialized_message_fini(&message);
+  }
+
+  rmw_serialized_message_t message{rmw_get_zero_initialized_serialized_message()};
+};
+
+}  // namespace
+
+template<typename MessageT>
+static void BM_serialize(benchmark::State & state)
+{
+  const rosidl_message_type_support_t * ts =
+    rosidl_typesupport_cpp::get_message_type_support_handle<MessageT>();
+  const MessageT msg = make_message<MessageT>();
+  SerializedMessage serialized(state);
+
+  for (auto _ : state) {
+    if (RMW_RET_OK != rmw_serialize(&msg, ts, &serialized.message)) {
+      state.SkipWithError(rmw_get_error_string().str);
+      rmw_reset_error();
+      break;
+    }
+    benchmark::DoNotOptimize(serialized.message.buffer);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(
+    static_cast<int64_t>(state.iterations()) *
+    static_cast<int64_t>(serialized.message.buffer_length));
+}
+BENCHMARK_TEMPLATE(BM_serialize, test_msgs::msg::BasicTypes);
+BENCHMARK_TEMPLATE(BM_serialize, test_msgs::msg::Arrays);
+BENCHMARK_TEMPLATE(BM_serialize, test_msgs::msg::Nested);
+BENCHMARK_TEMPLATE(BM_serialize, test_msgs::msg::Strings);
+BENCHMARK_TEMPLATE(BM_serialize, test_msgs::msg::UnboundedSequences);
+
+template<typename MessageT>
+static void BM_deserialize(benchmark::State & state)
+{
+  const rosidl_message_type_support_t * ts =
+    rosidl_typesupport_cpp::get_message_type_support_handle<MessageT>();
+  const MessageT input = make_message<MessageT>();
+  SerializedMessage serialized(state);
+  if (RMW_RET_OK != rmw_serialize(&input, ts, &serialized.message)) {
+    state.SkipWithError(rmw_get_error_string().str);
+    rmw_reset_error();
+    return;
+  }
+  MessageT msg;
+
+  for (auto _ : state) {
+    if (RMW_RET_OK != rmw_deserialize(&serialized.message, ts, &msg)) {
+      state.SkipWithError(rmw_get_error_string().str);
+      rmw_reset_error();
+      break;
+    }
+    benchmark::DoNotOptimize(msg);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(
+    static_cast<int64_t>(state.iterations()) *
+    static_cast<int64_t>(serialized.message.buffer_length));
+}
+BENCHMARK_TEMPLATE(BM_deserialize, test_msgs::msg::BasicTypes);
+BENCHMARK_TEMPLATE(BM_deserialize, test_msgs::msg::Arrays);
+BENCHMARK_TEMPLATE(BM_deserialize, test_msgs::msg::Nested);
+BENCHMARK_TEMPLATE(BM_deserialize, test_msgs::msg::Strings);
+BENCHMARK_TEMPLATE(BM_deserialize, test_msgs::msg::UnboundedSequences);
+
+// Wide strings of every length given, widened and narrowed in blocks
+static void BM_serialize_wstring(benchmark::State & state)
+{
+  const rosidl_message_type_support_t * ts =
+    rosidl_typesupport_cpp::get_message_type_support_handle<test_msgs::msg::WStrings>();
+  test_msgs::msg::WStrings msg;
+  msg.wstring_value.assign(static_cast<size_t>(state.range(0)), u'\u00e9');
+  SerializedMessage serialized(state);
+
+  for (auto _ : state) {
+    if (RMW_RET_OK != rmw_serialize(&msg, ts, &serialized.message)) {
+      state.SkipWithError(rmw_get_error_string().str);
+      rmw_reset_error();
+      break;
+    }
+    benchmark::DoNotOptimize(serialized.message.buffer);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_serialize_wstring)->Arg(8)->Arg(64)->Arg(300)->Arg(4096);
+
+static void BM_deserialize_wstring(benchmark::State & state)
+{
+  const rosidl_message_type_support_t * ts =
+    rosidl_typesupport_cpp::get_message_type_support_handle<test_msgs::msg::WStrings>();
+  test_msgs::msg::WStrings input;
+  input.wstring_value.assign(static_cast<size_t>(state.range(0)), u'\u00e9');
+  SerializedMessage serialized(state);
+  if (RMW_RET_OK != rmw_serialize(&input, ts, &serialized.message)) {
+    state.SkipWithError(rmw_get_error_string().str);
+    rmw_reset_error();
+    return;
+  }
+  test_msgs::msg::WStrings msg;
+
+  for (auto _ : state) {
+    if (RMW_RET_OK != rmw_deserialize(&serialized.message, ts, &msg)) {
+      state.SkipWithError(rmw_get_error_string().str);
+      rmw_reset_error();
+      break;
+    }
+    benchmark::DoNotOptimize(msg);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_deserialize_wstring)->Arg(8)->Arg(64)->Arg(300)->Arg(4096);
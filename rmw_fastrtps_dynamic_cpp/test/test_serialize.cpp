@@ -0,0 +1,257 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "osrf_testing_tools_cpp/scope_exit.hpp"
+
+#include "rcutils/allocator.h"
+
+#include "rmw/error_handling.h"
+#include "rmw/rmw.h"
+#include "rmw/serialized_message.h"
+
+#include "rosidl_runtime_c/string_functions.h"
+#include "rosidl_runtime_c/u16string_functions.h"
+#include "rosidl_typesupport_cpp/message_type_support.hpp"
+
+#include "test_msgs/msg/arrays.h"
+#include "test_msgs/msg/strings.h"
+#include "test_msgs/msg/strings.hpp"
+#include "test_msgs/msg/unbounded_sequences.h"
+#include "test_msgs/msg/w_strings.h"
+#include "test_msgs/msg/w_strings.hpp"
+
+namespace
+{
+
+// Characters of every magnitude, so that narrowing cannot saturate unnoticed
+std::u16string make_u16string(size_t size)
+{
+  std::u16string u16str(size, u'\0');
+  for (size_t i = 0u; i < size; ++i) {
+    u16str[i] = static_cast<char16_t>((0x41u + i * 0x1f3du) & 0xffffu);
+  }
+  return u16str;
+}
+
+}  // namespace
+
+class TestSerialize : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    rcutils_allocator_t allocator = rcutils_get_default_allocator();
+    ASSERT_EQ(RMW_RET_OK, rmw_serialized_message_init(&serialized_message, 0u, &allocator));
+  }
+
+  void TearDown() override
+  {
+    EXPECT_EQ(RMW_RET_OK, rmw_serialized_message_fini(&serialized_message));
+  }
+
+  rmw_serialized_message_t serialized_message{rmw_get_zero_initialized_serialized_message()};
+};
+
+TEST_F(TestSerialize, c_strings_round_trip) {
+  const rosidl_message_type_support_t * ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Strings);
+  const std::string long_string(300u, 'x');
+
+  test_msgs__msg__Strings input;
+  ASSERT_TRUE(test_msgs__msg__Strings__init(&input));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__msg__Strings__fini(&input);
+  });
+  ASSERT_TRUE(rosidl_runtime_c__String__assign(&input.string_value, long_string.c_str()));
+  ASSERT_TRUE(rosidl_runtime_c__String__assign(&input.string_value_default1, ""));
+  ASSERT_TRUE(rosidl_runtime_c__String__assign(&input.bounded_string_value, "bounded"));
+
+  ASSERT_EQ(RMW_RET_OK, rmw_serialize(&input, ts, &serialized_message)) <<
+    rmw_get_error_string().str;
+
+  test_msgs__msg__Strings output;
+  ASSERT_TRUE(test_msgs__msg__Strings__init(&output));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__msg__Strings__fini(&output);
+  });
+  ASSERT_EQ(RMW_RET_OK, rmw_deserialize(&serialized_message, ts, &output)) <<
+    rmw_get_error_string().str;
+  EXPECT_TRUE(test_msgs__msg__Strings__are_equal(&input, &output));
+  EXPECT_EQ(long_string.size(), output.string_value.size);
+  EXPECT_EQ(0u, output.string_value_default1.size);
+
+  // C strings are written as std::string are
+  test_msgs::msg::Strings cpp_input;
+  cpp_input.string_value = long_string;
+  cpp_input.string_value_default1 = "";
+  cpp_input.bounded_string_value = "bounded";
+  rmw_serialized_message_t cpp_serialized_message = rmw_get_zero_initialized_serialized_message();
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  ASSERT_EQ(RMW_RET_OK, rmw_serialized_message_init(&cpp_serialized_message, 0u, &allocator));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RMW_RET_OK, rmw_serialized_message_fini(&cpp_serialized_message));
+  });
+  ASSERT_EQ(
+    RMW_RET_OK,
+    rmw_serialize(
+      &cpp_input,
+      rosidl_typesupport_cpp::get_message_type_support_handle<test_msgs::msg::Strings>(),
+      &cpp_serialized_message)) << rmw_get_error_string().str;
+  ASSERT_EQ(cpp_serialized_message.buffer_length, serialized_message.buffer_length);
+  EXPECT_EQ(
+    0, std::memcmp(
+      cpp_serialized_message.buffer, serialized_message.buffer, serialized_message.buffer_length));
+}
+
+TEST_F(TestSerialize, c_string_arrays_round_trip) {
+  const rosidl_message_type_support_t * ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, Arrays);
+
+  test_msgs__msg__Arrays input;
+  ASSERT_TRUE(test_msgs__msg__Arrays__init(&input));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__msg__Arrays__fini(&input);
+  });
+  ASSERT_TRUE(rosidl_runtime_c__String__assign(&input.string_values[0], ""));
+  ASSERT_TRUE(rosidl_runtime_c__String__assign(&input.string_values[1], "key"));
+  ASSERT_TRUE(rosidl_runtime_c__String__assign(&input.string_values[2], "value"));
+
+  ASSERT_EQ(RMW_RET_OK, rmw_serialize(&input, ts, &serialized_message)) <<
+    rmw_get_error_string().str;
+
+  test_msgs__msg__Arrays output;
+  ASSERT_TRUE(test_msgs__msg__Arrays__init(&output));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__msg__Arrays__fini(&output);
+  });
+  ASSERT_EQ(RMW_RET_OK, rmw_deserialize(&serialized_message, ts, &output)) <<
+    rmw_get_error_string().str;
+  EXPECT_TRUE(test_msgs__msg__Arrays__are_equal(&input, &output));
+}
+
+TEST_F(TestSerialize, c_string_sequences_round_trip) {
+  const rosidl_message_type_support_t * ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, UnboundedSequences);
+
+  test_msgs__msg__UnboundedSequences input;
+  ASSERT_TRUE(test_msgs__msg__UnboundedSequences__init(&input));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__msg__UnboundedSequences__fini(&input);
+  });
+  rosidl_runtime_c__String__Sequence__fini(&input.string_values);
+  ASSERT_TRUE(rosidl_runtime_c__String__Sequence__init(&input.string_values, 3u));
+  ASSERT_TRUE(rosidl_runtime_c__String__assign(&input.string_values.data[0], "level"));
+  ASSERT_TRUE(rosidl_runtime_c__String__assign(&input.string_values.data[1], ""));
+  ASSERT_TRUE(rosidl_runtime_c__String__assign(&input.string_values.data[2], "message"));
+  // Left empty
+  rosidl_runtime_c__String__Sequence__fini(&input.string_values_default);
+  ASSERT_TRUE(rosidl_runtime_c__String__Sequence__init(&input.string_values_default, 0u));
+
+  ASSERT_EQ(RMW_RET_OK, rmw_serialize(&input, ts, &serialized_message)) <<
+    rmw_get_error_string().str;
+
+  test_msgs__msg__UnboundedSequences output;
+  ASSERT_TRUE(test_msgs__msg__UnboundedSequences__init(&output));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    test_msgs__msg__UnboundedSequences__fini(&output);
+  });
+  ASSERT_EQ(RMW_RET_OK, rmw_deserialize(&serialized_message, ts, &output)) <<
+    rmw_get_error_string().str;
+  EXPECT_TRUE(test_msgs__msg__UnboundedSequences__are_equal(&input, &output));
+  EXPECT_EQ(3u, output.string_values.size);
+  EXPECT_EQ(0u, output.string_values_default.size);
+}
+
+TEST_F(TestSerialize, wstrings_round_trip) {
+  const rosidl_message_type_support_t * c_ts =
+    ROSIDL_GET_MSG_TYPE_SUPPORT(test_msgs, msg, WStrings);
+  const rosidl_message_type_support_t * cpp_ts =
+    rosidl_typesupport_cpp::get_message_type_support_handle<test_msgs::msg::WStrings>();
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+
+  // Around the 8 characters converted at once, and across several blocks
+  for (size_t size : {0u, 7u, 8u, 9u, 300u}) {
+    SCOPED_TRACE(size);
+    const std::u16string u16str = make_u16string(size);
+
+    test_msgs::msg::WStrings cpp_input;
+    cpp_input.wstring_value = u16str;
+    ASSERT_EQ(RMW_RET_OK, rmw_serialize(&cpp_input, cpp_ts, &serialized_message)) <<
+      rmw_get_error_string().str;
+
+    // Each character is written as 32 bits, after the encapsulation and the length
+    ASSERT_LE(8u + 4u * size, serialized_message.buffer_length);
+    uint32_t value = 0u;
+    std::memcpy(&value, serialized_message.buffer + 4u, sizeof(value));
+    EXPECT_EQ(size, value);
+    for (size_t i = 0u; i < size; ++i) {
+      std::memcpy(&value, serialized_message.buffer + 8u + 4u * i, sizeof(value));
+      ASSERT_EQ(static_cast<uint32_t>(u16str[i]), value) << "at " << i;
+    }
+
+    test_msgs::msg::WStrings cpp_output;
+    ASSERT_EQ(RMW_RET_OK, rmw_deserialize(&serialized_message, cpp_ts, &cpp_output)) <<
+      rmw_get_error_string().str;
+    EXPECT_EQ(cpp_input, cpp_output);
+
+    test_msgs__msg__WStrings c_input;
+    ASSERT_TRUE(test_msgs__msg__WStrings__init(&c_input));
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      test_msgs__msg__WStrings__fini(&c_input);
+    });
+    ASSERT_TRUE(
+      rosidl_runtime_c__U16String__assignn(
+        &c_input.wstring_value, reinterpret_cast<const uint16_t *>(u16str.data()), size));
+
+    // Both type supports write the same bytes
+    rmw_serialized_message_t c_serialized_message = rmw_get_zero_initialized_serialized_message();
+    ASSERT_EQ(RMW_RET_OK, rmw_serialized_message_init(&c_serialized_message, 0u, &allocator));
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      EXPECT_EQ(RMW_RET_OK, rmw_serialized_message_fini(&c_serialized_message));
+    });
+    ASSERT_EQ(RMW_RET_OK, rmw_serialize(&c_input, c_ts, &c_serialized_message)) <<
+      rmw_get_error_string().str;
+    ASSERT_EQ(serialized_message.buffer_length, c_serialized_message.buffer_length);
+    EXPECT_EQ(
+      0, std::memcmp(
+        serialized_message.buffer, c_serialized_message.buffer,
+        c_serialized_message.buffer_length));
+
+    test_msgs__msg__WStrings c_output;
+    ASSERT_TRUE(test_msgs__msg__WStrings__init(&c_output));
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      test_msgs__msg__WStrings__fini(&c_output);
+    });
+    ASSERT_EQ(RMW_RET_OK, rmw_deserialize(&c_serialized_message, c_ts, &c_output)) <<
+      rmw_get_error_string().str;
+    EXPECT_TRUE(test_msgs__msg__WStrings__are_equal(&c_input, &c_output));
+    EXPECT_EQ(size, c_output.wstring_value.size);
+  }
+}
@@ -39,7 +39,9 @@ enum SerializedDataType
 {
   FASTRTPS_SERIALIZED_DATA_TYPE_CDR_BUFFER,
   FASTRTPS_SERIALIZED_DATA_TYPE_DYNAMIC_MESSAGE,
-  FASTRTPS_SERIALIZED_DATA_TYPE_ROS_MESSAGE
+  FASTRTPS_SERIALIZED_DATA_TYPE_ROS_MESSAGE,
+  // data is a rmw_serialized_message_t, resized as needed when deserializing into it
+  FASTRTPS_SERIALIZED_DATA_TYPE_SERIALIZED_MESSAGE
 };
 
 // Publishers write method will receive a pointer to this struct
@@ -48,6 +50,13 @@ struct SerializedData
   SerializedDataType type;  // The type of the next field
   void * data;
   const void * impl;  // RMW implementation specific data
+  // Serialized size to report for a ROS message, or 0 to compute it from the message.
+  // Serialization fails when the message does not fit in it.
+  size_t size_hint {0u};
+  // Set by TypeSupport::serialize when a ROS message did not fit in its payload
+  bool size_exceeded {false};
+  // Set by TypeSupport::serialize to the length of the serialized ROS message
+  size_t serialized_size {0u};
 };
 
 class TypeSupport : public eprosima::fastdds::dds::TopicDataType
@@ -74,6 +83,12 @@ public:
   RMW_FASTRTPS_SHARED_CPP_PUBLIC
   bool serialize(void * data, eprosima::fastrtps::rtps::SerializedPayload_t * payload) override;
 
+  /// Serialize ROS messages with XCDR1, or with XCDR2 when it is the given data representation.
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  bool serialize(
+    void * data, eprosima::fastrtps::rtps::SerializedPayload_t * payload,
+    eprosima::fastdds::dds::DataRepresentationId_t data_representation) override;
+
   RMW_FASTRTPS_SHARED_CPP_PUBLIC
   bool deserialize(eprosima::fastrtps::rtps::SerializedPayload_t * payload, void * data) override;
 
@@ -110,6 +125,13 @@ public:
     return is_plain_ && rep == eprosima::fastdds::dds::XCDR_DATA_REPRESENTATION;
   }
 
+  /// Size of the memory representation of a message, only meaningful when is_plain().
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  inline size_t get_plain_size() const
+  {
+    return plain_size_;
+  }
+
   RMW_FASTRTPS_SHARED_CPP_PUBLIC
   virtual ~TypeSupport() {}
 
@@ -119,6 +141,7 @@ protected:
 
   bool max_size_bound_;
   bool is_plain_;
+  size_t plain_size_;
 };
 
 RMW_FASTRTPS_SHARED_CPP_PUBLIC
@@ -126,6 +149,24 @@ bool register_type_object(
   const rosidl_message_type_support_t * type_supports,
   const std::string & type_name);
 
+/// Whether every type support serializes messages of a type to the same XCDR2 data.
+/**
+ * The type supports only agree on the alignment of XCDR2, so the type must have no wide strings,
+ * nor arrays or sequences of strings or messages, for which some of them write headers.
+ * Returns false when the introspection type support of the type cannot be found.
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+bool is_xcdr2_interoperable(const rosidl_message_type_support_t * type_supports);
+
+/// Whether messages of a type are laid out in memory exactly as XCDR1 serializes them.
+/**
+ * The offset of every member, nested ones included, is checked against its position in the
+ * serialized data, which has to end at `plain_size`.
+ * Returns false when the introspection type support of the type cannot be found.
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+bool has_plain_layout(const rosidl_message_type_support_t * type_supports, size_t plain_size);
+
 }  // namespace rmw_fastrtps_shared_cpp
 
 #endif  // RMW_FASTRTPS_SHARED_CPP__TYPESUPPORT_HPP_
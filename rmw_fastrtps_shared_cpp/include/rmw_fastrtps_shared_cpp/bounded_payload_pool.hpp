@@ -0,0 +1,101 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__BOUNDED_PAYLOAD_POOL_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__BOUNDED_PAYLOAD_POOL_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "fastdds/dds/publisher/qos/DataWriterQos.hpp"
+
+#include "fastdds/rtps/common/CacheChange.h"
+#include "fastdds/rtps/common/SerializedPayload.h"
+#include "fastdds/rtps/history/IPayloadPool.h"
+
+#include "rcpputils/thread_safety_annotations.hpp"
+
+#include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
+#include "rmw_fastrtps_shared_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Payloads of the DataWriter history of a bounded type, all of its maximum serialized size.
+/**
+ * Payloads released by the history are kept and handed out again, so that once as many
+ * payloads as the history holds at a time exist, publishing never allocates one.
+ * Requests bigger than the maximum size, which only serialized messages can make, get a
+ * payload of their own which is freed when released.
+ */
+class BoundedPayloadPool final : public eprosima::fastrtps::rtps::IPayloadPool
+{
+public:
+  /// \param[in] payload_size maximum serialized size of the type, encapsulation included.
+  /// \param[in] initial_payloads number of payloads allocated up front.
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  BoundedPayloadPool(uint32_t payload_size, size_t initial_payloads);
+
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  ~BoundedPayloadPool() override;
+
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  bool get_payload(
+    uint32_t size,
+    eprosima::fastrtps::rtps::CacheChange_t & cache_change) override;
+
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  bool get_payload(
+    eprosima::fastrtps::rtps::SerializedPayload_t & data,
+    eprosima::fastrtps::rtps::IPayloadPool * & data_owner,
+    eprosima::fastrtps::rtps::CacheChange_t & cache_change) override;
+
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  bool release_payload(eprosima::fastrtps::rtps::CacheChange_t & cache_change) override;
+
+  uint32_t get_payload_size() const
+  {
+    return payload_size_;
+  }
+
+private:
+  // Hand out a pooled payload, or one of exactly `size` bytes when it is bigger
+  bool assign_payload(uint32_t size, eprosima::fastrtps::rtps::CacheChange_t & cache_change);
+
+  const uint32_t payload_size_;
+
+  std::mutex mutex_;
+  // Count of the pooled payloads, free or not, which free_payloads_ always has room for
+  size_t payload_count_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
+  std::vector<eprosima::fastrtps::rtps::octet *> free_payloads_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
+};
+
+/// Create the payload pool of a DataWriter, or return nullptr when it should use its own.
+/**
+ * Only bounded types which are not plain get one.
+ * Plain types keep the pool of the DataWriter, which they loan messages from, and so do
+ * DataWriters using data-sharing.
+ * The pool starts with as many payloads as the history holds at a time.
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+std::shared_ptr<BoundedPayloadPool>
+create_bounded_payload_pool(
+  const TypeSupport & type_support,
+  const eprosima::fastdds::dds::DataWriterQos & writer_qos);
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__BOUNDED_PAYLOAD_POOL_HPP_
@@ -0,0 +1,80 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__CLIENT_RESPONSE_FILTER_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__CLIENT_RESPONSE_FILTER_HPP_
+
+#include "fastdds/dds/domain/DomainParticipant.hpp"
+#include "fastdds/dds/publisher/qos/DataWriterQos.hpp"
+#include "fastdds/dds/topic/ContentFilteredTopic.hpp"
+#include "fastdds/dds/topic/Topic.hpp"
+
+#include "rmw_fastrtps_shared_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/**
+* Register the factory of the client response filter on a participant.
+*
+* The filter only lets through the responses addressed to the client reading them.
+* It has to be registered on every participant, so that service response writers can evaluate
+* it on behalf of the remote clients and skip sending them the responses of other clients.
+*
+* \param[in]  participant  DomainParticipant where the factory will be registered.
+*
+* \return true when the factory was registered
+* \return false when the factory could not be registered
+*/
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+bool
+register_client_response_filter_factory(
+  eprosima::fastdds::dds::DomainParticipant * participant);
+
+/**
+* Create a content filtered topic for the response reader of a client.
+*
+* Writers not able to evaluate the filter (e.g. on participants from other vendors) send every
+* response, which are then filtered by the response reader itself.
+*
+* \param[in]  participant             DomainParticipant where the topic will be created.
+* \param[in]  response_topic          Response topic of the client.
+* \param[out] content_filtered_topic  Will hold the pointer to the content filtered topic.
+*
+* \return true when the content filtered topic was created
+* \return false when the content filtered topic could not be created
+*/
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+bool
+create_client_response_filtered_topic(
+  eprosima::fastdds::dds::DomainParticipant * participant,
+  eprosima::fastdds::dds::Topic * response_topic,
+  eprosima::fastdds::dds::ContentFilteredTopic ** content_filtered_topic);
+
+/**
+* Let a service response writer evaluate the filter of every client it can be matched with.
+*
+* Fast DDS only keeps the filters of a limited number of readers per writer, 32 by default, and
+* sends every response to the clients past that number.
+* The limit is raised up to the maximum of matched readers of the writer, and is never lowered.
+*
+* \param[inout]  writer_qos  QoS of the response DataWriter.
+*/
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+void
+allow_client_response_filters(eprosima::fastdds::dds::DataWriterQos & writer_qos);
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__CLIENT_RESPONSE_FILTER_HPP_
@@ -15,6 +15,8 @@
 #ifndef RMW_FASTRTPS_SHARED_CPP__CUSTOM_CLIENT_INFO_HPP_
 #define RMW_FASTRTPS_SHARED_CPP__CUSTOM_CLIENT_INFO_HPP_
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <set>
@@ -31,6 +33,7 @@
 #include "fastdds/dds/subscriber/DataReaderListener.hpp"
 #include "fastdds/dds/subscriber/SampleInfo.hpp"
 #include "fastdds/dds/subscriber/qos/DataReaderQos.hpp"
+#include "fastdds/dds/topic/ContentFilteredTopic.hpp"
 #include "fastdds/dds/topic/TypeSupport.hpp"
 
 #include "fastdds/rtps/common/Guid.h"
@@ -41,6 +44,7 @@
 
 #include "rmw/event_callback_type.h"
 
+#include "rmw_fastrtps_shared_cpp/data_readiness.hpp"
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
 
 class ClientListener;
@@ -60,6 +64,8 @@ typedef struct CustomClientInfo
 
   eprosima::fastdds::dds::Topic * request_topic_{nullptr};
   eprosima::fastdds::dds::Topic * response_topic_{nullptr};
+  // Only lets through the responses to this client, see client_response_filter.hpp
+  eprosima::fastdds::dds::ContentFilteredTopic * response_filtered_topic_{nullptr};
 
   ClientListener * listener_{nullptr};
   eprosima::fastrtps::rtps::GUID_t writer_guid_;
@@ -69,12 +75,18 @@ typedef struct CustomClientInfo
   ClientPubListener * pub_listener_{nullptr};
   std::atomic_size_t response_subscriber_matched_count_;
   std::atomic_size_t request_publisher_matched_count_;
+  rmw_fastrtps_shared_cpp::DataReadiness data_readiness_;
+
+  // Cached service availability, see __rmw_service_server_is_available.
+  // Whether the graph had as many request readers as response writers, with the graph change
+  // count it was checked at, as ((graph_change_count + 1) << 1) | available.
+  // Zero means the graph was never checked.
+  std::atomic<uint64_t> graph_availability_{0u};
 } CustomClientInfo;
 
 typedef struct CustomClientResponse
 {
   eprosima::fastrtps::rtps::SampleIdentity sample_identity_;
-  std::unique_ptr<eprosima::fastcdr::FastBuffer> buffer_;
 } CustomClientResponse;
 
 class ClientListener : public eprosima::fastdds::dds::DataReaderListener
@@ -90,6 +102,8 @@ public:
   on_data_available(
     eprosima::fastdds::dds::DataReader *)
   {
+    info_->data_readiness_.mark_ready();
+
     std::unique_lock<std::mutex> lock_mutex(on_new_response_m_);
 
     if (on_new_response_cb_) {
@@ -149,7 +163,9 @@ public:
       std::lock_guard<std::mutex> lock_mutex(on_new_response_m_);
 
       eprosima::fastdds::dds::StatusMask status_mask = info_->response_reader_->get_status_mask();
-      status_mask &= ~eprosima::fastdds::dds::StatusMask::data_available();
+      if (!info_->data_readiness_.is_enabled()) {
+        status_mask &= ~eprosima::fastdds::dds::StatusMask::data_available();
+      }
       info_->response_reader_->set_listener(this, status_mask);
 
       user_data_ = nullptr;
@@ -15,6 +15,7 @@
 #ifndef RMW_FASTRTPS_SHARED_CPP__CUSTOM_PARTICIPANT_INFO_HPP_
 #define RMW_FASTRTPS_SHARED_CPP__CUSTOM_PARTICIPANT_INFO_HPP_
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -52,6 +53,12 @@ using rmw_dds_common::operator<<;
 
 class ParticipantListener;
 
+namespace rmw_fastrtps_shared_cpp
+{
+class LocalDelivery;
+class SharedDataReader;
+}  // namespace rmw_fastrtps_shared_cpp
+
 enum class publishing_mode_t
 {
   ASYNCHRONOUS,  // Asynchronous publishing mode
@@ -121,6 +128,38 @@ typedef struct CustomParticipantInfo
   bool leave_middleware_default_qos;
   publishing_mode_t publishing_mode;
 
+  // Flag to establish if the listeners of DataReaders keep track of the
+  // arrival of new data, so that rmw_wait only queries the readers
+  // that were notified.
+  bool track_data_readiness{false};
+
+  // Flag to establish if data-sharing delivery is enabled on the DataWriters
+  // and DataReaders of topics whose type is plain.
+  bool data_sharing_for_plain_types{false};
+
+  // Flag to establish if the DataWriters of topics whose type is not plain,
+  // and is interoperable over XCDR2, serialize with XCDR2.
+  bool xcdr2_for_non_plain_types{false};
+
+  // Flag to establish if services queue the responses to clients whose response
+  // reader is not matched yet, instead of waiting for the match when sending.
+  bool defer_service_responses{false};
+
+  // Flag to establish if subscriptions to the same topic with the same QoS
+  // share a single DataReader, which fans out the samples to each of them.
+  bool share_data_readers{false};
+
+  // DataReaders shared by subscriptions, protected by entity_creation_mutex_.
+  std::vector<rmw_fastrtps_shared_cpp::SharedDataReader *> shared_data_readers_;
+
+  // Set when publishers hand the messages of plain types straight to the subscriptions
+  // of this participant, skipping serialization.
+  std::shared_ptr<rmw_fastrtps_shared_cpp::LocalDelivery> local_delivery_;
+
+  // Incremented on every change of the graph cache of the context, so that results computed
+  // from the graph can be cached until it changes.
+  std::atomic<uint64_t> graph_change_count_{0u};
+
   RMW_FASTRTPS_SHARED_CPP_PUBLIC
   eprosima::fastdds::dds::Topic * find_or_create_topic(
     const std::string & topic_name,
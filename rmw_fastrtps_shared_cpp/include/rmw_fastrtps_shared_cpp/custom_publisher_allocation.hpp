@@ -0,0 +1,38 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__CUSTOM_PUBLISHER_ALLOCATION_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__CUSTOM_PUBLISHER_ALLOCATION_HPP_
+
+#include <cstddef>
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Data of a publisher allocation.
+/**
+ * The payloads themselves belong to the BoundedPayloadPool of each publisher of a bounded type,
+ * as the DataWriter has to be created with its pool.
+ * Publishing with an allocation checks that the allocation was made for a type of the same
+ * size, so that the messages fit in the payloads of the pool.
+ */
+struct CustomPublisherAllocation
+{
+  /// Serialized size of the largest message of the type, or 0 if it is unbounded.
+  size_t max_serialized_size_ {0u};
+};
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__CUSTOM_PUBLISHER_ALLOCATION_HPP_
@@ -15,6 +15,8 @@
 #ifndef RMW_FASTRTPS_SHARED_CPP__CUSTOM_PUBLISHER_INFO_HPP_
 #define RMW_FASTRTPS_SHARED_CPP__CUSTOM_PUBLISHER_INFO_HPP_
 
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <set>
 
@@ -38,6 +40,13 @@
 
 class RMWPublisherEvent;
 
+namespace rmw_fastrtps_shared_cpp
+{
+class BoundedPayloadPool;
+class LocalDelivery;
+class LocalTopic;
+}  // namespace rmw_fastrtps_shared_cpp
+
 class CustomDataWriterListener final : public eprosima::fastdds::dds::DataWriterListener
 {
 public:
@@ -86,6 +95,32 @@ typedef struct CustomPublisherInfo : public CustomEventInfo
 
   eprosima::fastdds::dds::Topic * topic_{nullptr};
 
+  // Payloads of the DataWriter history, when the type is bounded and not plain
+  std::shared_ptr<rmw_fastrtps_shared_cpp::BoundedPayloadPool> payload_pool_;
+
+  // Whether messages can be dropped without being written while no subscription is matched.
+  // Only true for VOLATILE writers, since other durabilities keep history for late joiners,
+  // which offer no deadline, since it would be missed while no message is written.
+  bool skip_write_when_unmatched_{false};
+
+  // Set when the messages are handed straight to the subscriptions of the participant
+  // to the same topic, instead of going through the DataWriter.
+  rmw_fastrtps_shared_cpp::LocalDelivery * local_delivery_{nullptr};
+  // Publishers and subscriptions of the topic, set along with local_delivery_.
+  rmw_fastrtps_shared_cpp::LocalTopic * local_topic_{nullptr};
+  // Sequence number of the last message delivered locally, guarded by local_topic_.
+  uint64_t local_sequence_number_{0u};
+
+  // Moving average of the serialized size of the messages of an unbounded type.
+  // They are serialized first into a payload sized from it, so that they are not traversed
+  // once to compute their size and once more to serialize them. Those which do not fit are
+  // sized and written again. It follows the recent sizes, so that a single large message does
+  // not make every later payload that large.
+  std::atomic<uint32_t> average_serialized_size_{0u};
+
+  // Held while writing, so that the messages of a batch are not interleaved with others
+  std::mutex write_mutex_;
+
   RMW_FASTRTPS_SHARED_CPP_PUBLIC
   EventListenerInterface *
   get_listener() const final;
@@ -141,6 +176,23 @@ public:
   RMW_FASTRTPS_SHARED_CPP_PUBLIC
   size_t subscription_count() const;
 
+  /// Return whether a subscription is matched to this publisher.
+  /**
+   * \param[in] guid The GUID of the subscription.
+   * \return true if the subscription is matched to this publisher.
+   */
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  bool is_matched(const eprosima::fastrtps::rtps::GUID_t & guid) const;
+
+  /// Return whether any subscription is matched to this publisher, without locking.
+  /**
+   * \return true if at least one subscription is matched to this publisher.
+   */
+  bool has_subscriptions() const
+  {
+    return subscription_count_.load(std::memory_order_acquire) > 0u;
+  }
+
   RMW_FASTRTPS_SHARED_CPP_PUBLIC
   void update_deadline(uint32_t total_count, uint32_t total_count_change);
 
@@ -167,6 +219,9 @@ private:
 
   mutable std::mutex subscriptions_mutex_;
 
+  // Mirrors subscriptions_.size(), to be checked on every publish without locking
+  std::atomic<size_t> subscription_count_{0u};
+
   bool deadline_changed_
   RCPPUTILS_TSA_GUARDED_BY(on_new_event_m_);
 
@@ -16,10 +16,15 @@
 #define RMW_FASTRTPS_SHARED_CPP__CUSTOM_SERVICE_INFO_HPP_
 
 #include <condition_variable>
+#include <memory>
 #include <mutex>
+#include <thread>
 #include <unordered_set>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "fastcdr/Cdr.h"
 #include "fastcdr/FastBuffer.h"
 
 #include "fastdds/dds/core/status/PublicationMatchedStatus.hpp"
@@ -35,11 +40,13 @@
 #include "fastdds/rtps/common/Guid.h"
 #include "fastdds/rtps/common/InstanceHandle.h"
 #include "fastdds/rtps/common/SampleIdentity.h"
+#include "fastdds/rtps/common/WriteParams.h"
 
 #include "rcpputils/thread_safety_annotations.hpp"
 
 #include "rmw/event_callback_type.h"
 
+#include "rmw_fastrtps_shared_cpp/data_readiness.hpp"
 #include "rmw_fastrtps_shared_cpp/guid_utils.hpp"
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
 
@@ -70,14 +77,25 @@ typedef struct CustomServiceInfo
   ServicePubListener * pub_listener_{nullptr};
 
   const char * typesupport_identifier_{nullptr};
+  rmw_fastrtps_shared_cpp::DataReadiness data_readiness_;
+
+  // Whether responses to clients whose response reader is not matched yet are queued
+  // by ServicePubListener, instead of waiting for the match when sending them.
+  bool defer_responses_{false};
 } CustomServiceInfo;
 
 typedef struct CustomServiceRequest
 {
   eprosima::fastrtps::rtps::SampleIdentity sample_identity_;
-  eprosima::fastcdr::FastBuffer * buffer_{nullptr};
 } CustomServiceRequest;
 
+// A response serialized when sent, waiting for the response reader of its client to match
+typedef struct CustomServiceDeferredResponse
+{
+  std::vector<char> buffer_;
+  eprosima::fastrtps::rtps::WriteParams wparams_;
+} CustomServiceDeferredResponse;
+
 class ServicePubListener : public eprosima::fastdds::dds::DataWriterListener
 {
   using subscriptions_set_t =
@@ -87,6 +105,21 @@ class ServicePubListener : public eprosima::fastdds::dds::DataWriterListener
     std::unordered_map<eprosima::fastrtps::rtps::GUID_t,
       eprosima::fastrtps::rtps::GUID_t,
       rmw_fastrtps_shared_cpp::hash_fastrtps_guid>;
+  using deferred_responses_map_t =
+    std::unordered_map<eprosima::fastrtps::rtps::GUID_t,
+      std::vector<CustomServiceDeferredResponse>,
+      rmw_fastrtps_shared_cpp::hash_fastrtps_guid>;
+
+  // Threads waiting for the same reader to be matched share a condition variable
+  struct subscription_waiters_t
+  {
+    std::condition_variable cv;
+    size_t count {0u};
+  };
+  using subscription_waiters_map_t =
+    std::unordered_map<eprosima::fastrtps::rtps::GUID_t,
+      std::unique_ptr<subscription_waiters_t>,
+      rmw_fastrtps_shared_cpp::hash_fastrtps_guid>;
 
 public:
   explicit ServicePubListener(
@@ -95,27 +128,43 @@ public:
     (void) info;
   }
 
+  ~ServicePubListener()
+  {
+    stop_flushing();
+  }
+
   void
   on_publication_matched(
-    eprosima::fastdds::dds::DataWriter * /* writer */,
+    eprosima::fastdds::dds::DataWriter * writer,
     const eprosima::fastdds::dds::PublicationMatchedStatus & info) final
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (info.current_count_change == 1) {
-      subscriptions_.insert(eprosima::fastrtps::rtps::iHandle2GUID(info.last_subscription_handle));
-    } else if (info.current_count_change == -1) {
-      eprosima::fastrtps::rtps::GUID_t erase_endpoint_guid =
-        eprosima::fastrtps::rtps::iHandle2GUID(info.last_subscription_handle);
-      subscriptions_.erase(erase_endpoint_guid);
-      auto endpoint = clients_endpoints_.find(erase_endpoint_guid);
-      if (endpoint != clients_endpoints_.end()) {
-        clients_endpoints_.erase(endpoint->second);
-        clients_endpoints_.erase(erase_endpoint_guid);
+    eprosima::fastrtps::rtps::GUID_t endpoint_guid =
+      eprosima::fastrtps::rtps::iHandle2GUID(info.last_subscription_handle);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (info.current_count_change == 1) {
+        subscriptions_.insert(endpoint_guid);
+        // Only wake up the threads waiting for this reader
+        auto waiters = subscription_waiters_.find(endpoint_guid);
+        if (waiters != subscription_waiters_.end()) {
+          waiters->second->cv.notify_all();
+        }
+        // Writing could block this discovery thread, so let the flushing thread do it
+        if (deferred_responses_.find(endpoint_guid) != deferred_responses_.end()) {
+          writer_ = writer;
+          readers_to_flush_.push_back(endpoint_guid);
+          flush_cv_.notify_one();
+        }
+      } else if (info.current_count_change == -1) {
+        subscriptions_.erase(endpoint_guid);
+        auto endpoint = clients_endpoints_.find(endpoint_guid);
+        if (endpoint != clients_endpoints_.end()) {
+          clients_endpoints_.erase(endpoint->second);
+          clients_endpoints_.erase(endpoint_guid);
+        }
+        deferred_responses_.erase(endpoint_guid);
       }
-    } else {
-      return;
     }
-    cv_.notify_all();
   }
 
   template<class Rep, class Period>
@@ -130,7 +179,22 @@ public:
     };
 
     std::unique_lock<std::mutex> lock(mutex_);
-    return cv_.wait_for(lock, rel_time, guid_is_present);
+    if (guid_is_present()) {
+      return true;
+    }
+
+    std::unique_ptr<subscription_waiters_t> & waiters = subscription_waiters_[guid];
+    if (!waiters) {
+      waiters.reset(new subscription_waiters_t());
+    }
+    // The entry may be rehashed while waiting, but the waiters it points to are not moved
+    subscription_waiters_t * guid_waiters = waiters.get();
+    ++guid_waiters->count;
+    bool ret = guid_waiters->cv.wait_for(lock, rel_time, guid_is_present);
+    if (0u == --guid_waiters->count) {
+      subscription_waiters_.erase(guid);
+    }
+    return ret;
   }
 
   template<class Rep, class Period>
@@ -154,12 +218,67 @@ public:
     return client_present_t::YES;
   }
 
+  /// Check whether a response to a client can be written right away when deferring responses.
+  /**
+   * \param[in] guid GUID of the response reader of the client.
+   * \return YES if the reader is matched and has no queued responses,
+   *   GONE if the client is gone,
+   *   MAYBE if the response has to be queued with defer_response().
+   */
+  client_present_t
+  check_for_deferred_subscription(
+    const eprosima::fastrtps::rtps::GUID_t & guid)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return deferred_client_state(guid);
+  }
+
+  /// Queue a response until the response reader of its client is matched.
+  /**
+   * \param[in] guid GUID of the response reader of the client.
+   * \param[in] response serialized response.
+   * \return YES if the reader got matched meanwhile and the response was not queued,
+   *   GONE if the client is gone and the response was dropped,
+   *   MAYBE if the response was queued.
+   */
+  client_present_t
+  defer_response(
+    const eprosima::fastrtps::rtps::GUID_t & guid,
+    CustomServiceDeferredResponse && response)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    client_present_t ret = deferred_client_state(guid);
+    if (client_present_t::MAYBE == ret) {
+      deferred_responses_[guid].push_back(std::move(response));
+      // Only services that actually defer responses get a flushing thread
+      if (!flush_thread_.joinable() && !stop_flushing_) {
+        flush_thread_ = std::thread(&ServicePubListener::flush_responses_of_matched_readers, this);
+      }
+    }
+    return ret;
+  }
+
+  /// Stop writing queued responses, before the response writer is deleted.
+  void
+  stop_flushing()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_flushing_ = true;
+    }
+    flush_cv_.notify_all();
+    if (flush_thread_.joinable()) {
+      flush_thread_.join();
+    }
+  }
+
   void endpoint_erase_if_exists(
     const eprosima::fastrtps::rtps::GUID_t & endpointGuid)
   {
     std::lock_guard<std::mutex> lock(mutex_);
     auto endpoint = clients_endpoints_.find(endpointGuid);
     if (endpoint != clients_endpoints_.end()) {
+      deferred_responses_.erase(endpoint->second);
       clients_endpoints_.erase(endpoint->second);
       clients_endpoints_.erase(endpointGuid);
     }
@@ -175,10 +294,99 @@ public:
   }
 
 private:
+  client_present_t
+  deferred_client_state(
+    const eprosima::fastrtps::rtps::GUID_t & guid) RCPPUTILS_TSA_REQUIRES(mutex_)
+  {
+    // Responses still queued have to be written first, even if the reader is matched
+    if (deferred_responses_.find(guid) != deferred_responses_.end()) {
+      return client_present_t::MAYBE;
+    }
+    if (subscriptions_.find(guid) != subscriptions_.end()) {
+      return client_present_t::YES;
+    }
+    if (clients_endpoints_.find(guid) == clients_endpoints_.end()) {
+      return client_present_t::GONE;
+    }
+    return client_present_t::MAYBE;
+  }
+
+  // Body of the flushing thread, writing the responses queued for readers as they get matched
+  void
+  flush_responses_of_matched_readers()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      flush_cv_.wait(
+        lock, [this]() RCPPUTILS_TSA_REQUIRES(mutex_)->bool
+        {
+          return stop_flushing_ || !readers_to_flush_.empty();
+        });
+      if (stop_flushing_) {
+        return;
+      }
+      eprosima::fastrtps::rtps::GUID_t guid = readers_to_flush_.back();
+      readers_to_flush_.pop_back();
+      eprosima::fastdds::dds::DataWriter * writer = writer_;
+
+      lock.unlock();
+      flush_deferred_responses(writer, guid);
+      lock.lock();
+    }
+  }
+
+  // Write the responses queued for a reader that just matched, in the order they were sent.
+  // The queue is kept while writing, so responses sent meanwhile are queued behind them.
+  void
+  flush_deferred_responses(
+    eprosima::fastdds::dds::DataWriter * writer,
+    const eprosima::fastrtps::rtps::GUID_t & guid)
+  {
+    std::vector<CustomServiceDeferredResponse> responses;
+    while (true) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto deferred = deferred_responses_.find(guid);
+        if (deferred == deferred_responses_.end()) {
+          return;
+        }
+        if (deferred->second.empty()) {
+          deferred_responses_.erase(deferred);
+          return;
+        }
+        responses.swap(deferred->second);
+      }
+
+      for (auto & response : responses) {
+        eprosima::fastcdr::FastBuffer buffer(response.buffer_.data(), response.buffer_.size());
+        eprosima::fastcdr::Cdr ser(
+          buffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN, eprosima::fastcdr::CdrVersion::XCDRv1);
+        ser.set_encoding_flag(eprosima::fastcdr::EncodingAlgorithmFlag::PLAIN_CDR);
+        ser.jump(response.buffer_.size());
+
+        rmw_fastrtps_shared_cpp::SerializedData data;
+        data.type = FASTRTPS_SERIALIZED_DATA_TYPE_CDR_BUFFER;
+        data.data = &ser;
+        data.impl = nullptr;  // not used when type is FASTRTPS_SERIALIZED_DATA_TYPE_CDR_BUFFER
+        // There is no one to report a failure to, the client will see it as a lost response
+        writer->write(&data, response.wparams_);
+      }
+      responses.clear();
+    }
+  }
+
   std::mutex mutex_;
   subscriptions_set_t subscriptions_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
   clients_endpoints_map_t clients_endpoints_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
-  std::condition_variable cv_;
+  deferred_responses_map_t deferred_responses_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
+  subscription_waiters_map_t subscription_waiters_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
+
+  // Readers matched with queued responses, waiting for the flushing thread
+  std::vector<eprosima::fastrtps::rtps::GUID_t> readers_to_flush_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
+  eprosima::fastdds::dds::DataWriter * writer_ RCPPUTILS_TSA_GUARDED_BY(mutex_) {nullptr};
+  bool stop_flushing_ RCPPUTILS_TSA_GUARDED_BY(mutex_) {false};
+  std::condition_variable flush_cv_;
+  std::thread flush_thread_;
 };
 
 class ServiceListener : public eprosima::fastdds::dds::DataReaderListener
@@ -210,12 +418,16 @@ public:
   on_data_available(
     eprosima::fastdds::dds::DataReader *) final
   {
+    info_->data_readiness_.mark_ready();
+
     std::unique_lock<std::mutex> lock_mutex(on_new_request_m_);
 
-    auto unread_requests = get_unread_resquests();
+    if (on_new_request_cb_) {
+      auto unread_requests = get_unread_resquests();
 
-    if (0u < unread_requests) {
-      on_new_request_cb_(user_data_, unread_requests);
+      if (0u < unread_requests) {
+        on_new_request_cb_(user_data_, unread_requests);
+      }
     }
   }
 
@@ -245,7 +457,9 @@ public:
       std::lock_guard<std::mutex> lock_mutex(on_new_request_m_);
 
       eprosima::fastdds::dds::StatusMask status_mask = info_->request_reader_->get_status_mask();
-      status_mask &= ~eprosima::fastdds::dds::StatusMask::data_available();
+      if (!info_->data_readiness_.is_enabled()) {
+        status_mask &= ~eprosima::fastdds::dds::StatusMask::data_available();
+      }
       info_->request_reader_->set_listener(this, status_mask);
 
       user_data_ = nullptr;
@@ -43,6 +43,8 @@
 #include "rmw_dds_common/context.hpp"
 
 #include "rmw_fastrtps_shared_cpp/custom_event_info.hpp"
+#include "rmw_fastrtps_shared_cpp/custom_subscription_allocation.hpp"
+#include "rmw_fastrtps_shared_cpp/data_readiness.hpp"
 
 class RMWSubscriptionEvent;
 
@@ -88,6 +90,9 @@ private:
 namespace rmw_fastrtps_shared_cpp
 {
 struct LoanManager;
+class LocalSubscription;
+class SharedDataReader;
+class SharedSampleQueue;
 }  // namespace rmw_fastrtps_shared_cpp
 
 struct CustomSubscriberInfo : public CustomEventInfo
@@ -102,6 +107,25 @@ struct CustomSubscriberInfo : public CustomEventInfo
   rmw_gid_t subscription_gid_{};
   const char * typesupport_identifier_{nullptr};
   std::shared_ptr<rmw_fastrtps_shared_cpp::LoanManager> loan_manager_;
+  rmw_fastrtps_shared_cpp::DataReadiness data_readiness_;
+
+  // Set when data_reader_ is shared with other subscriptions to the same topic.
+  // Samples are then taken from shared_queue_, which is filled by the shared reader.
+  rmw_fastrtps_shared_cpp::SharedDataReader * shared_reader_ {nullptr};
+  std::shared_ptr<rmw_fastrtps_shared_cpp::SharedSampleQueue> shared_queue_;
+  // Whether subscription_gid_ was made up, as no DataReader has that GUID.
+  // Such subscriptions are added to the graph by hand, as discovery does not report them.
+  bool synthetic_gid_ {false};
+
+  // Set when the subscription also receives messages straight from the publishers of the
+  // participant to the same topic, see LocalDelivery.
+  std::shared_ptr<rmw_fastrtps_shared_cpp::LocalSubscription> local_subscription_;
+
+  // Scratch of the sequence takes without an allocation. It grows to the largest count taken
+  // at once, and is kept so that later takes of that many samples do not allocate.
+  std::mutex take_scratch_mutex_;
+  rmw_fastrtps_shared_cpp::CustomSubscriptionAllocation take_scratch_
+  RCPPUTILS_TSA_GUARDED_BY(take_scratch_mutex_) {0u};
 
   // for re-create or delete content filtered topic
   const rmw_node_t * node_ {nullptr};
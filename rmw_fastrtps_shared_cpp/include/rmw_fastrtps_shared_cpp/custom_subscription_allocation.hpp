@@ -0,0 +1,110 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__CUSTOM_SUBSCRIPTION_ALLOCATION_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__CUSTOM_SUBSCRIPTION_ALLOCATION_HPP_
+
+#include <new>
+#include <vector>
+
+#include "fastdds/dds/core/LoanableCollection.hpp"
+#include "fastdds/dds/subscriber/SampleInfo.hpp"
+
+#include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+// Collection of data pointers, used to take several samples in a single call
+// without loaning them from the DataReader.
+struct DataPointerSequence final : public eprosima::fastdds::dds::LoanableCollection
+{
+  explicit DataPointerSequence(
+    size_type max_elements)
+  {
+    reserve(max_elements);
+  }
+
+  /// Make room for at least `max_elements` pointers. Must not be called while taking.
+  void reserve(
+    size_type max_elements)
+  {
+    if (max_elements > maximum_) {
+      pointers_.resize(static_cast<size_t>(max_elements), nullptr);
+      elements_ = pointers_.data();
+      maximum_ = max_elements;
+    }
+  }
+
+  void set(
+    size_type index,
+    element_type value)
+  {
+    pointers_[index] = value;
+  }
+
+protected:
+  void resize(
+    size_type /*new_length*/) override
+  {
+    // The capacity of this collection is only changed through reserve()
+    throw std::bad_alloc();
+  }
+
+private:
+  std::vector<element_type> pointers_;
+};
+
+/// Scratch storage used by the take functions when given a subscription allocation.
+/**
+ * Everything a take needs besides the messages themselves is kept here, so taking with an
+ * allocation does not allocate once the scratch is big enough.
+ * An allocation can be shared by subscriptions of the same type, but not by concurrent takes.
+ */
+struct CustomSubscriptionAllocation
+{
+  explicit CustomSubscriptionAllocation(
+    size_t max_serialized_size)
+  : max_serialized_size_(max_serialized_size),
+    data_values_(0)
+  {
+    // Enough for the single sample takes
+    reserve(1u);
+  }
+
+  /// Make room for taking `max_samples` samples in a single call.
+  void reserve(
+    size_t max_samples)
+  {
+    if (max_samples > data_.size()) {
+      data_.resize(max_samples);
+      data_values_.reserve(static_cast<DataPointerSequence::size_type>(max_samples));
+      // Growing the length beyond the maximum reallocates, shrinking it keeps the storage
+      using size_type = eprosima::fastdds::dds::SampleInfoSeq::size_type;
+      info_seq_.length(static_cast<size_type>(max_samples));
+      info_seq_.length(0);
+    }
+  }
+
+  /// Serialized size of the largest message of the type, or 0 if it is unbounded.
+  size_t max_serialized_size_;
+
+  std::vector<SerializedData> data_;
+  DataPointerSequence data_values_;
+  eprosima::fastdds::dds::SampleInfoSeq info_seq_;
+};
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__CUSTOM_SUBSCRIPTION_ALLOCATION_HPP_
@@ -0,0 +1,39 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__CUSTOM_WAIT_SET_INFO_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__CUSTOM_WAIT_SET_INFO_HPP_
+
+#include "fastdds/dds/core/condition/Condition.hpp"
+#include "fastdds/dds/core/condition/WaitSet.hpp"
+
+struct CustomWaitsetInfo
+{
+  eprosima::fastdds::dds::WaitSet fastdds_wait_set_;
+
+  // Conditions are left attached to fastdds_wait_set_ between calls to rmw_wait, and only the
+  // difference with the requested entities is attached or detached on each call.
+  // The following sequences are reused on every wait to avoid allocations in steady state.
+
+  /// Conditions currently attached to fastdds_wait_set_, sorted by address.
+  eprosima::fastdds::dds::ConditionSeq attached_conditions_;
+
+  /// Conditions requested on the current call, sorted by address.
+  eprosima::fastdds::dds::ConditionSeq requested_conditions_;
+
+  /// Conditions reported as triggered by fastdds_wait_set_.
+  eprosima::fastdds::dds::ConditionSeq triggered_conditions_;
+};
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__CUSTOM_WAIT_SET_INFO_HPP_
@@ -0,0 +1,100 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__DATA_READINESS_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__DATA_READINESS_HPP_
+
+#include <atomic>
+
+#include "fastdds/dds/core/status/StatusMask.hpp"
+#include "fastdds/dds/subscriber/DataReader.hpp"
+#include "fastdds/dds/subscriber/DataReaderListener.hpp"
+#include "fastdds/dds/subscriber/SampleInfo.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Listener-driven hint of whether a DataReader may hold untaken data.
+/**
+ * Checking a DataReader for untaken data requires taking the reader's lock.
+ * When tracking is enabled, the reader listener marks the reader as ready on every
+ * `on_data_available` notification, and rmw_wait only queries the readers that were marked.
+ * When tracking is disabled, every query goes straight to the reader.
+ */
+class DataReadiness
+{
+public:
+  /// Enable tracking on a reader, making sure its listener is notified of new data.
+  /**
+   * \param[in] reader DataReader to track.
+   * \param[in] listener listener currently installed on `reader`.
+   */
+  void enable(
+    eprosima::fastdds::dds::DataReader * reader,
+    eprosima::fastdds::dds::DataReaderListener * listener)
+  {
+    enabled_ = true;
+    eprosima::fastdds::dds::StatusMask status_mask = reader->get_status_mask();
+    status_mask |= eprosima::fastdds::dds::StatusMask::data_available();
+    reader->set_listener(listener, status_mask);
+    // Data may have arrived before the listener was notifying it
+    mark_ready();
+  }
+
+  /// Whether the reader listener must keep notifying `on_data_available`.
+  bool is_enabled() const
+  {
+    return enabled_;
+  }
+
+  /// Called from the reader listener whenever new data is available.
+  void mark_ready()
+  {
+    ready_.store(true, std::memory_order_release);
+  }
+
+  /// Check whether the reader has untaken data.
+  /**
+   * With tracking enabled, a reader that was not marked as ready since the last check is not
+   * queried at all.
+   *
+   * \param[in] reader DataReader to check.
+   * \return true if `reader` has untaken data.
+   */
+  bool has_untaken_data(eprosima::fastdds::dds::DataReader * reader)
+  {
+    if (enabled_ && !ready_.exchange(false, std::memory_order_acq_rel)) {
+      return false;
+    }
+
+    eprosima::fastdds::dds::SampleInfo sample_info;
+    if (ReturnCode_t::RETCODE_OK != reader->get_first_untaken_info(&sample_info)) {
+      return false;
+    }
+
+    if (enabled_) {
+      // Keep it marked until everything has been taken
+      mark_ready();
+    }
+    return true;
+  }
+
+private:
+  bool enabled_ {false};
+  std::atomic_bool ready_ {true};
+};
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__DATA_READINESS_HPP_
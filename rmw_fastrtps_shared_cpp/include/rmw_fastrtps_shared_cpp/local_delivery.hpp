@@ -0,0 +1,220 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__LOCAL_DELIVERY_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__LOCAL_DELIVERY_HPP_
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include "fastdds/dds/subscriber/DataReader.hpp"
+#include "fastdds/dds/topic/Topic.hpp"
+#include "fastdds/rtps/common/Guid.h"
+#include "fastdds/rtps/common/Time_t.h"
+
+#include "rcpputils/thread_safety_annotations.hpp"
+
+#include "rmw/serialized_message.h"
+#include "rmw/subscription_options.h"
+#include "rmw/types.h"
+
+#include "rmw_fastrtps_shared_cpp/custom_publisher_info.hpp"
+#include "rmw_fastrtps_shared_cpp/custom_subscriber_info.hpp"
+#include "rmw_fastrtps_shared_cpp/shared_data_reader.hpp"
+#include "rmw_fastrtps_shared_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Subscription receiving messages straight from the publishers of its participant.
+/**
+ * Those messages are queued next to the DataReader of the subscription, which keeps receiving
+ * the messages of every other publisher.
+ * The copies of the local messages received through the DataReader are dropped when taken.
+ */
+class LocalSubscription
+{
+public:
+  /// \param[in] depth maximum number of queued messages, or 0 for no limit.
+  /// \param[in] info subscription receiving the messages.
+  LocalSubscription(size_t depth, CustomSubscriberInfo * info)
+  : queue_(depth),
+    type_support_impl_(info->type_support_impl_),
+    reader_guid_(info->data_reader_->guid()),
+    reader_(info->data_reader_),
+    listener_(info->data_reader_listener_)
+  {
+  }
+
+  SharedSampleQueue & get_queue()
+  {
+    return queue_;
+  }
+
+  const void * get_type_support_impl() const
+  {
+    return type_support_impl_;
+  }
+
+  const eprosima::fastrtps::rtps::GUID_t & get_reader_guid() const
+  {
+    return reader_guid_;
+  }
+
+  /// Tell the listener of the subscription that messages were queued.
+  void notify()
+  {
+    std::lock_guard<std::recursive_mutex> lock(listener_mutex_);
+    if (nullptr != listener_) {
+      listener_->on_data_available(reader_);
+    }
+  }
+
+  /// Stop notifying the subscription, once a notification in progress is done.
+  void detach()
+  {
+    std::lock_guard<std::recursive_mutex> lock(listener_mutex_);
+    listener_ = nullptr;
+  }
+
+  /// Whether the messages of a DataWriter are delivered to this subscription locally.
+  bool is_local_writer(const eprosima::fastrtps::rtps::GUID_t & writer_guid) const
+  {
+    std::lock_guard<std::mutex> lock(writers_mutex_);
+    return writers_.count(writer_guid) > 0u;
+  }
+
+  void add_local_writer(const eprosima::fastrtps::rtps::GUID_t & writer_guid)
+  {
+    std::lock_guard<std::mutex> lock(writers_mutex_);
+    writers_.insert(writer_guid);
+  }
+
+private:
+  SharedSampleQueue queue_;
+  const void * const type_support_impl_;
+  const eprosima::fastrtps::rtps::GUID_t reader_guid_;
+  eprosima::fastdds::dds::DataReader * const reader_;
+
+  // The callback of the listener may publish to the same topic again
+  std::recursive_mutex listener_mutex_;
+  CustomDataReaderListener * listener_ RCPPUTILS_TSA_GUARDED_BY(listener_mutex_);
+
+  mutable std::mutex writers_mutex_;
+  // Never erased, so that samples of a removed publisher still in the DataReader are dropped
+  std::set<eprosima::fastrtps::rtps::GUID_t> writers_ RCPPUTILS_TSA_GUARDED_BY(writers_mutex_);
+};
+
+/// Publishers and subscriptions of one topic delivered locally, see LocalDelivery.
+class LocalTopic
+{
+public:
+  std::mutex mutex_;
+  std::vector<CustomPublisherInfo *> publishers_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
+  std::vector<std::shared_ptr<LocalSubscription>> subscriptions_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
+  // Read without the lock, to skip copying messages nobody would get
+  std::atomic<size_t> subscription_count_{0u};
+};
+
+/// Publishers and subscriptions of a participant exchanging messages without the DataWriter.
+/**
+ * A message is handed to the local subscriptions matched with the publisher which use the same
+ * type support, and it is only written to the DataWriter when some other subscription is
+ * matched too.
+ * Messages of plain types are copied as they are.
+ * Other messages are serialized once, and each subscription deserializes them when taking.
+ * Publishers keeping history for late joiners are never delivered locally, and neither are
+ * subscriptions with a content filter, ignoring local publications, or sharing a DataReader.
+ * The functions adding or removing entities must be called with the entity_creation_mutex_ of
+ * the participant locked.
+ */
+class LocalDelivery
+{
+public:
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  void add_publisher(CustomPublisherInfo * info);
+
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  void remove_publisher(CustomPublisherInfo * info);
+
+  /// Deliver the messages of the local publishers to a subscription, when it supports it.
+  /**
+   * The DataReader, topic and type support of `info` must already be set.
+   * On success, `local_subscription_` of `info` is set.
+   */
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  void add_subscription(
+    CustomSubscriberInfo * info,
+    const rmw_subscription_options_t * subscription_options);
+
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  void remove_subscription(CustomSubscriberInfo * info);
+
+  /// Hand a ROS message to the local subscriptions matched with a publisher.
+  /**
+   * \param[in] info publisher added to this object.
+   * \param[in] ros_message message to deliver, which is copied, or serialized if not plain.
+   * \param[in] stamp source timestamp of the message.
+   * \param[out] write set to whether the message still has to be written to the DataWriter.
+   * \return `RMW_RET_OK` if successful, or
+   * \return `RMW_RET_ERROR` if the message cannot be copied for the local subscriptions, which
+   *   are then left without it.
+   */
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  rmw_ret_t deliver(
+    CustomPublisherInfo * info,
+    const void * ros_message,
+    const eprosima::fastrtps::Time_t & stamp,
+    bool * write);
+
+  /// Hand a serialized message to the local subscriptions matched with a publisher.
+  /**
+   * It is deserialized by each subscription when taken.
+   * Arguments and return value are the same as for deliver().
+   */
+  RMW_FASTRTPS_SHARED_CPP_PUBLIC
+  rmw_ret_t deliver_serialized(
+    CustomPublisherInfo * info,
+    const rmw_serialized_message_t * serialized_message,
+    const eprosima::fastrtps::Time_t & stamp,
+    bool * write);
+
+private:
+  rmw_ret_t deliver_payload(
+    CustomPublisherInfo * info,
+    const std::shared_ptr<const rmw_serialized_message_t> & payload,
+    const void * plain_impl,
+    const eprosima::fastrtps::Time_t & stamp,
+    bool * write);
+
+  LocalTopic & get_topic(const eprosima::fastdds::dds::Topic * topic)
+  RCPPUTILS_TSA_REQUIRES(mutex_);
+
+  void remove_topic_if_unused(const eprosima::fastdds::dds::Topic * topic)
+  RCPPUTILS_TSA_REQUIRES(mutex_);
+
+  // Topics are only added and removed along with entities, and delivering a message only
+  // locks the LocalTopic of its publisher
+  std::mutex mutex_;
+  std::map<const eprosima::fastdds::dds::Topic *, std::unique_ptr<LocalTopic>>
+  topics_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
+};
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__LOCAL_DELIVERY_HPP_
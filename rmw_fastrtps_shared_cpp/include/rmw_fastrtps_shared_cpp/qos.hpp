@@ -47,6 +47,37 @@ get_datawriter_qos(
   const rosidl_type_hash_t & type_hash,
   eprosima::fastdds::dds::DataWriterQos & writer_qos);
 
+/// Enable data-sharing delivery, with a shared memory segment sized from the history depth.
+/**
+ * Only meant for plain types, whose samples all have the same size.
+ * Must be called after the RMW QoS profile has been applied.
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+void
+enable_data_sharing(eprosima::fastdds::dds::DataReaderQos & reader_qos);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+void
+enable_data_sharing(eprosima::fastdds::dds::DataWriterQos & writer_qos);
+
+/// Accept the XCDR2 data representation, besides XCDR1, on a DataReader.
+/**
+ * Must be called after the RMW QoS profile has been applied.
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+void
+enable_xcdr2(eprosima::fastdds::dds::DataReaderQos & reader_qos);
+
+/// Serialize with the XCDR2 data representation on a DataWriter.
+/**
+ * A DataWriter serializes with a single data representation, so it only matches the DataReaders
+ * which accept XCDR2, and never falls back to XCDR1.
+ * Must be called after the RMW QoS profile has been applied.
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+void
+enable_xcdr2(eprosima::fastdds::dds::DataWriterQos & writer_qos);
+
 RMW_FASTRTPS_SHARED_CPP_PUBLIC
 bool
 get_topic_qos(
@@ -163,6 +163,15 @@ __rmw_publish(
   const void * ros_message,
   rmw_publisher_allocation_t * allocation);
 
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_publish_batch(
+  const char * identifier,
+  const rmw_publisher_t * publisher,
+  const void * const * ros_messages,
+  size_t count,
+  rmw_publisher_allocation_t * allocation);
+
 RMW_FASTRTPS_SHARED_CPP_PUBLIC
 rmw_ret_t
 __rmw_publish_serialized_message(
@@ -207,6 +216,19 @@ __rmw_publisher_wait_for_all_acked(
   const rmw_publisher_t * publisher,
   rmw_time_t wait_timeout);
 
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_init_publisher_allocation(
+  const char * identifier,
+  size_t max_serialized_size,
+  rmw_publisher_allocation_t * allocation);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_fini_publisher_allocation(
+  const char * identifier,
+  rmw_publisher_allocation_t * allocation);
+
 RMW_FASTRTPS_SHARED_CPP_PUBLIC
 rmw_ret_t
 __rmw_destroy_publisher(
@@ -243,6 +265,16 @@ __rmw_take_request(
   void * ros_request,
   bool * taken);
 
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_take_request_sequence(
+  const char * identifier,
+  const rmw_service_t * service,
+  size_t count,
+  void ** ros_requests,
+  rmw_service_info_t * request_headers,
+  size_t * taken);
+
 RMW_FASTRTPS_SHARED_CPP_PUBLIC
 rmw_ret_t
 __rmw_take_response(
@@ -252,6 +284,16 @@ __rmw_take_response(
   void * ros_response,
   bool * taken);
 
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_take_response_sequence(
+  const char * identifier,
+  const rmw_client_t * client,
+  size_t count,
+  void ** ros_responses,
+  rmw_service_info_t * request_headers,
+  size_t * taken);
+
 RMW_FASTRTPS_SHARED_CPP_PUBLIC
 rmw_ret_t
 __rmw_send_response(
@@ -325,6 +367,19 @@ __rmw_service_server_is_available(
   const rmw_client_t * client,
   bool * is_available);
 
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_init_subscription_allocation(
+  const char * identifier,
+  size_t max_serialized_size,
+  rmw_subscription_allocation_t * allocation);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_fini_subscription_allocation(
+  const char * identifier,
+  rmw_subscription_allocation_t * allocation);
+
 RMW_FASTRTPS_SHARED_CPP_PUBLIC
 rmw_ret_t
 __rmw_destroy_subscription(
@@ -418,6 +473,22 @@ __rmw_return_loaned_message_from_subscription(
   const rmw_subscription_t * subscription,
   void * loaned_message);
 
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_take_loaned_serialized_message(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  rmw_serialized_message_t * serialized_message,
+  bool * taken,
+  rmw_message_info_t * message_info);
+
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+rmw_ret_t
+__rmw_return_loaned_serialized_message(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  rmw_serialized_message_t * serialized_message);
+
 RMW_FASTRTPS_SHARED_CPP_PUBLIC
 rmw_ret_t
 __rmw_take_event(
@@ -0,0 +1,288 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_FASTRTPS_SHARED_CPP__SHARED_DATA_READER_HPP_
+#define RMW_FASTRTPS_SHARED_CPP__SHARED_DATA_READER_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "fastdds/dds/core/LoanableCollection.hpp"
+#include "fastdds/dds/core/condition/GuardCondition.hpp"
+#include "fastdds/dds/subscriber/DataReader.hpp"
+#include "fastdds/dds/subscriber/DataReaderListener.hpp"
+#include "fastdds/dds/subscriber/SampleInfo.hpp"
+#include "fastdds/dds/subscriber/qos/DataReaderQos.hpp"
+#include "fastdds/dds/topic/TopicDataType.hpp"
+#include "fastdds/dds/topic/TopicDescription.hpp"
+
+#include "rcpputils/thread_safety_annotations.hpp"
+
+#include "rmw/serialized_message.h"
+#include "rmw/subscription_options.h"
+
+#include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
+#include "rmw_fastrtps_shared_cpp/custom_subscriber_info.hpp"
+#include "rmw_fastrtps_shared_cpp/visibility_control.h"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+/// Samples of a shared DataReader not yet taken by one of the subscriptions sharing it.
+/**
+ * The serialized payload of each sample is shared by the queues of every subscription, and
+ * is only deserialized when taken.
+ * Samples delivered by local publishers may instead hold a plain ROS message, which is copied
+ * when taken.
+ * The guard condition stays triggered while the queue is not empty, or while samples for it are
+ * left in the DataReader, and is what rmw_wait watches instead of the status condition of the
+ * DataReader.
+ */
+class SharedSampleQueue
+{
+public:
+  /// \param[in] depth maximum number of queued samples, or 0 for no limit.
+  explicit SharedSampleQueue(size_t depth);
+
+  /// Queue a sample, dropping the oldest one when the queue is full.
+  /**
+   * \param[in] payload CDR payload of the sample, or the ROS message when `plain_impl` is set.
+   * \param[in] sample_info information returned along with the sample.
+   * \param[in] plain_impl type support of the ROS message held by `payload`, which must be
+   *   plain, or nullptr for CDR payloads.
+   */
+  void push(
+    const std::shared_ptr<const rmw_serialized_message_t> & payload,
+    const eprosima::fastdds::dds::SampleInfo & sample_info,
+    const void * plain_impl = nullptr);
+
+  /// Take up to `max_samples` samples, with the same contract as DataReader::take.
+  /**
+   * `data_values` must hold a SerializedData per sample, which is deserialized with `type`.
+   * Samples which cannot be deserialized are returned with `valid_data` unset.
+   *
+   * \return RETCODE_OK when at least one sample was taken
+   * \return RETCODE_NO_DATA when the queue is empty
+   */
+  ReturnCode_t take(
+    eprosima::fastdds::dds::TopicDataType * type,
+    eprosima::fastdds::dds::LoanableCollection & data_values,
+    eprosima::fastdds::dds::SampleInfoSeq & info_seq,
+    int32_t max_samples);
+
+  size_t size() const;
+
+  /// Whether the queue holds as many samples as its depth.
+  bool full() const;
+
+  /// Number of queued samples pushed since the last call, as DataReader::get_unread_count(true).
+  size_t get_unread_count();
+
+  /// Record that samples to take were left in the DataReader instead of this queue.
+  void mark_samples_in_reader();
+
+  /// Number of calls to mark_samples_in_reader() so far.
+  uint64_t get_reader_generation() const;
+
+  /// Record that no sample is left in the DataReader, unless marked since `generation`.
+  void clear_samples_in_reader(uint64_t generation);
+
+  /// Whether there is nothing to take, neither in the queue nor in the DataReader.
+  bool empty() const;
+
+  eprosima::fastdds::dds::GuardCondition & get_guard_condition()
+  {
+    return guard_condition_;
+  }
+
+private:
+  struct Sample
+  {
+    std::shared_ptr<const rmw_serialized_message_t> payload;
+    eprosima::fastdds::dds::SampleInfo info;
+    const void * plain_impl;
+  };
+
+  const size_t depth_;
+  mutable std::mutex mutex_;
+  std::deque<Sample> samples_ RCPPUTILS_TSA_GUARDED_BY(mutex_);
+  size_t unread_count_ RCPPUTILS_TSA_GUARDED_BY(mutex_) {0u};
+  bool samples_in_reader_ RCPPUTILS_TSA_GUARDED_BY(mutex_) {false};
+  uint64_t reader_generation_ RCPPUTILS_TSA_GUARDED_BY(mutex_) {0u};
+  eprosima::fastdds::dds::GuardCondition guard_condition_;
+};
+
+/// Depth of the SharedSampleQueue of a subscription with the given QoS.
+/**
+ * KEEP_ALL queues are bounded by the resource limits of the QoS, as the history of a DataReader
+ * of their own would be.
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+size_t
+get_queue_depth(const eprosima::fastdds::dds::DataReaderQos & qos);
+
+/// DataReader shared by the subscriptions of a participant to the same topic with the same QoS.
+/**
+ * While a single subscription is attached, it takes its samples from the DataReader itself.
+ * Once several are, the listener of the DataReader takes every sample as soon as it is
+ * available, and queues it for each subscription.
+ * With a KEEP_ALL history, samples are left in the DataReader while the queue of a subscription
+ * is full, so they are not acknowledged before every subscription has room for them.
+ * The payloads the samples are taken into are reused once every subscription is done with them,
+ * so that their buffers are only allocated until there are as many as a queue holds.
+ * The rest of the notifications are forwarded to the listener of each subscription.
+ * All the functions creating or deleting shared readers must be called with the
+ * entity_creation_mutex_ of the participant locked.
+ */
+class SharedDataReader final : public eprosima::fastdds::dds::DataReaderListener
+{
+public:
+  /// \param[in] reader DataReader to share.
+  /// \param[in] qos QoS requested when creating `reader`.
+  SharedDataReader(
+    eprosima::fastdds::dds::DataReader * reader,
+    const eprosima::fastdds::dds::DataReaderQos & qos);
+
+  eprosima::fastdds::dds::DataReader * get_reader() const
+  {
+    return reader_;
+  }
+
+  /// Whether a subscription to `topic` requesting `qos` can use this DataReader.
+  bool matches(
+    const eprosima::fastdds::dds::TopicDescription * topic,
+    const eprosima::fastdds::dds::DataReaderQos & qos) const
+  {
+    return reader_->get_topicdescription() == topic && qos_ == qos;
+  }
+
+  void attach(CustomSubscriberInfo * info);
+
+  /// \return whether there are subscriptions still attached.
+  bool detach(CustomSubscriberInfo * info);
+
+  /// Take the samples of an attached subscription, with the same contract as DataReader::take.
+  ReturnCode_t take(
+    CustomSubscriberInfo * info,
+    eprosima::fastdds::dds::LoanableCollection & data_values,
+    eprosima::fastdds::dds::SampleInfoSeq & info_seq,
+    int32_t max_samples);
+
+  /// Number of samples of an attached subscription not taken yet, see SharedSampleQueue.
+  size_t get_unread_count(CustomSubscriberInfo * info);
+
+  void on_subscription_matched(
+    eprosima::fastdds::dds::DataReader * reader,
+    const eprosima::fastdds::dds::SubscriptionMatchedStatus & status) override;
+
+  void on_data_available(
+    eprosima::fastdds::dds::DataReader * reader) override;
+
+  void on_requested_deadline_missed(
+    eprosima::fastdds::dds::DataReader * reader,
+    const eprosima::fastdds::dds::RequestedDeadlineMissedStatus & status) override;
+
+  void on_liveliness_changed(
+    eprosima::fastdds::dds::DataReader * reader,
+    const eprosima::fastdds::dds::LivelinessChangedStatus & status) override;
+
+  void on_sample_lost(
+    eprosima::fastdds::dds::DataReader * reader,
+    const eprosima::fastdds::dds::SampleLostStatus & status) override;
+
+  void on_requested_incompatible_qos(
+    eprosima::fastdds::dds::DataReader * reader,
+    const eprosima::fastdds::dds::RequestedIncompatibleQosStatus & status) override;
+
+private:
+  // Move the samples of the DataReader to the queue of every subscription, while they have room
+  // for them or drop their oldest samples, and notify the subscriptions.
+  // The DataReader may call its listener with its own lock taken, so sharers_mutex_ is never
+  // held while calling the DataReader. Calls made while another thread is moving samples are
+  // served by that thread.
+  void queue_available_samples() RCPPUTILS_TSA_EXCLUDES(sharers_mutex_);
+
+  // Payload to take the next sample into, reusing one every queue is done with when possible
+  std::shared_ptr<rmw_serialized_message_t> get_payload() RCPPUTILS_TSA_REQUIRES(queueing_mutex_);
+
+  eprosima::fastdds::dds::DataReader * reader_;
+  const eprosima::fastdds::dds::DataReaderQos qos_;
+  const bool keep_all_;
+  // Number of payloads kept for reuse, enough for every sample a queue can hold
+  const size_t max_payloads_;
+
+  std::mutex sharers_mutex_;
+  std::vector<CustomSubscriberInfo *> sharers_ RCPPUTILS_TSA_GUARDED_BY(sharers_mutex_);
+  // Size of sharers_, read without the lock
+  std::atomic<size_t> sharer_count_{0u};
+
+  std::mutex queueing_mutex_;
+  std::atomic<bool> queueing_requested_{false};
+  // Ring of the payloads of the queued samples, oldest first from next_payload_.
+  // A payload only referenced from here was taken or dropped by every queue.
+  std::vector<std::shared_ptr<rmw_serialized_message_t>> payloads_
+  RCPPUTILS_TSA_GUARDED_BY(queueing_mutex_);
+  size_t next_payload_ RCPPUTILS_TSA_GUARDED_BY(queueing_mutex_) {0u};
+};
+
+/// Whether a subscription created with the given options may share its DataReader.
+/**
+ * Content filters are evaluated by the DataReader, and unique network flows are requested
+ * per DataReader, so subscriptions using either always get a DataReader of their own.
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+bool
+can_share_datareader(const rmw_subscription_options_t * subscription_options);
+
+/// Attach a subscription to the shared DataReader of its topic, creating it if needed.
+/**
+ * The topic, QoS, listener and type support of `info` must already be set.
+ * On success, `data_reader_`, `shared_reader_`, `shared_queue_` and `subscription_gid_` of
+ * `info` are set.
+ * The first subscription attached to a DataReader is identified by the GUID of the reader,
+ * the next ones get a GUID of their own, which is flagged by `synthetic_gid_`.
+ *
+ * \param[in] identifier implementation identifier used for the GID of the subscription.
+ * \param[in] participant_info participant creating the subscription.
+ * \param[inout] info subscription to attach.
+ * \param[in] subscription_options options of the subscription.
+ * \return true when the subscription was attached
+ * \return false when the DataReader could not be created
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+bool
+attach_to_shared_datareader(
+  const char * identifier,
+  CustomParticipantInfo * participant_info,
+  CustomSubscriberInfo * info,
+  const rmw_subscription_options_t * subscription_options);
+
+/// Detach a subscription from its shared DataReader, deleting it after the last one.
+/**
+ * \return true when the subscription was detached
+ * \return false when the DataReader could not be deleted
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+bool
+detach_from_shared_datareader(
+  CustomParticipantInfo * participant_info,
+  CustomSubscriberInfo * info);
+
+}  // namespace rmw_fastrtps_shared_cpp
+
+#endif  // RMW_FASTRTPS_SHARED_CPP__SHARED_DATA_READER_HPP_
@@ -27,6 +27,16 @@ void
 __init_subscription_for_loans(
   rmw_subscription_t * subscription);
 
+/// Give back to the DataReader every message the subscription still has on loan.
+/**
+ * The DataReader cannot be deleted while they are loaned.
+ * What was handed out for them must not be used afterwards.
+ */
+RMW_FASTRTPS_SHARED_CPP_PUBLIC
+void
+__return_subscription_loans(
+  rmw_subscription_t * subscription);
+
 RMW_FASTRTPS_SHARED_CPP_PUBLIC
 rmw_ret_t
 destroy_subscription(
@@ -22,6 +22,7 @@
 
 #include "fastcdr/FastBuffer.h"
 #include "fastcdr/Cdr.h"
+#include "fastcdr/exceptions/NotEnoughMemoryException.h"
 
 #include "fastrtps/rtps/common/SerializedPayload.h"
 #include "fastrtps/utils/md5.h"
@@ -32,8 +33,11 @@
 #include "fastrtps/types/TypeNamesGenerator.h"
 #include "fastrtps/types/AnnotationParameterValue.h"
 
+#include "rcutils/allocator.h"
+
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
 #include "rmw/error_handling.h"
+#include "rmw/serialized_message.h"
 
 #include "rosidl_typesupport_introspection_c/identifier.h"
 #include "rosidl_typesupport_introspection_cpp/identifier.hpp"
@@ -49,23 +53,56 @@ TypeSupport::TypeSupport()
   m_isGetKeyDefined = false;
   max_size_bound_ = false;
   is_plain_ = false;
+  plain_size_ = 0u;
   auto_fill_type_object(false);
   auto_fill_type_information(false);
 }
 
+namespace
+{
+
+// Sample loaned by a DataReader, with the serialized message it keeps the payload in,
+// so that both are allocated at once
+struct SerializedMessageSample : SerializedData
+{
+  rmw_serialized_message_t serialized_message;
+};
+
+}  // namespace
+
 void TypeSupport::deleteData(void * data)
 {
   assert(data);
-  delete static_cast<eprosima::fastcdr::FastBuffer *>(data);
+  auto sample = static_cast<SerializedMessageSample *>(static_cast<SerializedData *>(data));
+  if (RMW_RET_OK != rmw_serialized_message_fini(&sample->serialized_message)) {
+    rmw_reset_error();
+  }
+  delete sample;
 }
 
 void * TypeSupport::createData()
 {
-  return new eprosima::fastcdr::FastBuffer();
+  // Samples created here are the ones loaned by a DataReader. They keep the serialized payload,
+  // so loaned samples can be handed out as serialized messages without an intermediate buffer.
+  // The buffer is only allocated when the first payload is deserialized into it.
+  auto sample = new SerializedMessageSample;
+  sample->serialized_message = rmw_get_zero_initialized_serialized_message();
+  sample->serialized_message.allocator = rcutils_get_default_allocator();
+  sample->type = FASTRTPS_SERIALIZED_DATA_TYPE_SERIALIZED_MESSAGE;
+  sample->data = &sample->serialized_message;
+  sample->impl = nullptr;
+  return static_cast<SerializedData *>(sample);
 }
 
 bool TypeSupport::serialize(
   void * data, eprosima::fastrtps::rtps::SerializedPayload_t * payload)
+{
+  return serialize(data, payload, eprosima::fastdds::dds::XCDR_DATA_REPRESENTATION);
+}
+
+bool TypeSupport::serialize(
+  void * data, eprosima::fastrtps::rtps::SerializedPayload_t * payload,
+  eprosima::fastdds::dds::DataRepresentationId_t data_representation)
 {
   assert(data);
   assert(payload);
@@ -77,15 +114,26 @@ bool TypeSupport::serialize(
       {
         eprosima::fastcdr::FastBuffer fastbuffer(  // Object that manages the raw buffer
           reinterpret_cast<char *>(payload->data), payload->max_size);
+        const bool xcdr2 =
+          eprosima::fastdds::dds::XCDR2_DATA_REPRESENTATION == data_representation;
         eprosima::fastcdr::Cdr ser(  // Object that serializes the data
           fastbuffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN,
-          eprosima::fastcdr::CdrVersion::XCDRv1);
-        ser.set_encoding_flag(eprosima::fastcdr::EncodingAlgorithmFlag::PLAIN_CDR);
-        if (this->serializeROSmessage(ser_data->data, ser, ser_data->impl)) {
-          payload->encapsulation = ser.endianness() ==
-            eprosima::fastcdr::Cdr::BIG_ENDIANNESS ? CDR_BE : CDR_LE;
-          payload->length = (uint32_t)ser.get_serialized_data_length();
-          return true;
+          xcdr2 ? eprosima::fastcdr::CdrVersion::XCDRv2 : eprosima::fastcdr::CdrVersion::XCDRv1);
+        ser.set_encoding_flag(
+          xcdr2 ? eprosima::fastcdr::EncodingAlgorithmFlag::PLAIN_CDR2 :
+          eprosima::fastcdr::EncodingAlgorithmFlag::PLAIN_CDR);
+        try {
+          if (this->serializeROSmessage(ser_data->data, ser, ser_data->impl)) {
+            payload->encapsulation = ser.endianness() ==
+              eprosima::fastcdr::Cdr::BIG_ENDIANNESS ? CDR_BE : CDR_LE;
+            payload->length = (uint32_t)ser.get_serialized_data_length();
+            ser_data->serialized_size = payload->length;
+            return true;
+          }
+        } catch (const eprosima::fastcdr::exception::NotEnoughMemoryException &) {
+          // Only expected when the payload was sized from a hint
+          ser_data->size_exceeded = true;
+          return false;
         }
         break;
       }
@@ -148,6 +196,19 @@ bool TypeSupport::deserialize(
         return true;
       }
 
+    case FASTRTPS_SERIALIZED_DATA_TYPE_SERIALIZED_MESSAGE:
+      {
+        auto serialized_message = static_cast<rmw_serialized_message_t *>(ser_data->data);
+        if (serialized_message->buffer_capacity < payload->length) {
+          if (RMW_RET_OK != rmw_serialized_message_resize(serialized_message, payload->length)) {
+            return false;  // Error message already set
+          }
+        }
+        memcpy(serialized_message->buffer, payload->data, payload->length);
+        serialized_message->buffer_length = payload->length;
+        return true;
+      }
+
     case FASTRTPS_SERIALIZED_DATA_TYPE_DYNAMIC_MESSAGE:
       {
         auto m_type = std::make_shared<eprosima::fastrtps::types::DynamicPubSubType>();
@@ -175,6 +236,13 @@ std::function<uint32_t()> TypeSupport::getSerializedSizeProvider(void * data)
         auto ser = static_cast<eprosima::fastcdr::Cdr *>(ser_data->data);
         return static_cast<uint32_t>(ser->get_serialized_data_length());
       }
+      if (ser_data->type == FASTRTPS_SERIALIZED_DATA_TYPE_SERIALIZED_MESSAGE) {
+        auto serialized_message = static_cast<rmw_serialized_message_t *>(ser_data->data);
+        return static_cast<uint32_t>(serialized_message->buffer_length);
+      }
+      if (0u != ser_data->size_hint) {
+        return static_cast<uint32_t>(ser_data->size_hint);
+      }
       return static_cast<uint32_t>(
         this->getEstimatedSerializedSize(ser_data->data, ser_data->impl));
     };
@@ -623,4 +691,170 @@ bool register_type_object(
   return ret;
 }
 
+template<typename MembersType>
+bool
+members_are_xcdr2_interoperable(const MembersType * members)
+{
+  for (uint32_t i = 0; i < members->member_count_; ++i) {
+    const auto & member = members->members_[i];
+    switch (member.type_id_) {
+      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_WSTRING:
+        return false;
+      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_STRING:
+        if (member.is_array_) {
+          return false;
+        }
+        break;
+      case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE:
+        {
+          if (member.is_array_) {
+            return false;
+          }
+          const rosidl_message_type_support_t * type_support_intro =
+            get_type_support_introspection(member.members_);
+          if (!type_support_intro ||
+            !members_are_xcdr2_interoperable(
+              static_cast<const MembersType *>(type_support_intro->data)))
+          {
+            return false;
+          }
+          break;
+        }
+      default:
+        break;
+    }
+  }
+  return true;
+}
+
+bool is_xcdr2_interoperable(const rosidl_message_type_support_t * type_supports)
+{
+  const rosidl_message_type_support_t * type_support_intro =
+    get_type_support_introspection(type_supports);
+  if (!type_support_intro) {
+    rmw_reset_error();
+    return false;
+  }
+
+  bool ret = false;
+  if (type_support_intro->typesupport_identifier ==
+    rosidl_typesupport_introspection_c__identifier)
+  {
+    ret = members_are_xcdr2_interoperable(
+      static_cast<const rosidl_typesupport_introspection_c__MessageMembers *>(
+        type_support_intro->data));
+  } else {
+    ret = members_are_xcdr2_interoperable(
+      static_cast<const rosidl_typesupport_introspection_cpp::MessageMembers *>(
+        type_support_intro->data));
+  }
+  if (!ret) {
+    // Nested types without introspection type support leave an error behind
+    rmw_reset_error();
+  }
+  return ret;
+}
+
+// Size of a primitive in memory and serialized, or 0 when it is not laid out alike
+size_t
+plain_primitive_size(uint8_t type_id)
+{
+  switch (type_id) {
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_BOOLEAN:
+      return sizeof(bool) == 1u ? 1u : 0u;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_OCTET:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_CHAR:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT8:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT8:
+      return 1u;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT16:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT16:
+      return 2u;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_FLOAT:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT32:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT32:
+      return 4u;
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_DOUBLE:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_UINT64:
+    case ::rosidl_typesupport_introspection_cpp::ROS_TYPE_INT64:
+      return 8u;
+    default:
+      // Long doubles and wide characters are serialized with another size, strings are not plain
+      return 0u;
+  }
+}
+
+// Check the members of a message placed at `base`, and move `position` past them in the
+// serialized data
+template<typename MembersType>
+bool
+members_have_plain_layout(const MembersType * members, size_t base, size_t & position)
+{
+  for (uint32_t i = 0; i < members->member_count_; ++i) {
+    const auto & member = members->members_[i];
+    if (member.is_array_ && (member.is_upper_bound_ || 0u == member.array_size_)) {
+      // Sequences are not stored in the message
+      return false;
+    }
+    const size_t count = member.is_array_ ? member.array_size_ : 1u;
+    const size_t offset = base + member.offset_;
+
+    if (::rosidl_typesupport_introspection_cpp::ROS_TYPE_MESSAGE == member.type_id_) {
+      const rosidl_message_type_support_t * type_support_intro =
+        get_type_support_introspection(member.members_);
+      if (!type_support_intro) {
+        return false;
+      }
+      const auto sub_members = static_cast<const MembersType *>(type_support_intro->data);
+      for (size_t j = 0; j < count; ++j) {
+        if (!members_have_plain_layout(sub_members, offset + j * sub_members->size_of_, position)) {
+          return false;
+        }
+      }
+      continue;
+    }
+
+    const size_t size = plain_primitive_size(member.type_id_);
+    if (0u == size) {
+      return false;
+    }
+    // XCDR1 aligns primitives to their size from the start of the message
+    position = (position + size - 1u) & ~(size - 1u);
+    if (position != offset) {
+      return false;
+    }
+    position += size * count;
+  }
+  return true;
+}
+
+bool has_plain_layout(const rosidl_message_type_support_t * type_supports, size_t plain_size)
+{
+  const rosidl_message_type_support_t * type_support_intro =
+    get_type_support_introspection(type_supports);
+  if (!type_support_intro) {
+    rmw_reset_error();
+    return false;
+  }
+
+  size_t position = 0u;
+  bool ret = false;
+  if (type_support_intro->typesupport_identifier ==
+    rosidl_typesupport_introspection_c__identifier)
+  {
+    ret = members_have_plain_layout(
+      static_cast<const rosidl_typesupport_introspection_c__MessageMembers *>(
+        type_support_intro->data), 0u, position);
+  } else {
+    ret = members_have_plain_layout(
+      static_cast<const rosidl_typesupport_introspection_cpp::MessageMembers *>(
+        type_support_intro->data), 0u, position);
+  }
+  if (!ret) {
+    // Nested types without introspection type support leave an error behind
+    rmw_reset_error();
+  }
+  return ret && plain_size == position;
+}
+
 }  // namespace rmw_fastrtps_shared_cpp
@@ -0,0 +1,161 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+
+#include "rmw_fastrtps_shared_cpp/bounded_payload_pool.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+using eprosima::fastrtps::rtps::CacheChange_t;
+using eprosima::fastrtps::rtps::IPayloadPool;
+using eprosima::fastrtps::rtps::octet;
+using eprosima::fastrtps::rtps::SerializedPayload_t;
+
+BoundedPayloadPool::BoundedPayloadPool(uint32_t payload_size, size_t initial_payloads)
+: payload_size_(payload_size),
+  payload_count_(0u)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  free_payloads_.reserve(initial_payloads);
+  for (size_t i = 0; i < initial_payloads; ++i) {
+    octet * payload = new (std::nothrow) octet[payload_size_];
+    if (nullptr == payload) {
+      // The others are allocated when needed
+      break;
+    }
+    free_payloads_.push_back(payload);
+    ++payload_count_;
+  }
+}
+
+BoundedPayloadPool::~BoundedPayloadPool()
+{
+  // The DataWriter returns every payload before letting go of the pool
+  std::lock_guard<std::mutex> lock(mutex_);
+  assert(free_payloads_.size() == payload_count_);
+  for (octet * payload : free_payloads_) {
+    delete[] payload;
+  }
+}
+
+bool
+BoundedPayloadPool::assign_payload(uint32_t size, CacheChange_t & cache_change)
+{
+  octet * payload = nullptr;
+  uint32_t max_size = size;
+  if (size <= payload_size_) {
+    max_size = payload_size_;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!free_payloads_.empty()) {
+      payload = free_payloads_.back();
+      free_payloads_.pop_back();
+    } else {
+      // Make sure releasing it later never allocates
+      free_payloads_.reserve(payload_count_ + 1u);
+      payload = new (std::nothrow) octet[payload_size_];
+      if (nullptr == payload) {
+        return false;
+      }
+      ++payload_count_;
+    }
+  } else {
+    payload = new (std::nothrow) octet[size];
+    if (nullptr == payload) {
+      return false;
+    }
+  }
+
+  cache_change.serializedPayload.data = payload;
+  cache_change.serializedPayload.max_size = max_size;
+  cache_change.serializedPayload.length = 0u;
+  cache_change.serializedPayload.pos = 0u;
+  cache_change.payload_owner(this);
+  return true;
+}
+
+bool
+BoundedPayloadPool::get_payload(uint32_t size, CacheChange_t & cache_change)
+{
+  return assign_payload(size, cache_change);
+}
+
+bool
+BoundedPayloadPool::get_payload(
+  SerializedPayload_t & data,
+  IPayloadPool * & data_owner,
+  CacheChange_t & cache_change)
+{
+  if (!assign_payload(data.length, cache_change)) {
+    return false;
+  }
+  SerializedPayload_t & payload = cache_change.serializedPayload;
+  std::memcpy(payload.data, data.data, data.length);
+  payload.length = data.length;
+  payload.encapsulation = data.encapsulation;
+
+  if (nullptr == data_owner) {
+    // The caller keeps using the copy from now on
+    data_owner = this;
+    data.data = payload.data;
+  }
+  return true;
+}
+
+bool
+BoundedPayloadPool::release_payload(CacheChange_t & cache_change)
+{
+  assert(cache_change.payload_owner() == this);
+  SerializedPayload_t & payload = cache_change.serializedPayload;
+  if (payload_size_ == payload.max_size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_payloads_.push_back(payload.data);
+  } else {
+    delete[] payload.data;
+  }
+
+  payload.data = nullptr;
+  payload.length = 0u;
+  payload.pos = 0u;
+  payload.max_size = 0u;
+  cache_change.payload_owner(nullptr);
+  return true;
+}
+
+std::shared_ptr<BoundedPayloadPool>
+create_bounded_payload_pool(
+  const TypeSupport & type_support,
+  const eprosima::fastdds::dds::DataWriterQos & writer_qos)
+{
+  if (!type_support.is_bounded() || type_support.is_plain() ||
+    eprosima::fastdds::dds::OFF != writer_qos.data_sharing().kind())
+  {
+    return nullptr;
+  }
+
+  // A new message is added to the history before the oldest one is removed
+  int32_t samples = writer_qos.resource_limits().allocated_samples;
+  if (eprosima::fastdds::dds::KEEP_LAST_HISTORY_QOS == writer_qos.history().kind) {
+    samples = writer_qos.history().depth;
+  }
+  const size_t initial_payloads = samples > 0 ? static_cast<size_t>(samples) + 1u : 1u;
+  return std::make_shared<BoundedPayloadPool>(type_support.m_typeSize, initial_payloads);
+}
+
+}  // namespace rmw_fastrtps_shared_cpp
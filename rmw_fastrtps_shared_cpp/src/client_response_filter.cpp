@@ -0,0 +1,158 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "fastdds/dds/domain/DomainParticipant.hpp"
+#include "fastdds/dds/publisher/qos/DataWriterQos.hpp"
+#include "fastdds/dds/topic/ContentFilteredTopic.hpp"
+#include "fastdds/dds/topic/IContentFilter.hpp"
+#include "fastdds/dds/topic/IContentFilterFactory.hpp"
+#include "fastdds/dds/topic/Topic.hpp"
+#include "fastdds/rtps/common/Guid.h"
+
+#include "fastrtps/types/TypesBase.h"
+
+#include "rmw_fastrtps_shared_cpp/client_response_filter.hpp"
+
+using ReturnCode_t = eprosima::fastrtps::types::ReturnCode_t;
+
+namespace
+{
+
+constexpr const char * const CLIENT_RESPONSE_FILTER_CLASS_NAME = "RMW_FASTRTPS_CLIENT_RESPONSE";
+
+// The filter is evaluated with its own class, so the expression is only informative
+constexpr const char * const CLIENT_RESPONSE_FILTER_EXPRESSION =
+  "related_sample_identity.writer_guid = reader_guid";
+
+const char * const CLIENT_RESPONSE_FILTERED_TOPIC_POSTFIX = "_client_response_";
+
+class ClientResponseFilter final : public eprosima::fastdds::dds::IContentFilter
+{
+public:
+  bool evaluate(
+    const SerializedPayload & /*payload*/,
+    const FilterSampleInfo & sample_info,
+    const GUID_t & reader_guid) const override
+  {
+    const GUID_t & related_guid = sample_info.related_sample_identity.writer_guid();
+    if (related_guid == reader_guid) {
+      return true;
+    }
+
+    // Servers answering a request which did not carry the guid of the response reader set the
+    // guid of the request writer instead (see rmw_request.cpp). It belongs to the same
+    // participant as the response reader, and is told apart by the entity kind, as in
+    // __rmw_send_response. Let those through, the client will check them when taking.
+    constexpr uint8_t entity_id_is_reader_bit = 0x04;
+    return
+      (related_guid.guidPrefix == reader_guid.guidPrefix) &&
+      ((related_guid.entityId.value[3] & entity_id_is_reader_bit) == 0);
+  }
+};
+
+class ClientResponseFilterFactory final : public eprosima::fastdds::dds::IContentFilterFactory
+{
+public:
+  ReturnCode_t create_content_filter(
+    const char * filter_class_name,
+    const char * /*type_name*/,
+    const eprosima::fastdds::dds::TopicDataType * /*data_type*/,
+    const char * filter_expression,
+    const ParameterSeq & /*filter_parameters*/,
+    eprosima::fastdds::dds::IContentFilter * & filter_instance) override
+  {
+    if (0 != std::strcmp(filter_class_name, CLIENT_RESPONSE_FILTER_CLASS_NAME)) {
+      return ReturnCode_t::RETCODE_BAD_PARAMETER;
+    }
+
+    // A null expression means only the parameters are updated, and this filter has none
+    if (nullptr == filter_expression && nullptr == filter_instance) {
+      return ReturnCode_t::RETCODE_BAD_PARAMETER;
+    }
+
+    // The filter has no state, so a single instance is shared by every reader
+    filter_instance = &filter_;
+    return ReturnCode_t::RETCODE_OK;
+  }
+
+  ReturnCode_t delete_content_filter(
+    const char * filter_class_name,
+    eprosima::fastdds::dds::IContentFilter * filter_instance) override
+  {
+    if (0 != std::strcmp(filter_class_name, CLIENT_RESPONSE_FILTER_CLASS_NAME) ||
+      &filter_ != filter_instance)
+    {
+      return ReturnCode_t::RETCODE_BAD_PARAMETER;
+    }
+    return ReturnCode_t::RETCODE_OK;
+  }
+
+private:
+  ClientResponseFilter filter_;
+};
+
+}  // namespace
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+bool
+register_client_response_filter_factory(
+  eprosima::fastdds::dds::DomainParticipant * participant)
+{
+  // Stateless, so it can be shared by every participant and outlive all of them
+  static ClientResponseFilterFactory factory;
+  return ReturnCode_t::RETCODE_OK == participant->register_content_filter_factory(
+    CLIENT_RESPONSE_FILTER_CLASS_NAME, &factory);
+}
+
+bool
+create_client_response_filtered_topic(
+  eprosima::fastdds::dds::DomainParticipant * participant,
+  eprosima::fastdds::dds::Topic * response_topic,
+  eprosima::fastdds::dds::ContentFilteredTopic ** content_filtered_topic)
+{
+  static std::atomic<uint32_t> cft_counter{0};
+  std::string cft_topic_name = response_topic->get_name() +
+    CLIENT_RESPONSE_FILTERED_TOPIC_POSTFIX + std::to_string(cft_counter.fetch_add(1));
+  eprosima::fastdds::dds::ContentFilteredTopic * filtered_topic =
+    participant->create_contentfilteredtopic(
+    cft_topic_name,
+    response_topic,
+    CLIENT_RESPONSE_FILTER_EXPRESSION,
+    std::vector<std::string>(),
+    CLIENT_RESPONSE_FILTER_CLASS_NAME);
+  if (filtered_topic == nullptr) {
+    return false;
+  }
+
+  *content_filtered_topic = filtered_topic;
+  return true;
+}
+
+void
+allow_client_response_filters(eprosima::fastdds::dds::DataWriterQos & writer_qos)
+{
+  auto & limits = writer_qos.writer_resource_limits();
+  if (limits.reader_filters_allocation.maximum < limits.matched_subscriber_allocation.maximum) {
+    limits.reader_filters_allocation.maximum = limits.matched_subscriber_allocation.maximum;
+  }
+}
+
+}  // namespace rmw_fastrtps_shared_cpp
@@ -281,12 +281,14 @@ void RMWPublisherEvent::track_unique_subscription(eprosima::fastrtps::rtps::GUID
 {
   std::lock_guard<std::mutex> lock(subscriptions_mutex_);
   subscriptions_.insert(guid);
+  subscription_count_.store(subscriptions_.size(), std::memory_order_release);
 }
 
 void RMWPublisherEvent::untrack_unique_subscription(eprosima::fastrtps::rtps::GUID_t guid)
 {
   std::lock_guard<std::mutex> lock(subscriptions_mutex_);
   subscriptions_.erase(guid);
+  subscription_count_.store(subscriptions_.size(), std::memory_order_release);
 }
 
 size_t RMWPublisherEvent::subscription_count() const
@@ -295,6 +297,12 @@ size_t RMWPublisherEvent::subscription_count() const
   return subscriptions_.size();
 }
 
+bool RMWPublisherEvent::is_matched(const eprosima::fastrtps::rtps::GUID_t & guid) const
+{
+  std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+  return subscriptions_.count(guid) > 0u;
+}
+
 void RMWPublisherEvent::update_deadline(uint32_t total_count, uint32_t total_count_change)
 {
   rcpputils::unique_lock<std::mutex> lock_mutex(on_new_event_m_);
@@ -22,6 +22,23 @@
 
 #include "rcpputils/unique_lock.hpp"
 
+#include "rmw_fastrtps_shared_cpp/local_delivery.hpp"
+#include "rmw_fastrtps_shared_cpp/shared_data_reader.hpp"
+
+// Number of samples the subscription has not taken yet
+static size_t
+get_unread_count(CustomSubscriberInfo * info)
+{
+  if (info->shared_reader_) {
+    return info->shared_reader_->get_unread_count(info);
+  }
+  size_t unread_count = static_cast<size_t>(info->data_reader_->get_unread_count(true));
+  if (info->local_subscription_) {
+    unread_count += info->local_subscription_->get_queue().get_unread_count();
+  }
+  return unread_count;
+}
+
 EventListenerInterface *
 CustomSubscriberInfo::get_listener() const
 {
@@ -331,8 +348,11 @@ void RMWSubscriptionEvent::set_on_new_event_callback(
     }
   }
 
-  subscriber_info_->data_reader_->set_listener(
-    subscriber_info_->data_reader_listener_, status_mask);
+  // A shared reader is always listened to for every status, and forwards them to this listener
+  if (!subscriber_info_->shared_reader_) {
+    subscriber_info_->data_reader_->set_listener(
+      subscriber_info_->data_reader_listener_, status_mask);
+  }
 }
 
 void
@@ -341,7 +361,7 @@ RMWSubscriptionEvent::set_on_new_message_callback(
   rmw_event_callback_t callback)
 {
   if (callback) {
-    auto unread_messages = subscriber_info_->data_reader_->get_unread_count(true);
+    auto unread_messages = get_unread_count(subscriber_info_);
 
     std::lock_guard<std::mutex> lock_mutex(on_new_message_m_);
 
@@ -352,6 +372,10 @@ RMWSubscriptionEvent::set_on_new_message_callback(
     new_message_user_data_ = user_data;
     on_new_message_cb_ = callback;
 
+    if (subscriber_info_->shared_reader_) {
+      return;
+    }
+
     eprosima::fastdds::dds::StatusMask status_mask =
       subscriber_info_->data_reader_->get_status_mask();
     status_mask |= eprosima::fastdds::dds::StatusMask::data_available();
@@ -360,11 +384,15 @@ RMWSubscriptionEvent::set_on_new_message_callback(
   } else {
     std::lock_guard<std::mutex> lock_mutex(on_new_message_m_);
 
-    eprosima::fastdds::dds::StatusMask status_mask =
-      subscriber_info_->data_reader_->get_status_mask();
-    status_mask &= ~eprosima::fastdds::dds::StatusMask::data_available();
-    subscriber_info_->data_reader_->set_listener(
-      subscriber_info_->data_reader_listener_, status_mask);
+    if (!subscriber_info_->shared_reader_) {
+      eprosima::fastdds::dds::StatusMask status_mask =
+        subscriber_info_->data_reader_->get_status_mask();
+      if (!subscriber_info_->data_readiness_.is_enabled()) {
+        status_mask &= ~eprosima::fastdds::dds::StatusMask::data_available();
+      }
+      subscriber_info_->data_reader_->set_listener(
+        subscriber_info_->data_reader_listener_, status_mask);
+    }
 
     new_message_user_data_ = nullptr;
     on_new_message_cb_ = nullptr;
@@ -391,10 +419,12 @@ void RMWSubscriptionEvent::untrack_unique_publisher(eprosima::fastrtps::rtps::GU
 
 void RMWSubscriptionEvent::update_data_available()
 {
+  subscriber_info_->data_readiness_.mark_ready();
+
   rcpputils::unique_lock<std::mutex> lock_mutex(on_new_message_m_);
 
   if (on_new_message_cb_) {
-    auto unread_messages = subscriber_info_->data_reader_->get_unread_count(true);
+    auto unread_messages = get_unread_count(subscriber_info_);
 
     if (0 < unread_messages) {
       on_new_message_cb_(new_message_user_data_, unread_messages);
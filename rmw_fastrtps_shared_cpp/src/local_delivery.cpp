@@ -0,0 +1,330 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "fastcdr/Cdr.h"
+#include "fastcdr/FastBuffer.h"
+#include "fastcdr/exceptions/NotEnoughMemoryException.h"
+
+#include "fastdds/dds/subscriber/SampleInfo.hpp"
+#include "fastdds/rtps/common/InstanceHandle.h"
+#include "fastdds/rtps/common/SequenceNumber.h"
+
+#include "rcutils/allocator.h"
+
+#include "rmw/error_handling.h"
+#include "rmw/serialized_message.h"
+
+#include "rmw_fastrtps_shared_cpp/local_delivery.hpp"
+#include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+namespace
+{
+
+std::shared_ptr<rmw_serialized_message_t>
+make_serialized_message(size_t capacity)
+{
+  auto message = new rmw_serialized_message_t;
+  *message = rmw_get_zero_initialized_serialized_message();
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  if (RMW_RET_OK != rmw_serialized_message_init(message, capacity, &allocator)) {
+    delete message;
+    return nullptr;
+  }
+  return std::shared_ptr<rmw_serialized_message_t>(
+    message,
+    [](rmw_serialized_message_t * msg)
+    {
+      if (RMW_RET_OK != rmw_serialized_message_fini(msg)) {
+        rmw_reset_error();
+      }
+      delete msg;
+    });
+}
+
+std::shared_ptr<const rmw_serialized_message_t>
+copy_to_serialized_message(const void * data, size_t length)
+{
+  std::shared_ptr<rmw_serialized_message_t> message = make_serialized_message(length);
+  if (message) {
+    std::memcpy(message->buffer, data, length);
+    message->buffer_length = length;
+  }
+  return message;
+}
+
+// Serialize a ROS message the same way rmw_serialize does
+std::shared_ptr<const rmw_serialized_message_t>
+serialize_to_serialized_message(
+  const TypeSupport * type_support,
+  const void * ros_message,
+  const void * impl)
+{
+  std::shared_ptr<rmw_serialized_message_t> message = make_serialized_message(
+    type_support->getEstimatedSerializedSize(ros_message, impl));
+  if (!message) {
+    return nullptr;
+  }
+
+  eprosima::fastcdr::FastBuffer buffer(
+    reinterpret_cast<char *>(message->buffer), message->buffer_capacity);
+  eprosima::fastcdr::Cdr ser(
+    buffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN, eprosima::fastcdr::CdrVersion::XCDRv1);
+  ser.set_encoding_flag(eprosima::fastcdr::EncodingAlgorithmFlag::PLAIN_CDR);
+  try {
+    if (!type_support->serializeROSmessage(ros_message, ser, impl)) {
+      return nullptr;
+    }
+  } catch (const eprosima::fastcdr::exception::NotEnoughMemoryException &) {
+    return nullptr;
+  }
+  message->buffer_length = ser.get_serialized_data_length();
+  return message;
+}
+
+}  // namespace
+
+LocalTopic &
+LocalDelivery::get_topic(const eprosima::fastdds::dds::Topic * topic)
+{
+  std::unique_ptr<LocalTopic> & local_topic = topics_[topic];
+  if (!local_topic) {
+    local_topic.reset(new LocalTopic());
+  }
+  return *local_topic;
+}
+
+void
+LocalDelivery::remove_topic_if_unused(const eprosima::fastdds::dds::Topic * topic)
+{
+  auto local_topic = topics_.find(topic);
+  if (topics_.end() == local_topic) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(local_topic->second->mutex_);
+    if (!local_topic->second->publishers_.empty() ||
+      !local_topic->second->subscriptions_.empty())
+    {
+      return;
+    }
+  }
+  topics_.erase(local_topic);
+}
+
+void
+LocalDelivery::add_publisher(CustomPublisherInfo * info)
+{
+  // Writers keeping history for late joiners have to write every message
+  if (!info->skip_write_when_unmatched_) {
+    return;
+  }
+
+  const eprosima::fastrtps::rtps::GUID_t writer_guid = info->data_writer_->guid();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  LocalTopic & topic = get_topic(info->topic_);
+  {
+    std::lock_guard<std::mutex> topic_lock(topic.mutex_);
+    for (const std::shared_ptr<LocalSubscription> & subscription : topic.subscriptions_) {
+      if (subscription->get_type_support_impl() == info->type_support_impl_) {
+        subscription->add_local_writer(writer_guid);
+      }
+    }
+    topic.publishers_.push_back(info);
+  }
+  info->local_topic_ = &topic;
+  info->local_delivery_ = this;
+}
+
+void
+LocalDelivery::remove_publisher(CustomPublisherInfo * info)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto local_topic = topics_.find(info->topic_);
+  if (topics_.end() != local_topic) {
+    {
+      std::lock_guard<std::mutex> topic_lock(local_topic->second->mutex_);
+      std::vector<CustomPublisherInfo *> & infos = local_topic->second->publishers_;
+      infos.erase(std::remove(infos.begin(), infos.end(), info), infos.end());
+    }
+    remove_topic_if_unused(info->topic_);
+  }
+  info->local_delivery_ = nullptr;
+  info->local_topic_ = nullptr;
+}
+
+void
+LocalDelivery::add_subscription(
+  CustomSubscriberInfo * info,
+  const rmw_subscription_options_t * subscription_options)
+{
+  // Filters are evaluated on the samples of the DataReader, and a shared DataReader already
+  // queues the samples of each subscription on its own
+  if (nullptr != info->filtered_topic_ || nullptr != info->shared_reader_ ||
+    subscription_options->ignore_local_publications)
+  {
+    return;
+  }
+
+  auto local_subscription =
+    std::make_shared<LocalSubscription>(get_queue_depth(info->data_reader_->get_qos()), info);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  LocalTopic & topic = get_topic(info->topic_);
+  {
+    std::lock_guard<std::mutex> topic_lock(topic.mutex_);
+    for (CustomPublisherInfo * publisher : topic.publishers_) {
+      if (publisher->type_support_impl_ == info->type_support_impl_) {
+        local_subscription->add_local_writer(publisher->data_writer_->guid());
+      }
+    }
+    topic.subscriptions_.push_back(local_subscription);
+    topic.subscription_count_.store(topic.subscriptions_.size());
+  }
+  info->local_subscription_ = local_subscription;
+}
+
+void
+LocalDelivery::remove_subscription(CustomSubscriberInfo * info)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto local_topic = topics_.find(info->topic_);
+    if (topics_.end() != local_topic) {
+      {
+        LocalTopic & topic = *local_topic->second;
+        std::lock_guard<std::mutex> topic_lock(topic.mutex_);
+        auto & subscriptions = topic.subscriptions_;
+        subscriptions.erase(
+          std::remove(subscriptions.begin(), subscriptions.end(), info->local_subscription_),
+          subscriptions.end());
+        topic.subscription_count_.store(subscriptions.size());
+      }
+      remove_topic_if_unused(info->topic_);
+    }
+  }
+  // Messages being delivered may still be queued, but the listener is not called any more
+  info->local_subscription_->detach();
+  info->local_subscription_.reset();
+}
+
+rmw_ret_t
+LocalDelivery::deliver(
+  CustomPublisherInfo * info,
+  const void * ros_message,
+  const eprosima::fastrtps::Time_t & stamp,
+  bool * write)
+{
+  if (0u == info->local_topic_->subscription_count_.load()) {
+    *write = 0u < info->publisher_event_->subscription_count();
+    return RMW_RET_OK;
+  }
+
+  auto type_support = static_cast<const TypeSupport *>(info->type_support_.get());
+  if (type_support->is_plain()) {
+    return deliver_payload(
+      info, copy_to_serialized_message(ros_message, type_support->get_plain_size()),
+      info->type_support_impl_, stamp, write);
+  }
+  return deliver_payload(
+    info, serialize_to_serialized_message(type_support, ros_message, info->type_support_impl_),
+    nullptr, stamp, write);
+}
+
+rmw_ret_t
+LocalDelivery::deliver_serialized(
+  CustomPublisherInfo * info,
+  const rmw_serialized_message_t * serialized_message,
+  const eprosima::fastrtps::Time_t & stamp,
+  bool * write)
+{
+  if (0u == info->local_topic_->subscription_count_.load()) {
+    *write = 0u < info->publisher_event_->subscription_count();
+    return RMW_RET_OK;
+  }
+
+  return deliver_payload(
+    info, copy_to_serialized_message(serialized_message->buffer, serialized_message->buffer_length),
+    nullptr, stamp, write);
+}
+
+rmw_ret_t
+LocalDelivery::deliver_payload(
+  CustomPublisherInfo * info,
+  const std::shared_ptr<const rmw_serialized_message_t> & payload,
+  const void * plain_impl,
+  const eprosima::fastrtps::Time_t & stamp,
+  bool * write)
+{
+  if (!payload) {
+    // The local subscriptions drop what the DataWriter sends them, so they cannot get it
+    // from there either
+    rmw_reset_error();
+    RMW_SET_ERROR_MSG("cannot copy message for the local subscriptions");
+    return RMW_RET_ERROR;
+  }
+
+  const size_t matched_count = info->publisher_event_->subscription_count();
+  const eprosima::fastrtps::rtps::GUID_t writer_guid = info->data_writer_->guid();
+  eprosima::fastdds::dds::SampleInfo sample_info;
+  sample_info.sample_state = eprosima::fastdds::dds::NOT_READ_SAMPLE_STATE;
+  sample_info.view_state = eprosima::fastdds::dds::NOT_NEW_VIEW_STATE;
+  sample_info.instance_state = eprosima::fastdds::dds::ALIVE_INSTANCE_STATE;
+  sample_info.valid_data = true;
+  sample_info.source_timestamp = stamp;
+  sample_info.reception_timestamp = stamp;
+  sample_info.publication_handle = writer_guid;
+  sample_info.sample_identity.writer_guid(writer_guid);
+
+  std::vector<std::shared_ptr<LocalSubscription>> delivered;
+  {
+    LocalTopic & topic = *info->local_topic_;
+    std::lock_guard<std::mutex> lock(topic.mutex_);
+    // The DataWriter does not number the messages it does not write, so count them apart
+    sample_info.sample_identity.sequence_number(
+      eprosima::fastrtps::rtps::SequenceNumber_t(++info->local_sequence_number_));
+
+    delivered.reserve(topic.subscriptions_.size());
+    for (const std::shared_ptr<LocalSubscription> & subscription : topic.subscriptions_) {
+      // Only deliver to the subscriptions the DataWriter would send the message to
+      if (subscription->get_type_support_impl() != info->type_support_impl_ ||
+        !info->publisher_event_->is_matched(subscription->get_reader_guid()))
+      {
+        continue;
+      }
+      // The payload is shared by the queues of every subscription
+      subscription->get_queue().push(payload, sample_info, plain_impl);
+      delivered.push_back(subscription);
+    }
+  }
+
+  // Listeners are called without the lock, so that other publishers are never kept waiting
+  for (const std::shared_ptr<LocalSubscription> & subscription : delivered) {
+    subscription->notify();
+  }
+
+  *write = delivered.size() < matched_count;
+  return RMW_RET_OK;
+}
+
+}  // namespace rmw_fastrtps_shared_cpp
@@ -40,7 +40,9 @@
 
 #include "rmw/allocators.h"
 
+#include "rmw_fastrtps_shared_cpp/client_response_filter.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
+#include "rmw_fastrtps_shared_cpp/local_delivery.hpp"
 #include "rmw_fastrtps_shared_cpp/participant.hpp"
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
 #include "rmw_fastrtps_shared_cpp/rmw_security_logging.hpp"
@@ -48,13 +50,48 @@
 
 #include "rmw_dds_common/security.hpp"
 
+namespace
+{
+
+// Behaviour of a participant, read from the environment when it is created
+struct ParticipantOptions
+{
+  bool leave_middleware_default_qos{false};
+  publishing_mode_t publishing_mode{publishing_mode_t::SYNCHRONOUS};
+  bool track_data_readiness{false};
+  bool data_sharing_for_plain_types{false};
+  bool xcdr2_for_non_plain_types{false};
+  bool defer_service_responses{false};
+  bool share_data_readers{false};
+  bool local_delivery{false};
+};
+
+/// Read a boolean environment variable, enabled when set to "1".
+/**
+ * \param[out] value false when the variable is not set.
+ * \return false when the variable cannot be read, with the error message set.
+ */
+bool
+read_bool_env(const char * name, bool & value)
+{
+  const char * env_value = nullptr;
+  const char * error_str = rcutils_get_env(name, &env_value);
+  if (error_str != NULL) {
+    RMW_SET_ERROR_MSG_WITH_FORMAT_STRING("Error getting env var %s: %s\n", name, error_str);
+    return false;
+  }
+  value = env_value != nullptr && strcmp(env_value, "1") == 0;
+  return true;
+}
+
+}  // namespace
+
 // Private function to create Participant with QoS
 static CustomParticipantInfo *
 __create_participant(
   const char * identifier,
   const eprosima::fastdds::dds::DomainParticipantQos & domainParticipantQos,
-  bool leave_middleware_default_qos,
-  publishing_mode_t publishing_mode,
+  const ParticipantOptions & options,
   rmw_dds_common::Context * common_context,
   size_t domain_id)
 {
@@ -107,10 +144,31 @@ __create_participant(
     return nullptr;
   }
 
+  if (!rmw_fastrtps_shared_cpp::register_client_response_filter_factory(
+      participant_info->participant_))
+  {
+    RMW_SET_ERROR_MSG("__create_participant failed to register client response filter");
+    return nullptr;
+  }
+
   /////
   // Set participant info parameters
-  participant_info->leave_middleware_default_qos = leave_middleware_default_qos;
-  participant_info->publishing_mode = publishing_mode;
+  participant_info->leave_middleware_default_qos = options.leave_middleware_default_qos;
+  participant_info->publishing_mode = options.publishing_mode;
+  participant_info->track_data_readiness = options.track_data_readiness;
+  participant_info->data_sharing_for_plain_types = options.data_sharing_for_plain_types;
+  participant_info->xcdr2_for_non_plain_types = options.xcdr2_for_non_plain_types;
+  participant_info->defer_service_responses = options.defer_service_responses;
+  participant_info->share_data_readers = options.share_data_readers;
+  if (options.local_delivery) {
+    try {
+      participant_info->local_delivery_ =
+        std::make_shared<rmw_fastrtps_shared_cpp::LocalDelivery>();
+    } catch (std::bad_alloc &) {
+      RMW_SET_ERROR_MSG("__create_participant failed to allocate local delivery");
+      return nullptr;
+    }
+  }
 
   /////
   // Create Publisher
@@ -273,31 +331,25 @@ rmw_fastrtps_shared_cpp::create_participant(
   }
   domainParticipantQos.name(enclave);
 
-  bool leave_middleware_default_qos = false;
-  publishing_mode_t publishing_mode = publishing_mode_t::SYNCHRONOUS;
-  const char * env_value;
-  const char * error_str;
-  error_str = rcutils_get_env("RMW_FASTRTPS_USE_QOS_FROM_XML", &env_value);
-  if (error_str != NULL) {
-    RCUTILS_LOG_DEBUG_NAMED("rmw_fastrtps_shared_cpp", "Error getting env var: %s\n", error_str);
+  ParticipantOptions options;
+  // Variables changing the QoS of entities are ignored when the QoS come from XML
+  if (!read_bool_env("RMW_FASTRTPS_USE_QOS_FROM_XML", options.leave_middleware_default_qos)) {
     return nullptr;
   }
-  if (env_value != nullptr) {
-    leave_middleware_default_qos = strcmp(env_value, "1") == 0;
-  }
-  if (!leave_middleware_default_qos) {
-    error_str = rcutils_get_env("RMW_FASTRTPS_PUBLICATION_MODE", &env_value);
+  if (!options.leave_middleware_default_qos) {
+    const char * env_value = nullptr;
+    const char * error_str = rcutils_get_env("RMW_FASTRTPS_PUBLICATION_MODE", &env_value);
     if (error_str != NULL) {
       RMW_SET_ERROR_MSG_WITH_FORMAT_STRING("Error getting env var: %s\n", error_str);
       return nullptr;
     }
     if (env_value != nullptr) {
       if (strcmp(env_value, "SYNCHRONOUS") == 0) {
-        publishing_mode = publishing_mode_t::SYNCHRONOUS;
+        options.publishing_mode = publishing_mode_t::SYNCHRONOUS;
       } else if (strcmp(env_value, "ASYNCHRONOUS") == 0) {
-        publishing_mode = publishing_mode_t::ASYNCHRONOUS;
+        options.publishing_mode = publishing_mode_t::ASYNCHRONOUS;
       } else if (strcmp(env_value, "AUTO") == 0) {
-        publishing_mode = publishing_mode_t::AUTO;
+        options.publishing_mode = publishing_mode_t::AUTO;
       } else if (strcmp(env_value, "") != 0) {
         RCUTILS_LOG_WARN_NAMED(
           "rmw_fastrtps_shared_cpp",
@@ -305,9 +357,21 @@ rmw_fastrtps_shared_cpp::create_participant(
           ". Using default SYNCHRONOUS publishing mode.", env_value);
       }
     }
+    if (!read_bool_env("RMW_FASTRTPS_USE_DATA_SHARING", options.data_sharing_for_plain_types) ||
+      !read_bool_env("RMW_FASTRTPS_USE_XCDR2", options.xcdr2_for_non_plain_types))
+    {
+      return nullptr;
+    }
+  }
+  if (!read_bool_env("RMW_FASTRTPS_TRACK_DATA_READINESS", options.track_data_readiness) ||
+    !read_bool_env("RMW_FASTRTPS_DEFER_SERVICE_RESPONSES", options.defer_service_responses) ||
+    !read_bool_env("RMW_FASTRTPS_SHARE_DATA_READERS", options.share_data_readers) ||
+    !read_bool_env("RMW_FASTRTPS_LOCAL_DELIVERY", options.local_delivery))
+  {
+    return nullptr;
   }
   // allow reallocation to support discovery messages bigger than 5000 bytes
-  if (!leave_middleware_default_qos) {
+  if (!options.leave_middleware_default_qos) {
     domainParticipantQos.wire_protocol().builtin.readerHistoryMemoryPolicy =
       eprosima::fastrtps::rtps::PREALLOCATED_WITH_REALLOC_MEMORY_MODE;
     domainParticipantQos.wire_protocol().builtin.writerHistoryMemoryPolicy =
@@ -369,8 +433,7 @@ rmw_fastrtps_shared_cpp::create_participant(
   return __create_participant(
     identifier,
     domainParticipantQos,
-    leave_middleware_default_qos,
-    publishing_mode,
+    options,
     common_context,
     domain_id);
 }
@@ -18,6 +18,7 @@
 
 #include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_publisher_info.hpp"
+#include "rmw_fastrtps_shared_cpp/local_delivery.hpp"
 #include "rmw_fastrtps_shared_cpp/publisher.hpp"
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
 #include "rmw_fastrtps_shared_cpp/utils.hpp"
@@ -39,6 +40,10 @@ destroy_publisher(
     // Get RMW Publisher
     auto info = static_cast<CustomPublisherInfo *>(publisher->data);
 
+    if (info->local_delivery_) {
+      info->local_delivery_->remove_publisher(info);
+    }
+
     // Delete DataWriter
     ReturnCode_t ret = participant_info->publisher_->delete_datawriter(info->data_writer_);
     if (ReturnCode_t::RETCODE_OK != ret) {
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <limits>
 #include <vector>
 
@@ -182,7 +183,7 @@ get_datareader_qos(
   eprosima::fastdds::dds::DataReaderQos & datareader_qos)
 {
   if (fill_data_entity_qos_from_profile(qos_policies, type_hash, datareader_qos)) {
-    // The type support in the RMW implementation is always XCDR1.
+    // The type support in the RMW implementation serializes XCDR1, unless XCDR2 is enabled.
     constexpr auto rep = eprosima::fastdds::dds::XCDR_DATA_REPRESENTATION;
     datareader_qos.type_consistency().representation.clear();
     datareader_qos.type_consistency().representation.m_value.push_back(rep);
@@ -199,7 +200,7 @@ get_datawriter_qos(
   eprosima::fastdds::dds::DataWriterQos & datawriter_qos)
 {
   if (fill_data_entity_qos_from_profile(qos_policies, type_hash, datawriter_qos)) {
-    // The type support in the RMW implementation is always XCDR1.
+    // The type support in the RMW implementation serializes XCDR1, unless XCDR2 is enabled.
     constexpr auto rep = eprosima::fastdds::dds::XCDR_DATA_REPRESENTATION;
     datawriter_qos.representation().clear();
     datawriter_qos.representation().m_value.push_back(rep);
@@ -209,6 +210,62 @@ get_datawriter_qos(
   return false;
 }
 
+template<typename DDSEntityQos>
+void
+fill_data_sharing_qos(DDSEntityQos & entity_qos)
+{
+  entity_qos.data_sharing().automatic();
+
+  // Samples of plain types have a fixed size, so they can be fully preallocated
+  entity_qos.endpoint().history_memory_policy =
+    eprosima::fastrtps::rtps::PREALLOCATED_MEMORY_MODE;
+
+  // The shared segment has room for as many samples as the history may hold.
+  // Limit it to the requested depth instead of the default resource limits.
+  if (eprosima::fastdds::dds::KEEP_LAST_HISTORY_QOS == entity_qos.history().kind &&
+    entity_qos.history().depth > 0)
+  {
+    const int32_t depth = entity_qos.history().depth;
+    entity_qos.resource_limits().max_samples = depth;
+    entity_qos.resource_limits().max_samples_per_instance = depth;
+    entity_qos.resource_limits().allocated_samples = depth;
+  }
+}
+
+void
+enable_data_sharing(eprosima::fastdds::dds::DataReaderQos & reader_qos)
+{
+  fill_data_sharing_qos(reader_qos);
+}
+
+void
+enable_data_sharing(eprosima::fastdds::dds::DataWriterQos & writer_qos)
+{
+  fill_data_sharing_qos(writer_qos);
+}
+
+void
+enable_xcdr2(eprosima::fastdds::dds::DataReaderQos & reader_qos)
+{
+  // XCDR1 stays first, as the representation plain types are checked against
+  auto & representations = reader_qos.type_consistency().representation.m_value;
+  if (std::find(
+      representations.begin(), representations.end(),
+      eprosima::fastdds::dds::XCDR2_DATA_REPRESENTATION) == representations.end())
+  {
+    representations.push_back(eprosima::fastdds::dds::XCDR2_DATA_REPRESENTATION);
+  }
+}
+
+void
+enable_xcdr2(eprosima::fastdds::dds::DataWriterQos & writer_qos)
+{
+  // A DataWriter serializes with the first representation it offers
+  writer_qos.representation().clear();
+  writer_qos.representation().m_value.push_back(
+    eprosima::fastdds::dds::XCDR2_DATA_REPRESENTATION);
+}
+
 bool
 get_topic_qos(
   const rmw_qos_profile_t & qos_policies,
@@ -83,6 +83,17 @@ __rmw_destroy_client(
       delete info->listener_;
     }
 
+    // Delete the response filtered topic, now that no reader uses it
+    if (nullptr != info->response_filtered_topic_) {
+      ret = participant_info->participant_->delete_contentfilteredtopic(
+        info->response_filtered_topic_);
+      if (ret != ReturnCode_t::RETCODE_OK) {
+        show_previous_error();
+        RMW_SET_ERROR_MSG("destroy_client() failed to delete response filtered topic");
+        final_ret = RMW_RET_ERROR;
+      }
+    }
+
     // Delete DataWriter
     ret = participant_info->publisher_->delete_datawriter(info->request_writer_);
     if (ret != ReturnCode_t::RETCODE_OK) {
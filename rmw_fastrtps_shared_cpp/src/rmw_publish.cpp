@@ -12,6 +12,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+
 #include "fastcdr/Cdr.h"
 #include "fastcdr/FastBuffer.h"
 
@@ -23,13 +29,134 @@
 #include "rmw/impl/cpp/macros.hpp"
 
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+#include "rmw_fastrtps_shared_cpp/custom_publisher_allocation.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_publisher_info.hpp"
+#include "rmw_fastrtps_shared_cpp/local_delivery.hpp"
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
 
 #include "tracetools/tracetools.h"
 
 namespace rmw_fastrtps_shared_cpp
 {
+
+namespace
+{
+
+/// Check that a publisher allocation, when given, was made for the type of the publisher.
+rmw_ret_t
+check_allocation(
+  const char * identifier,
+  const CustomPublisherInfo * info,
+  const rmw_publisher_allocation_t * allocation)
+{
+  if (nullptr == allocation) {
+    return RMW_RET_OK;
+  }
+  RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
+    publisher allocation, allocation->implementation_identifier, identifier,
+    return RMW_RET_INCORRECT_RMW_IMPLEMENTATION);
+
+  auto publisher_allocation = static_cast<const CustomPublisherAllocation *>(allocation->data);
+  auto type_support = static_cast<const TypeSupport *>(info->type_support_.get());
+  if (!type_support->is_bounded() ||
+    publisher_allocation->max_serialized_size_ != type_support->m_typeSize)
+  {
+    RMW_SET_ERROR_MSG("publisher allocation was not made for the type of the publisher");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+  return RMW_RET_OK;
+}
+
+/// Write a ROS message, sizing its payload with the size hint of the publisher when possible.
+bool
+write_ros_message(
+  CustomPublisherInfo * info,
+  SerializedData & data,
+  const eprosima::fastrtps::Time_t & stamp)
+{
+  auto write = [info, &data, &stamp]() {
+      data.size_exceeded = false;
+      return info->data_writer_->write_w_timestamp(
+        &data, eprosima::fastdds::dds::HANDLE_NIL, stamp);
+    };
+
+  // Bounded types are sized without traversing the messages
+  const bool use_hint = !info->type_support_->is_bounded();
+  bool written = false;
+  if (use_hint) {
+    // Leave some room, so that slightly bigger messages still fit
+    const size_t average = info->average_serialized_size_.load(std::memory_order_relaxed);
+    data.size_hint = (std::min)(
+      average + average / 4u, size_t{std::numeric_limits<uint32_t>::max()});
+    if (0u != data.size_hint) {
+      written = write();
+      if (!written && !data.size_exceeded) {
+        return false;
+      }
+    }
+    // Sized exactly this time
+    data.size_hint = 0u;
+  }
+  if (!written && !write()) {
+    return false;
+  }
+
+  if (use_hint) {
+    // Move the average an eighth of the way towards the size of this message
+    const uint32_t size = static_cast<uint32_t>(
+      (std::min)(data.serialized_size, size_t{std::numeric_limits<uint32_t>::max()}));
+    uint32_t current = info->average_serialized_size_.load(std::memory_order_relaxed);
+    uint32_t average = 0u;
+    do {
+      if (0u == current) {
+        average = size;
+      } else if (size > current) {
+        average = current + static_cast<uint32_t>((uint64_t{size} - current + 7u) / 8u);
+      } else {
+        average = current - (current - size) / 8u;
+      }
+    } while (current != average &&
+      !info->average_serialized_size_.compare_exchange_weak(
+        current, average, std::memory_order_relaxed));
+  }
+  return true;
+}
+
+/// Publish a ROS message with the given source timestamp, once the arguments are checked.
+rmw_ret_t
+publish_ros_message(
+  const rmw_publisher_t * publisher,
+  CustomPublisherInfo * info,
+  const void * ros_message,
+  const eprosima::fastrtps::Time_t & stamp)
+{
+  TRACETOOLS_TRACEPOINT(rmw_publish, publisher, ros_message, stamp.to_ns());
+  if (info->skip_write_when_unmatched_ && !info->publisher_event_->has_subscriptions()) {
+    // Nobody would receive it, and no history is kept for late joiners
+    return RMW_RET_OK;
+  }
+  if (nullptr != info->local_delivery_) {
+    bool write = true;
+    rmw_ret_t ret = info->local_delivery_->deliver(info, ros_message, stamp, &write);
+    if (RMW_RET_OK != ret || !write) {
+      // Either it failed, or every matched subscription already got it
+      return ret;
+    }
+  }
+
+  rmw_fastrtps_shared_cpp::SerializedData data;
+  data.type = FASTRTPS_SERIALIZED_DATA_TYPE_ROS_MESSAGE;
+  data.data = const_cast<void *>(ros_message);
+  data.impl = info->type_support_impl_;
+  if (!write_ros_message(info, data, stamp)) {
+    RMW_SET_ERROR_MSG("cannot publish data");
+    return RMW_RET_ERROR;
+  }
+  return RMW_RET_OK;
+}
+
+}  // namespace
+
 rmw_ret_t
 __rmw_publish(
   const char * identifier,
@@ -41,7 +168,6 @@ __rmw_publish(
   RCUTILS_CAN_RETURN_WITH_ERROR_OF(RMW_RET_INCORRECT_RMW_IMPLEMENTATION);
   RCUTILS_CAN_RETURN_WITH_ERROR_OF(RMW_RET_ERROR);
 
-  (void) allocation;
   RMW_CHECK_FOR_NULL_WITH_MSG(
     publisher, "publisher handle is null",
     return RMW_RET_INVALID_ARGUMENT);
@@ -54,17 +180,65 @@ __rmw_publish(
 
   auto info = static_cast<CustomPublisherInfo *>(publisher->data);
   RCUTILS_CHECK_FOR_NULL_WITH_MSG(info, "publisher info pointer is null", return RMW_RET_ERROR);
+  rmw_ret_t ret = check_allocation(identifier, info, allocation);
+  if (RMW_RET_OK != ret) {
+    return ret;
+  }
 
-  rmw_fastrtps_shared_cpp::SerializedData data;
-  data.type = FASTRTPS_SERIALIZED_DATA_TYPE_ROS_MESSAGE;
-  data.data = const_cast<void *>(ros_message);
-  data.impl = info->type_support_impl_;
+  std::lock_guard<std::mutex> lock(info->write_mutex_);
   eprosima::fastrtps::Time_t stamp;
   eprosima::fastrtps::Time_t::now(stamp);
-  TRACETOOLS_TRACEPOINT(rmw_publish, publisher, ros_message, stamp.to_ns());
-  if (!info->data_writer_->write_w_timestamp(&data, eprosima::fastdds::dds::HANDLE_NIL, stamp)) {
-    RMW_SET_ERROR_MSG("cannot publish data");
-    return RMW_RET_ERROR;
+  return publish_ros_message(publisher, info, ros_message, stamp);
+}
+
+rmw_ret_t
+__rmw_publish_batch(
+  const char * identifier,
+  const rmw_publisher_t * publisher,
+  const void * const * ros_messages,
+  size_t count,
+  rmw_publisher_allocation_t * allocation)
+{
+  RCUTILS_CAN_RETURN_WITH_ERROR_OF(RMW_RET_INVALID_ARGUMENT);
+  RCUTILS_CAN_RETURN_WITH_ERROR_OF(RMW_RET_INCORRECT_RMW_IMPLEMENTATION);
+  RCUTILS_CAN_RETURN_WITH_ERROR_OF(RMW_RET_ERROR);
+
+  RMW_CHECK_FOR_NULL_WITH_MSG(
+    publisher, "publisher handle is null",
+    return RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
+    publisher, publisher->implementation_identifier, identifier,
+    return RMW_RET_INCORRECT_RMW_IMPLEMENTATION);
+  RMW_CHECK_FOR_NULL_WITH_MSG(
+    ros_messages, "ros messages array is null",
+    return RMW_RET_INVALID_ARGUMENT);
+  for (size_t i = 0; i < count; ++i) {
+    RMW_CHECK_FOR_NULL_WITH_MSG(
+      ros_messages[i], "ros message handle is null",
+      return RMW_RET_INVALID_ARGUMENT);
+  }
+
+  auto info = static_cast<CustomPublisherInfo *>(publisher->data);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(info, "publisher info pointer is null", return RMW_RET_ERROR);
+  rmw_ret_t ret = check_allocation(identifier, info, allocation);
+  if (RMW_RET_OK != ret) {
+    return ret;
+  }
+
+  // No other message of the publisher is written in between, and all the messages of the batch
+  // share the same source timestamp
+  std::lock_guard<std::mutex> lock(info->write_mutex_);
+  eprosima::fastrtps::Time_t stamp;
+  eprosima::fastrtps::Time_t::now(stamp);
+  for (size_t i = 0; i < count; ++i) {
+    ret = publish_ros_message(publisher, info, ros_messages[i], stamp);
+    if (RMW_RET_OK != ret) {
+      rmw_error_string_t error = rmw_get_error_string();
+      rmw_reset_error();
+      RMW_SET_ERROR_MSG_WITH_FORMAT_STRING(
+        "%s, %zu out of %zu messages were published", error.str, i, count);
+      return ret;
+    }
   }
 
   return RMW_RET_OK;
@@ -81,7 +255,6 @@ __rmw_publish_serialized_message(
   RCUTILS_CAN_RETURN_WITH_ERROR_OF(RMW_RET_INCORRECT_RMW_IMPLEMENTATION);
   RCUTILS_CAN_RETURN_WITH_ERROR_OF(RMW_RET_ERROR);
 
-  (void) allocation;
   RMW_CHECK_FOR_NULL_WITH_MSG(
     publisher, "publisher handle is null",
     return RMW_RET_INVALID_ARGUMENT);
@@ -94,6 +267,19 @@ __rmw_publish_serialized_message(
 
   auto info = static_cast<CustomPublisherInfo *>(publisher->data);
   RCUTILS_CHECK_FOR_NULL_WITH_MSG(info, "publisher info pointer is null", return RMW_RET_ERROR);
+  rmw_ret_t ret = check_allocation(identifier, info, allocation);
+  if (RMW_RET_OK != ret) {
+    return ret;
+  }
+
+  std::lock_guard<std::mutex> lock(info->write_mutex_);
+  eprosima::fastrtps::Time_t stamp;
+  eprosima::fastrtps::Time_t::now(stamp);
+  TRACETOOLS_TRACEPOINT(rmw_publish, publisher, serialized_message, stamp.to_ns());
+  if (info->skip_write_when_unmatched_ && !info->publisher_event_->has_subscriptions()) {
+    // Nobody would receive it, and no history is kept for late joiners
+    return RMW_RET_OK;
+  }
 
   eprosima::fastcdr::FastBuffer buffer(
     reinterpret_cast<char *>(serialized_message->buffer), serialized_message->buffer_length);
@@ -109,9 +295,13 @@ __rmw_publish_serialized_message(
   data.type = FASTRTPS_SERIALIZED_DATA_TYPE_CDR_BUFFER;
   data.data = &ser;
   data.impl = nullptr;  // not used when type is FASTRTPS_SERIALIZED_DATA_TYPE_CDR_BUFFER
-  eprosima::fastrtps::Time_t stamp;
-  eprosima::fastrtps::Time_t::now(stamp);
-  TRACETOOLS_TRACEPOINT(rmw_publish, publisher, serialized_message, stamp.to_ns());
+  if (nullptr != info->local_delivery_) {
+    bool write = true;
+    ret = info->local_delivery_->deliver_serialized(info, serialized_message, stamp, &write);
+    if (RMW_RET_OK != ret || !write) {
+      return ret;
+    }
+  }
   if (!info->data_writer_->write_w_timestamp(&data, eprosima::fastdds::dds::HANDLE_NIL, stamp)) {
     RMW_SET_ERROR_MSG("cannot publish data");
     return RMW_RET_ERROR;
@@ -143,9 +333,26 @@ __rmw_publish_loaned_message(
   RMW_CHECK_ARGUMENT_FOR_NULL(ros_message, RMW_RET_INVALID_ARGUMENT);
 
   auto info = static_cast<CustomPublisherInfo *>(publisher->data);
+  std::lock_guard<std::mutex> lock(info->write_mutex_);
   eprosima::fastrtps::Time_t stamp;
   eprosima::fastrtps::Time_t::now(stamp);
   TRACETOOLS_TRACEPOINT(rmw_publish, publisher, ros_message, stamp.to_ns());
+  if (nullptr != info->local_delivery_) {
+    bool write = true;
+    rmw_ret_t ret = info->local_delivery_->deliver(info, ros_message, stamp, &write);
+    if (RMW_RET_OK != ret) {
+      return ret;
+    }
+    if (!write) {
+      // The loan is returned to the DataWriter without writing it
+      void * sample = const_cast<void *>(ros_message);
+      if (ReturnCode_t::RETCODE_OK != info->data_writer_->discard_loan(sample)) {
+        RMW_SET_ERROR_MSG("cannot discard loaned message");
+        return RMW_RET_ERROR;
+      }
+      return RMW_RET_OK;
+    }
+  }
   if (!info->data_writer_->write_w_timestamp(
       const_cast<void *>(ros_message),
       eprosima::fastdds::dds::HANDLE_NIL, stamp))
@@ -13,6 +13,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <new>
 #include <string>
 
 #include "rmw/allocators.h"
@@ -24,6 +25,7 @@
 #include "fastdds/dds/publisher/qos/DataWriterQos.hpp"
 
 #include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
+#include "rmw_fastrtps_shared_cpp/custom_publisher_allocation.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_publisher_info.hpp"
 #include "rmw_fastrtps_shared_cpp/namespace_prefix.hpp"
 #include "rmw_fastrtps_shared_cpp/publisher.hpp"
@@ -208,4 +210,45 @@ __rmw_return_loaned_message_from_publisher(
 
   return RMW_RET_OK;
 }
+
+rmw_ret_t
+__rmw_init_publisher_allocation(
+  const char * identifier,
+  size_t max_serialized_size,
+  rmw_publisher_allocation_t * allocation)
+{
+  RMW_CHECK_ARGUMENT_FOR_NULL(allocation, RMW_RET_INVALID_ARGUMENT);
+  if (0u == max_serialized_size) {
+    RMW_SET_ERROR_MSG("publisher allocations are only supported for bounded types");
+    return RMW_RET_UNSUPPORTED;
+  }
+
+  auto publisher_allocation = new (std::nothrow) CustomPublisherAllocation();
+  if (!publisher_allocation) {
+    RMW_SET_ERROR_MSG("failed to allocate publisher allocation");
+    return RMW_RET_BAD_ALLOC;
+  }
+  publisher_allocation->max_serialized_size_ = max_serialized_size;
+
+  allocation->implementation_identifier = identifier;
+  allocation->data = publisher_allocation;
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_fini_publisher_allocation(
+  const char * identifier,
+  rmw_publisher_allocation_t * allocation)
+{
+  RMW_CHECK_ARGUMENT_FOR_NULL(allocation, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
+    publisher allocation,
+    allocation->implementation_identifier, identifier,
+    return RMW_RET_INCORRECT_RMW_IMPLEMENTATION);
+
+  delete static_cast<CustomPublisherAllocation *>(allocation->data);
+  allocation->implementation_identifier = nullptr;
+  allocation->data = nullptr;
+  return RMW_RET_OK;
+}
 }  // namespace rmw_fastrtps_shared_cpp
@@ -13,9 +13,8 @@
 // limitations under the License.
 
 #include <cassert>
-
-#include "fastcdr/Cdr.h"
-#include "fastcdr/FastBuffer.h"
+#include <utility>
+#include <vector>
 
 #include "fastdds/rtps/common/WriteParams.h"
 #include "fastdds/dds/core/StackAllocatedSequence.hpp"
@@ -25,8 +24,11 @@
 #include "rmw/impl/cpp/macros.hpp"
 #include "rmw/types.h"
 
+#include "rcpputils/scope_exit.hpp"
+
 #include "rmw_fastrtps_shared_cpp/custom_client_info.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_service_info.hpp"
+#include "rmw_fastrtps_shared_cpp/custom_subscription_allocation.hpp"
 #include "rmw_fastrtps_shared_cpp/guid_utils.hpp"
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
@@ -78,6 +80,37 @@ __rmw_send_request(
   return returnedValue;
 }
 
+static void
+_fill_request_header(
+  CustomServiceInfo * info,
+  const eprosima::fastdds::dds::SampleInfo & sample_info,
+  rmw_service_info_t * request_header)
+{
+  CustomServiceRequest request;
+  request.sample_identity_ = sample_info.sample_identity;
+  // Use response subscriber guid (on related_sample_identity) when present.
+  const eprosima::fastrtps::rtps::GUID_t & reader_guid =
+    sample_info.related_sample_identity.writer_guid();
+  if (reader_guid != eprosima::fastrtps::rtps::GUID_t::unknown()) {
+    request.sample_identity_.writer_guid() = reader_guid;
+  }
+
+  // Save both guids in the clients_endpoints map
+  const eprosima::fastrtps::rtps::GUID_t & writer_guid =
+    sample_info.sample_identity.writer_guid();
+  info->pub_listener_->endpoint_add_reader_and_writer(reader_guid, writer_guid);
+
+  // Get header
+  rmw_fastrtps_shared_cpp::copy_from_fastrtps_guid_to_byte_array(
+    request.sample_identity_.writer_guid(),
+    request_header->request_id.writer_guid);
+  request_header->request_id.sequence_number =
+    ((int64_t)request.sample_identity_.sequence_number().high) <<
+    32 | request.sample_identity_.sequence_number().low;
+  request_header->source_timestamp = sample_info.source_timestamp.to_ns();
+  request_header->received_timestamp = sample_info.source_timestamp.to_ns();
+}
+
 rmw_ret_t
 __rmw_take_request(
   const char * identifier,
@@ -100,56 +133,21 @@ __rmw_take_request(
   auto info = static_cast<CustomServiceInfo *>(service->data);
   assert(info);
 
-  CustomServiceRequest request;
+  // The request is deserialized straight from the payload held by the reader
+  rmw_fastrtps_shared_cpp::SerializedData data;
+  data.type = FASTRTPS_SERIALIZED_DATA_TYPE_ROS_MESSAGE;
+  data.data = ros_request;
+  data.impl = info->request_type_support_impl_;
 
-  request.buffer_ = new eprosima::fastcdr::FastBuffer();
-
-  if (request.buffer_ != nullptr) {
-    rmw_fastrtps_shared_cpp::SerializedData data;
-    data.type = FASTRTPS_SERIALIZED_DATA_TYPE_CDR_BUFFER;
-    data.data = request.buffer_;
-    data.impl = nullptr;  // not used when type is FASTRTPS_SERIALIZED_DATA_TYPE_CDR_BUFFER
-
-    eprosima::fastdds::dds::StackAllocatedSequence<void *, 1> data_values;
-    const_cast<void **>(data_values.buffer())[0] = &data;
-    eprosima::fastdds::dds::SampleInfoSeq info_seq{1};
-
-    if (ReturnCode_t::RETCODE_OK == info->request_reader_->take(data_values, info_seq, 1)) {
-      if (info_seq[0].valid_data) {
-        request.sample_identity_ = info_seq[0].sample_identity;
-        // Use response subscriber guid (on related_sample_identity) when present.
-        const eprosima::fastrtps::rtps::GUID_t & reader_guid =
-          info_seq[0].related_sample_identity.writer_guid();
-        if (reader_guid != eprosima::fastrtps::rtps::GUID_t::unknown()) {
-          request.sample_identity_.writer_guid() = reader_guid;
-        }
-
-        // Save both guids in the clients_endpoints map
-        const eprosima::fastrtps::rtps::GUID_t & writer_guid =
-          info_seq[0].sample_identity.writer_guid();
-        info->pub_listener_->endpoint_add_reader_and_writer(reader_guid, writer_guid);
-
-        auto raw_type_support = dynamic_cast<rmw_fastrtps_shared_cpp::TypeSupport *>(
-          info->response_type_support_.get());
-        eprosima::fastcdr::Cdr deser(*request.buffer_, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN);
-        if (raw_type_support->deserializeROSmessage(
-            deser, ros_request, info->request_type_support_impl_))
-        {
-          // Get header
-          rmw_fastrtps_shared_cpp::copy_from_fastrtps_guid_to_byte_array(
-            request.sample_identity_.writer_guid(),
-            request_header->request_id.writer_guid);
-          request_header->request_id.sequence_number =
-            ((int64_t)request.sample_identity_.sequence_number().high) <<
-            32 | request.sample_identity_.sequence_number().low;
-          request_header->source_timestamp = info_seq[0].source_timestamp.to_ns();
-          request_header->received_timestamp = info_seq[0].source_timestamp.to_ns();
-          *taken = true;
-        }
-      }
-    }
+  eprosima::fastdds::dds::StackAllocatedSequence<void *, 1> data_values;
+  const_cast<void **>(data_values.buffer())[0] = &data;
+  eprosima::fastdds::dds::SampleInfoSeq info_seq{1};
 
-    delete request.buffer_;
+  if (ReturnCode_t::RETCODE_OK == info->request_reader_->take(data_values, info_seq, 1)) {
+    if (info_seq[0].valid_data) {
+      _fill_request_header(info, info_seq[0], request_header);
+      *taken = true;
+    }
   }
 
   TRACETOOLS_TRACEPOINT(
@@ -162,4 +160,92 @@ __rmw_take_request(
   return RMW_RET_OK;
 }
 
+rmw_ret_t
+__rmw_take_request_sequence(
+  const char * identifier,
+  const rmw_service_t * service,
+  size_t count,
+  void ** ros_requests,
+  rmw_service_info_t * request_headers,
+  size_t * taken)
+{
+  RMW_CHECK_ARGUMENT_FOR_NULL(service, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
+    service,
+    service->implementation_identifier, identifier,
+    return RMW_RET_INCORRECT_RMW_IMPLEMENTATION);
+  RMW_CHECK_ARGUMENT_FOR_NULL(ros_requests, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_ARGUMENT_FOR_NULL(request_headers, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_ARGUMENT_FOR_NULL(taken, RMW_RET_INVALID_ARGUMENT);
+  if (0u == count) {
+    RMW_SET_ERROR_MSG("count cannot be 0");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  *taken = 0u;
+
+  auto info = static_cast<CustomServiceInfo *>(service->data);
+  assert(info);
+
+  std::vector<rmw_fastrtps_shared_cpp::SerializedData> data(count);
+  DataPointerSequence data_values(static_cast<DataPointerSequence::size_type>(count));
+  eprosima::fastdds::dds::SampleInfoSeq info_seq{static_cast<int32_t>(count)};
+
+  while (*taken < count) {
+    // Requests are deserialized straight into the free slots of ros_requests
+    const size_t first_slot = *taken;
+    const size_t remaining = count - first_slot;
+    for (size_t ii = 0; ii < remaining; ++ii) {
+      data[ii].type = FASTRTPS_SERIALIZED_DATA_TYPE_ROS_MESSAGE;
+      data[ii].data = ros_requests[first_slot + ii];
+      data[ii].impl = info->request_type_support_impl_;
+      data_values.set(static_cast<DataPointerSequence::size_type>(ii), &data[ii]);
+    }
+
+    if (ReturnCode_t::RETCODE_OK != info->request_reader_->take(
+        data_values, info_seq, static_cast<int32_t>(remaining)))
+    {
+      break;
+    }
+
+    auto reset = rcpputils::make_scope_exit(
+      [&]()
+      {
+        data_values.length(0);
+        info_seq.length(0);
+      });
+
+    const size_t received = static_cast<size_t>(info_seq.length());
+    for (size_t ii = 0; ii < received; ++ii) {
+      if (!info_seq[ii].valid_data) {
+        continue;
+      }
+
+      // Keep the taken requests contiguous by swapping the request pointers over the slots
+      // left behind by samples without data. The caller still owns every pointer in the array.
+      const size_t slot = *taken;
+      if (slot != first_slot + ii) {
+        std::swap(ros_requests[slot], ros_requests[first_slot + ii]);
+      }
+      _fill_request_header(info, info_seq[ii], &request_headers[slot]);
+      (*taken)++;
+
+      TRACETOOLS_TRACEPOINT(
+        rmw_take_request,
+        static_cast<const void *>(service),
+        static_cast<const void *>(ros_requests[slot]),
+        request_headers[slot].request_id.writer_guid,
+        request_headers[slot].request_id.sequence_number,
+        true);
+    }
+
+    if (received < remaining) {
+      // The reader has no more requests available
+      break;
+    }
+  }
+
+  return RMW_RET_OK;
+}
+
 }  // namespace rmw_fastrtps_shared_cpp
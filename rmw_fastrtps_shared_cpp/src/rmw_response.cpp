@@ -13,11 +13,16 @@
 // limitations under the License.
 
 #include <cassert>
+#include <new>
+#include <utility>
 
 #include "fastcdr/Cdr.h"
+#include "fastcdr/FastBuffer.h"
 
 #include "fastdds/rtps/common/WriteParams.h"
+#include "fastdds/dds/core/LoanableCollection.hpp"
 #include "fastdds/dds/core/StackAllocatedSequence.hpp"
+#include "fastdds/dds/subscriber/SampleInfo.hpp"
 
 #include "rmw/error_handling.h"
 #include "rmw/rmw.h"
@@ -33,6 +38,89 @@
 
 namespace rmw_fastrtps_shared_cpp
 {
+
+// Collection only used to take samples through a loan, to discard them
+struct DiscardedSampleSequence : public eprosima::fastdds::dds::LoanableCollection
+{
+  void resize(
+    size_type /*new_length*/) override
+  {
+    // This kind of collection should only be used with loans
+    throw std::bad_alloc();
+  }
+};
+
+static bool
+is_response_for_client(
+  const CustomClientInfo * info,
+  const eprosima::fastdds::dds::SampleInfo & sample_info)
+{
+  const eprosima::fastrtps::rtps::GUID_t & guid =
+    sample_info.related_sample_identity.writer_guid();
+  return guid == info->reader_guid_ || guid == info->writer_guid_;
+}
+
+static void
+_fill_response_header(
+  const eprosima::fastdds::dds::SampleInfo & sample_info,
+  rmw_service_info_t * request_header)
+{
+  CustomClientResponse response;
+  response.sample_identity_ = sample_info.related_sample_identity;
+  request_header->source_timestamp = sample_info.source_timestamp.to_ns();
+  request_header->received_timestamp = sample_info.reception_timestamp.to_ns();
+  request_header->request_id.sequence_number =
+    ((int64_t)response.sample_identity_.sequence_number().high) <<
+    32 | response.sample_identity_.sequence_number().low;
+}
+
+// Take the next response of the reader of a client, only deserializing it when it is for the
+// client. Returns false when the reader has no response left.
+static bool
+_take_next_response(
+  CustomClientInfo * info,
+  void * ros_response,
+  rmw_service_info_t * request_header,
+  bool * taken)
+{
+  *taken = false;
+
+  // Every client of a service receives the responses to all of them.
+  // Check who the next response is for before taking it, so the responses to other clients
+  // are never deserialized.
+  eprosima::fastdds::dds::SampleInfo next_info;
+  if (ReturnCode_t::RETCODE_OK != info->response_reader_->get_first_untaken_info(&next_info)) {
+    return false;
+  }
+
+  if (next_info.valid_data && !is_response_for_client(info, next_info)) {
+    // Take it through a loan, which only holds a copy of the serialized response
+    DiscardedSampleSequence data_values;
+    eprosima::fastdds::dds::SampleInfoSeq info_seq;
+    if (ReturnCode_t::RETCODE_OK == info->response_reader_->take(data_values, info_seq, 1)) {
+      info->response_reader_->return_loan(data_values, info_seq);
+    }
+  } else {
+    // The response is deserialized straight from the payload held by the reader
+    rmw_fastrtps_shared_cpp::SerializedData data;
+    data.type = FASTRTPS_SERIALIZED_DATA_TYPE_ROS_MESSAGE;
+    data.data = ros_response;
+    data.impl = info->response_type_support_impl_;
+
+    eprosima::fastdds::dds::StackAllocatedSequence<void *, 1> data_values;
+    const_cast<void **>(data_values.buffer())[0] = &data;
+    eprosima::fastdds::dds::SampleInfoSeq info_seq{1};
+
+    if (ReturnCode_t::RETCODE_OK == info->response_reader_->take(data_values, info_seq, 1)) {
+      if (info_seq[0].valid_data && is_response_for_client(info, info_seq[0])) {
+        _fill_response_header(info_seq[0], request_header);
+        *taken = true;
+      }
+    }
+  }
+  return true;
+}
+
 rmw_ret_t
 __rmw_take_response(
   const char * identifier,
@@ -50,50 +138,10 @@ __rmw_take_response(
   RMW_CHECK_ARGUMENT_FOR_NULL(ros_response, RMW_RET_INVALID_ARGUMENT);
   RMW_CHECK_ARGUMENT_FOR_NULL(taken, RMW_RET_INVALID_ARGUMENT);
 
-  *taken = false;
-
   auto info = static_cast<CustomClientInfo *>(client->data);
   assert(info);
 
-  CustomClientResponse response;
-
-  // Todo(sloretz) eliminate heap allocation pending eprosima/Fast-CDR#19
-  response.buffer_.reset(new eprosima::fastcdr::FastBuffer());
-  rmw_fastrtps_shared_cpp::SerializedData data;
-  data.type = FASTRTPS_SERIALIZED_DATA_TYPE_CDR_BUFFER;
-  data.data = response.buffer_.get();
-  data.impl = nullptr;  // not used when type is FASTRTPS_SERIALIZED_DATA_TYPE_CDR_BUFFER
-
-  eprosima::fastdds::dds::StackAllocatedSequence<void *, 1> data_values;
-  const_cast<void **>(data_values.buffer())[0] = &data;
-  eprosima::fastdds::dds::SampleInfoSeq info_seq{1};
-
-  if (ReturnCode_t::RETCODE_OK == info->response_reader_->take(data_values, info_seq, 1)) {
-    if (info_seq[0].valid_data) {
-      response.sample_identity_ = info_seq[0].related_sample_identity;
-
-      if (response.sample_identity_.writer_guid() == info->reader_guid_ ||
-        response.sample_identity_.writer_guid() == info->writer_guid_)
-      {
-        auto raw_type_support = dynamic_cast<rmw_fastrtps_shared_cpp::TypeSupport *>(
-          info->response_type_support_.get());
-        eprosima::fastcdr::Cdr deser(
-          *response.buffer_,
-          eprosima::fastcdr::Cdr::DEFAULT_ENDIAN);
-        if (raw_type_support->deserializeROSmessage(
-            deser, ros_response, info->response_type_support_impl_))
-        {
-          request_header->source_timestamp = info_seq[0].source_timestamp.to_ns();
-          request_header->received_timestamp = info_seq[0].reception_timestamp.to_ns();
-          request_header->request_id.sequence_number =
-            ((int64_t)response.sample_identity_.sequence_number().high) <<
-            32 | response.sample_identity_.sequence_number().low;
-
-          *taken = true;
-        }
-      }
-    }
-  }
+  _take_next_response(info, ros_response, request_header, taken);
 
   TRACETOOLS_TRACEPOINT(
     rmw_take_response,
@@ -105,6 +153,57 @@ __rmw_take_response(
   return RMW_RET_OK;
 }
 
+rmw_ret_t
+__rmw_take_response_sequence(
+  const char * identifier,
+  const rmw_client_t * client,
+  size_t count,
+  void ** ros_responses,
+  rmw_service_info_t * request_headers,
+  size_t * taken)
+{
+  RMW_CHECK_ARGUMENT_FOR_NULL(client, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
+    client,
+    client->implementation_identifier, identifier,
+    return RMW_RET_INCORRECT_RMW_IMPLEMENTATION);
+  RMW_CHECK_ARGUMENT_FOR_NULL(ros_responses, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_ARGUMENT_FOR_NULL(request_headers, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_ARGUMENT_FOR_NULL(taken, RMW_RET_INVALID_ARGUMENT);
+  if (0u == count) {
+    RMW_SET_ERROR_MSG("count cannot be 0");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  *taken = 0u;
+
+  auto info = static_cast<CustomClientInfo *>(client->data);
+  assert(info);
+
+  // Responses are taken one by one, as who each one is for has to be checked before it is
+  // deserialized into the next free slot of ros_responses
+  bool response_taken = false;
+  while (*taken < count &&
+    _take_next_response(
+      info, ros_responses[*taken], &request_headers[*taken], &response_taken))
+  {
+    if (!response_taken) {
+      continue;
+    }
+    const size_t slot = (*taken)++;
+
+    TRACETOOLS_TRACEPOINT(
+      rmw_take_response,
+      static_cast<const void *>(client),
+      static_cast<const void *>(ros_responses[slot]),
+      request_headers[slot].request_id.sequence_number,
+      request_headers[slot].source_timestamp,
+      true);
+  }
+
+  return RMW_RET_OK;
+}
+
 rmw_ret_t
 __rmw_send_response(
   const char * identifier,
@@ -146,21 +245,32 @@ __rmw_send_response(
   constexpr uint8_t entity_id_is_reader_bit = 0x04;
   const eprosima::fastrtps::rtps::GUID_t & related_guid =
     wparams.related_sample_identity().writer_guid();
+  bool defer_response = false;
   if ((related_guid.entityId.value[3] & entity_id_is_reader_bit) != 0) {
     // Related guid is a reader, so it is the response subscription guid.
-    // Wait for the response writer to be matched with it.
     auto listener = info->pub_listener_;
-    auto writer_max_blocking_time =
-      info->response_writer_->get_qos().reliability().max_blocking_time;
-    auto max_blocking_time =
-      std::chrono::seconds(writer_max_blocking_time.seconds) +
-      std::chrono::nanoseconds(writer_max_blocking_time.nanosec);
-    client_present_t ret = listener->check_for_subscription(related_guid, max_blocking_time);
-    if (ret == client_present_t::GONE) {
-      return RMW_RET_OK;
-    } else if (ret == client_present_t::MAYBE) {
-      RMW_SET_ERROR_MSG("client will not receive response");
-      return RMW_RET_TIMEOUT;
+    if (info->defer_responses_) {
+      // Instead of waiting for the response writer to be matched with it, let the listener
+      // queue the response and write it once they are matched.
+      client_present_t ret = listener->check_for_deferred_subscription(related_guid);
+      if (ret == client_present_t::GONE) {
+        return RMW_RET_OK;
+      }
+      defer_response = (ret == client_present_t::MAYBE);
+    } else {
+      // Wait for the response writer to be matched with it.
+      auto writer_max_blocking_time =
+        info->response_writer_->get_qos().reliability().max_blocking_time;
+      auto max_blocking_time =
+        std::chrono::seconds(writer_max_blocking_time.seconds) +
+        std::chrono::nanoseconds(writer_max_blocking_time.nanosec);
+      client_present_t ret = listener->check_for_subscription(related_guid, max_blocking_time);
+      if (ret == client_present_t::GONE) {
+        return RMW_RET_OK;
+      } else if (ret == client_present_t::MAYBE) {
+        RMW_SET_ERROR_MSG("client will not receive response");
+        return RMW_RET_TIMEOUT;
+      }
     }
   }
 
@@ -178,6 +288,29 @@ __rmw_send_response(
   data.type = FASTRTPS_SERIALIZED_DATA_TYPE_ROS_MESSAGE;
   data.data = const_cast<void *>(ros_response);
   data.impl = info->response_type_support_impl_;
+  if (defer_response) {
+    auto type_support = static_cast<rmw_fastrtps_shared_cpp::TypeSupport *>(
+      info->response_type_support_.get());
+    CustomServiceDeferredResponse deferred;
+    deferred.buffer_.resize(type_support->getEstimatedSerializedSize(ros_response, data.impl));
+    eprosima::fastcdr::FastBuffer buffer(deferred.buffer_.data(), deferred.buffer_.size());
+    eprosima::fastcdr::Cdr ser(
+      buffer, eprosima::fastcdr::Cdr::DEFAULT_ENDIAN, eprosima::fastcdr::CdrVersion::XCDRv1);
+    ser.set_encoding_flag(eprosima::fastcdr::EncodingAlgorithmFlag::PLAIN_CDR);
+    if (!type_support->serializeROSmessage(ros_response, ser, data.impl)) {
+      RMW_SET_ERROR_MSG("cannot serialize response");
+      return RMW_RET_ERROR;
+    }
+    deferred.buffer_.resize(ser.get_serialized_data_length());
+    deferred.wparams_ = wparams;
+
+    client_present_t ret = info->pub_listener_->defer_response(related_guid, std::move(deferred));
+    if (ret != client_present_t::YES) {
+      // Either queued or the client is gone
+      return RMW_RET_OK;
+    }
+    // The reader was matched meanwhile, so just write it
+  }
   if (info->response_writer_->write(&data, wparams)) {
     returnedValue = RMW_RET_OK;
   } else {
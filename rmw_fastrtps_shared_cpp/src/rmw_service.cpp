@@ -97,6 +97,11 @@ __rmw_destroy_service(
       info->listener_ = nullptr;
     }
 
+    // Stop writing deferred responses
+    if (nullptr != info->pub_listener_) {
+      info->pub_listener_->stop_flushing();
+    }
+
     // Delete DataWriter
     ret = participant_info->publisher_->delete_datawriter(info->response_writer_);
     if (ret != ReturnCode_t::RETCODE_OK) {
@@ -29,11 +29,57 @@
 
 #include "demangle.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_client_info.hpp"
+#include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
 #include "rmw_fastrtps_shared_cpp/rmw_context_impl.hpp"
 
 namespace rmw_fastrtps_shared_cpp
 {
+static rmw_ret_t
+__graph_has_service_server(
+  rmw_dds_common::Context * common_context,
+  const CustomClientInfo * client_info,
+  bool * is_available)
+{
+  auto pub_topic_name = client_info->request_topic_name_;
+
+  auto sub_topic_name = client_info->response_topic_name_;
+
+  *is_available = false;
+
+  size_t number_of_request_subscribers = 0;
+  rmw_ret_t ret =
+    common_context->graph_cache.get_reader_count(pub_topic_name, &number_of_request_subscribers);
+  if (ret != RMW_RET_OK) {
+    // error
+    return ret;
+  }
+  if (0 == number_of_request_subscribers) {
+    // not ready
+    return RMW_RET_OK;
+  }
+
+  size_t number_of_response_publishers = 0;
+  ret =
+    common_context->graph_cache.get_writer_count(sub_topic_name, &number_of_response_publishers);
+  if (ret != RMW_RET_OK) {
+    // error
+    return ret;
+  }
+  if (0 == number_of_response_publishers) {
+    // not ready
+    return RMW_RET_OK;
+  }
+
+  if (number_of_request_subscribers != number_of_response_publishers) {
+    // not ready
+    return RMW_RET_OK;
+  }
+
+  *is_available = true;
+  return RMW_RET_OK;
+}
+
 rmw_ret_t
 __rmw_service_server_is_available(
   const char * identifier,
@@ -72,59 +118,40 @@ __rmw_service_server_is_available(
     return RMW_RET_ERROR;
   }
 
-  auto pub_topic_name = client_info->request_topic_name_;
-
-  auto sub_topic_name = client_info->response_topic_name_;
-
   *is_available = false;
-  auto common_context = static_cast<rmw_dds_common::Context *>(node->context->impl->common);
-
-  size_t number_of_request_subscribers = 0;
-  rmw_ret_t ret =
-    common_context->graph_cache.get_reader_count(pub_topic_name, &number_of_request_subscribers);
-  if (ret != RMW_RET_OK) {
-    // error
-    return ret;
-  }
-  if (0 == number_of_request_subscribers) {
-    // not ready
-    return RMW_RET_OK;
-  }
-
-  size_t number_of_response_publishers = 0;
-  ret =
-    common_context->graph_cache.get_writer_count(sub_topic_name, &number_of_response_publishers);
-  if (ret != RMW_RET_OK) {
-    // error
-    return ret;
-  }
-  if (0 == number_of_response_publishers) {
-    // not ready
-    return RMW_RET_OK;
-  }
-
-  if (number_of_request_subscribers != number_of_response_publishers) {
-    // not ready
-    return RMW_RET_OK;
-  }
 
+  // The listeners keep track of the endpoints the client is matched with
   size_t matched_request_pubs = client_info->request_publisher_matched_count_.load();
   if (0 == matched_request_pubs) {
     // not ready
     return RMW_RET_OK;
   }
   size_t matched_response_subs = client_info->response_subscriber_matched_count_.load();
-  if (0 == matched_response_subs) {
-    // not ready
-    return RMW_RET_OK;
-  }
   if (matched_request_pubs != matched_response_subs) {
     // not ready
     return RMW_RET_OK;
   }
 
-  // all conditions met, there is a service server available
-  *is_available = true;
+  // The graph only needs to be checked again if it changed since the last check
+  auto participant_info =
+    static_cast<CustomParticipantInfo *>(node->context->impl->participant_info);
+  uint64_t graph_change_count = participant_info->graph_change_count_.load();
+  uint64_t graph_availability = client_info->graph_availability_.load();
+  if ((graph_availability >> 1) != graph_change_count + 1) {
+    bool graph_available = false;
+    rmw_ret_t ret = __graph_has_service_server(
+      static_cast<rmw_dds_common::Context *>(node->context->impl->common),
+      client_info, &graph_available);
+    if (ret != RMW_RET_OK) {
+      // error
+      return ret;
+    }
+    graph_availability = ((graph_change_count + 1) << 1) | (graph_available ? 1u : 0u);
+    client_info->graph_availability_.store(graph_availability);
+  }
+
+  // if the graph also has a server, all conditions are met
+  *is_available = (graph_availability & 1u) != 0;
   return RMW_RET_OK;
 }
 }  // namespace rmw_fastrtps_shared_cpp
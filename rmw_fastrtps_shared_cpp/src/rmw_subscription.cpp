@@ -13,6 +13,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <new>
 #include <utility>
 #include <string>
 
@@ -27,6 +28,7 @@
 
 #include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_subscriber_info.hpp"
+#include "rmw_fastrtps_shared_cpp/custom_subscription_allocation.hpp"
 #include "rmw_fastrtps_shared_cpp/namespace_prefix.hpp"
 #include "rmw_fastrtps_shared_cpp/qos.hpp"
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
@@ -57,6 +59,9 @@ __rmw_destroy_subscription(
     info->subscription_gid_,
     node->name, node->namespace_
   );
+  if (info->synthetic_gid_) {
+    common_context->graph_cache.remove_entity(info->subscription_gid_, true);
+  }
   if (RMW_RET_OK != ret) {
     error_state = *rmw_get_error_state();
     error_string = rmw_get_error_string();
@@ -111,6 +116,11 @@ __rmw_subscription_set_content_filter(
 )
 {
   auto info = static_cast<CustomSubscriberInfo *>(subscription->data);
+  if (info->shared_reader_) {
+    RMW_SET_ERROR_MSG("content filters are not supported on shared data readers");
+    return RMW_RET_UNSUPPORTED;
+  }
+
   eprosima::fastdds::dds::ContentFilteredTopic * filtered_topic = info->filtered_topic_;
   const bool filter_expression_empty = (*options->filter_expression == '\0');
 
@@ -187,6 +197,10 @@ __rmw_subscription_set_content_filter(
   info->data_reader_->get_statuscondition().set_enabled_statuses(
     eprosima::fastdds::dds::StatusMask::data_available());
 
+  if (info->data_readiness_.is_enabled()) {
+    info->data_readiness_.enable(info->data_reader_, info->data_reader_listener_);
+  }
+
   // lambda to delete datareader
   auto cleanup_datareader = rcpputils::make_scope_exit(
     [subscriber, info]()
@@ -264,4 +278,42 @@ __rmw_subscription_set_on_new_message_callback(
   return RMW_RET_OK;
 }
 
+rmw_ret_t
+__rmw_init_subscription_allocation(
+  const char * identifier,
+  size_t max_serialized_size,
+  rmw_subscription_allocation_t * allocation)
+{
+  RMW_CHECK_ARGUMENT_FOR_NULL(allocation, RMW_RET_INVALID_ARGUMENT);
+
+  CustomSubscriptionAllocation * scratch = nullptr;
+  try {
+    scratch = new CustomSubscriptionAllocation(max_serialized_size);
+  } catch (const std::bad_alloc &) {
+    RMW_SET_ERROR_MSG("failed to allocate subscription allocation");
+    return RMW_RET_BAD_ALLOC;
+  }
+
+  allocation->implementation_identifier = identifier;
+  allocation->data = scratch;
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_fini_subscription_allocation(
+  const char * identifier,
+  rmw_subscription_allocation_t * allocation)
+{
+  RMW_CHECK_ARGUMENT_FOR_NULL(allocation, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
+    subscription allocation,
+    allocation->implementation_identifier, identifier,
+    return RMW_RET_INCORRECT_RMW_IMPLEMENTATION);
+
+  delete static_cast<CustomSubscriptionAllocation *>(allocation->data);
+  allocation->implementation_identifier = nullptr;
+  allocation->data = nullptr;
+  return RMW_RET_OK;
+}
+
 }  // namespace rmw_fastrtps_shared_cpp
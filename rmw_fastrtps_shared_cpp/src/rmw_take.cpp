@@ -13,7 +13,9 @@
 // limitations under the License.
 
 #include <memory>
+#include <mutex>
 #include <utility>
+#include <vector>
 
 #include "rmw/allocators.h"
 #include "rmw/error_handling.h"
@@ -29,8 +31,11 @@
 #include "fastcdr/FastBuffer.h"
 
 #include "rmw_fastrtps_shared_cpp/custom_subscriber_info.hpp"
+#include "rmw_fastrtps_shared_cpp/custom_subscription_allocation.hpp"
 #include "rmw_fastrtps_shared_cpp/guid_utils.hpp"
+#include "rmw_fastrtps_shared_cpp/local_delivery.hpp"
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+#include "rmw_fastrtps_shared_cpp/shared_data_reader.hpp"
 #include "rmw_fastrtps_shared_cpp/subscription.hpp"
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
 #include "rmw_fastrtps_shared_cpp/utils.hpp"
@@ -66,6 +71,127 @@ _assign_message_info(
     sender_gid->data);
 }
 
+// Get the scratch storage of a subscription allocation, nullptr when there is no allocation
+rmw_ret_t
+_get_allocation_scratch(
+  const char * identifier,
+  rmw_subscription_allocation_t * allocation,
+  CustomSubscriptionAllocation ** scratch)
+{
+  *scratch = nullptr;
+  if (nullptr != allocation) {
+    RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
+      subscription allocation,
+      allocation->implementation_identifier, identifier,
+      return RMW_RET_INCORRECT_RMW_IMPLEMENTATION);
+    *scratch = static_cast<CustomSubscriptionAllocation *>(allocation->data);
+  }
+  return RMW_RET_OK;
+}
+
+// Collections to take a single sample into `data`, those of the allocation scratch if any.
+// The scratch collections are always used together: sequence takes grow both their maximums,
+// and Fast DDS rejects collections whose maximums differ.
+class SingleSampleCollections
+{
+public:
+  SingleSampleCollections(
+    CustomSubscriptionAllocation * scratch,
+    rmw_fastrtps_shared_cpp::SerializedData * data)
+  : own_info_seq_(scratch ? 0 : 1),
+    data_values_(scratch ? static_cast<eprosima::fastdds::dds::LoanableCollection &>(
+        scratch->data_values_) : own_data_values_),
+    info_seq_(scratch ? scratch->info_seq_ : own_info_seq_)
+  {
+    if (scratch) {
+      scratch->data_values_.set(0, data);
+    } else {
+      const_cast<void **>(own_data_values_.buffer())[0] = data;
+    }
+  }
+
+  eprosima::fastdds::dds::LoanableCollection & data_values()
+  {
+    return data_values_;
+  }
+
+  eprosima::fastdds::dds::SampleInfoSeq & info_seq()
+  {
+    return info_seq_;
+  }
+
+private:
+  eprosima::fastdds::dds::StackAllocatedSequence<void *, 1> own_data_values_;
+  eprosima::fastdds::dds::SampleInfoSeq own_info_seq_;
+  eprosima::fastdds::dds::LoanableCollection & data_values_;
+  eprosima::fastdds::dds::SampleInfoSeq & info_seq_;
+};
+
+struct GenericSequence : public eprosima::fastdds::dds::LoanableCollection
+{
+  GenericSequence() = default;
+
+  void resize(
+    size_type /*new_length*/) override
+  {
+    // This kind of collection should only be used with loans
+    throw std::bad_alloc();
+  }
+};
+
+// Take from the DataReader, or through the shared DataReader of the subscription.
+// Messages delivered locally are taken first. Their copies at the front of the DataReader are
+// taken through a loan, which only copies the payload, so they are never deserialized into
+// `data_values`. Copies further on, when taking several samples, are returned with valid_data
+// unset.
+ReturnCode_t
+_take_samples(
+  CustomSubscriberInfo * info,
+  eprosima::fastdds::dds::LoanableCollection & data_values,
+  eprosima::fastdds::dds::SampleInfoSeq & info_seq,
+  int32_t max_samples)
+{
+  if (info->shared_reader_) {
+    return info->shared_reader_->take(info, data_values, info_seq, max_samples);
+  }
+  LocalSubscription * local_subscription = info->local_subscription_.get();
+  if (nullptr == local_subscription) {
+    return info->data_reader_->take(data_values, info_seq, max_samples);
+  }
+
+  ReturnCode_t ret = local_subscription->get_queue().take(
+    info->type_support_.get(), data_values, info_seq, max_samples);
+  if (ReturnCode_t::RETCODE_OK == ret) {
+    return ret;
+  }
+  eprosima::fastdds::dds::SampleInfo next_info;
+  while (ReturnCode_t::RETCODE_OK == info->data_reader_->get_first_untaken_info(&next_info) &&
+    next_info.valid_data && local_subscription->is_local_writer(
+      eprosima::fastrtps::rtps::iHandle2GUID(next_info.publication_handle)))
+  {
+    GenericSequence discarded_values;
+    eprosima::fastdds::dds::SampleInfoSeq discarded_info;
+    if (ReturnCode_t::RETCODE_OK != info->data_reader_->take(
+        discarded_values, discarded_info, 1))
+    {
+      break;
+    }
+    info->data_reader_->return_loan(discarded_values, discarded_info);
+  }
+
+  ret = info->data_reader_->take(data_values, info_seq, max_samples);
+  if (ReturnCode_t::RETCODE_OK == ret) {
+    for (eprosima::fastdds::dds::SampleInfoSeq::size_type ii = 0; ii < info_seq.length(); ++ii) {
+      if (info_seq[ii].valid_data && local_subscription->is_local_writer(
+          eprosima::fastrtps::rtps::iHandle2GUID(info_seq[ii].publication_handle)))
+      {
+        info_seq[ii].valid_data = false;
+      }
+    }
+  }
+  return ret;
+}
+
 rmw_ret_t
 _take(
   const char * identifier,
@@ -75,7 +201,6 @@ _take(
   rmw_message_info_t * message_info,
   rmw_subscription_allocation_t * allocation)
 {
-  (void) allocation;
   *taken = false;
 
   RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
@@ -83,6 +208,12 @@ _take(
     subscription->implementation_identifier, identifier,
     return RMW_RET_INCORRECT_RMW_IMPLEMENTATION);
 
+  CustomSubscriptionAllocation * scratch = nullptr;
+  rmw_ret_t ret = _get_allocation_scratch(identifier, allocation, &scratch);
+  if (RMW_RET_OK != ret) {
+    return ret;
+  }
+
   auto info = static_cast<CustomSubscriberInfo *>(subscription->data);
   RCUTILS_CHECK_FOR_NULL_WITH_MSG(info, "custom subscriber info is null", return RMW_RET_ERROR);
 
@@ -91,12 +222,12 @@ _take(
   data.data = ros_message;
   data.impl = info->type_support_impl_;
 
-  eprosima::fastdds::dds::StackAllocatedSequence<void *, 1> data_values;
-  const_cast<void **>(data_values.buffer())[0] = &data;
-  eprosima::fastdds::dds::SampleInfoSeq info_seq{1};
+  SingleSampleCollections collections(scratch, &data);
+  eprosima::fastdds::dds::LoanableCollection & data_values = collections.data_values();
+  eprosima::fastdds::dds::SampleInfoSeq & info_seq = collections.info_seq();
 
-  while (ReturnCode_t::RETCODE_OK == info->data_reader_->take(data_values, info_seq, 1)) {
-    // The info->data_reader_->take() call already modified the ros_message arg
+  while (ReturnCode_t::RETCODE_OK == _take_samples(info, data_values, info_seq, 1)) {
+    // The _take_samples() call already modified the ros_message arg
     // See rmw_fastrtps_shared_cpp/src/TypeSupport_impl.cpp
 
     auto reset = rcpputils::make_scope_exit(
@@ -145,36 +276,99 @@ _take_sequence(
   rmw_subscription_allocation_t * allocation)
 {
   *taken = 0;
-  bool taken_flag = false;
-  rmw_ret_t ret = RMW_RET_OK;
 
   RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
     subscription handle,
     subscription->implementation_identifier, identifier,
     return RMW_RET_INCORRECT_RMW_IMPLEMENTATION);
 
+  CustomSubscriptionAllocation * scratch = nullptr;
+  rmw_ret_t ret = _get_allocation_scratch(identifier, allocation, &scratch);
+  if (RMW_RET_OK != ret) {
+    return ret;
+  }
+
   auto info = static_cast<CustomSubscriberInfo *>(subscription->data);
   RCUTILS_CHECK_FOR_NULL_WITH_MSG(info, "custom subscriber info is null", return RMW_RET_ERROR);
 
-  for (size_t ii = 0; ii < count; ++ii) {
-    taken_flag = false;
-    ret = _take(
-      identifier, subscription, message_sequence->data[*taken],
-      &taken_flag, &message_info_sequence->data[*taken], allocation);
+  // Without an allocation, the scratch of the subscription is used, one take at a time
+  std::unique_lock<std::mutex> scratch_lock;
+  if (!scratch) {
+    scratch_lock = std::unique_lock<std::mutex>(info->take_scratch_mutex_);
+    scratch = &info->take_scratch_;
+  }
+  scratch->reserve(count);
+  std::vector<rmw_fastrtps_shared_cpp::SerializedData> & data = scratch->data_;
+  DataPointerSequence & data_values = scratch->data_values_;
+  eprosima::fastdds::dds::SampleInfoSeq & info_seq = scratch->info_seq_;
+
+  while (*taken < count) {
+    // Samples are deserialized straight into the free slots of message_sequence
+    const size_t first_slot = *taken;
+    const size_t remaining = count - first_slot;
+    for (size_t ii = 0; ii < remaining; ++ii) {
+      data[ii].type = FASTRTPS_SERIALIZED_DATA_TYPE_ROS_MESSAGE;
+      data[ii].data = message_sequence->data[first_slot + ii];
+      data[ii].impl = info->type_support_impl_;
+      data_values.set(static_cast<DataPointerSequence::size_type>(ii), &data[ii]);
+    }
 
-    if (ret != RMW_RET_OK) {
+    if (ReturnCode_t::RETCODE_OK != _take_samples(
+        info, data_values, info_seq, static_cast<int32_t>(remaining)))
+    {
       break;
     }
 
-    if (taken_flag) {
+    auto reset = rcpputils::make_scope_exit(
+      [&]()
+      {
+        data_values.length(0);
+        info_seq.length(0);
+      });
+
+    const size_t received = static_cast<size_t>(info_seq.length());
+    for (size_t ii = 0; ii < received; ++ii) {
+      if (subscription->options.ignore_local_publications) {
+        auto sample_writer_guid =
+          eprosima::fastrtps::rtps::iHandle2GUID(info_seq[ii].publication_handle);
+
+        if (sample_writer_guid.guidPrefix == info->data_reader_->guid().guidPrefix) {
+          // This is a local publication. Ignore it
+          continue;
+        }
+      }
+
+      if (!info_seq[ii].valid_data) {
+        continue;
+      }
+
+      // Keep the taken messages contiguous by swapping the message pointers over the slots
+      // left behind by ignored samples. The caller still owns every pointer in the sequence.
+      const size_t slot = *taken;
+      if (slot != first_slot + ii) {
+        std::swap(message_sequence->data[slot], message_sequence->data[first_slot + ii]);
+      }
+      _assign_message_info(identifier, &message_info_sequence->data[slot], &info_seq[ii]);
       (*taken)++;
+
+      TRACETOOLS_TRACEPOINT(
+        rmw_take,
+        static_cast<const void *>(subscription),
+        static_cast<const void *>(message_sequence->data[slot]),
+        message_info_sequence->data[slot].source_timestamp,
+        true);
+    }
+
+    if (received < remaining) {
+      // The reader has no more samples available
+      break;
     }
   }
 
   message_sequence->size = *taken;
   message_info_sequence->size = *taken;
 
-  return ret;
+  return RMW_RET_OK;
 }
 
 rmw_ret_t
@@ -300,7 +494,6 @@ _take_serialized_message(
   rmw_message_info_t * message_info,
   rmw_subscription_allocation_t * allocation)
 {
-  (void) allocation;
   *taken = false;
 
   RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
@@ -308,21 +501,34 @@ _take_serialized_message(
     subscription->implementation_identifier, identifier,
     return RMW_RET_INCORRECT_RMW_IMPLEMENTATION);
 
+  CustomSubscriptionAllocation * scratch = nullptr;
+  rmw_ret_t ret = _get_allocation_scratch(identifier, allocation, &scratch);
+  if (RMW_RET_OK != ret) {
+    return ret;
+  }
+
   auto info = static_cast<CustomSubscriberInfo *>(subscription->data);
   RCUTILS_CHECK_FOR_NULL_WITH_MSG(info, "custom subscriber info is null", return RMW_RET_ERROR);
 
-  eprosima::fastcdr::FastBuffer buffer;
+  if (scratch && serialized_message->buffer_capacity < scratch->max_serialized_size_) {
+    // Make room for the largest message up front, so it is never resized while taking
+    ret = rmw_serialized_message_resize(serialized_message, scratch->max_serialized_size_);
+    if (RMW_RET_OK != ret) {
+      return ret;  // Error message already set
+    }
+  }
 
+  // The payload is copied straight into serialized_message, which is resized as needed.
   rmw_fastrtps_shared_cpp::SerializedData data;
-  data.type = FASTRTPS_SERIALIZED_DATA_TYPE_CDR_BUFFER;
-  data.data = &buffer;
-  data.impl = nullptr;  // not used when type is FASTRTPS_SERIALIZED_DATA_TYPE_CDR_BUFFER
+  data.type = FASTRTPS_SERIALIZED_DATA_TYPE_SERIALIZED_MESSAGE;
+  data.data = serialized_message;
+  data.impl = nullptr;  // not used when type is FASTRTPS_SERIALIZED_DATA_TYPE_SERIALIZED_MESSAGE
 
-  eprosima::fastdds::dds::StackAllocatedSequence<void *, 1> data_values;
-  const_cast<void **>(data_values.buffer())[0] = &data;
-  eprosima::fastdds::dds::SampleInfoSeq info_seq{1};
+  SingleSampleCollections collections(scratch, &data);
+  eprosima::fastdds::dds::LoanableCollection & data_values = collections.data_values();
+  eprosima::fastdds::dds::SampleInfoSeq & info_seq = collections.info_seq();
 
-  while (ReturnCode_t::RETCODE_OK == info->data_reader_->take(data_values, info_seq, 1)) {
+  while (ReturnCode_t::RETCODE_OK == _take_samples(info, data_values, info_seq, 1)) {
     auto reset = rcpputils::make_scope_exit(
       [&]()
       {
@@ -331,16 +537,6 @@ _take_serialized_message(
       });
 
     if (info_seq[0].valid_data) {
-      auto buffer_size = static_cast<size_t>(buffer.getBufferSize());
-      if (serialized_message->buffer_capacity < buffer_size) {
-        auto ret = rmw_serialized_message_resize(serialized_message, buffer_size);
-        if (ret != RMW_RET_OK) {
-          return ret;           // Error message already set
-        }
-      }
-      serialized_message->buffer_length = buffer_size;
-      memcpy(serialized_message->buffer, buffer.getBuffer(), serialized_message->buffer_length);
-
       if (message_info) {
         _assign_message_info(identifier, message_info, &info_seq[0]);
       }
@@ -412,7 +608,6 @@ _take_dynamic_message(
   rmw_message_info_t * message_info,
   rmw_subscription_allocation_t * allocation)
 {
-  (void) allocation;
   *taken = false;
 
   RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
@@ -420,22 +615,26 @@ _take_dynamic_message(
     subscription->implementation_identifier, identifier,
     return RMW_RET_INCORRECT_RMW_IMPLEMENTATION);
 
+  CustomSubscriptionAllocation * scratch = nullptr;
+  rmw_ret_t ret = _get_allocation_scratch(identifier, allocation, &scratch);
+  if (RMW_RET_OK != ret) {
+    return ret;
+  }
+
   auto info = static_cast<CustomSubscriberInfo *>(subscription->data);
   RCUTILS_CHECK_FOR_NULL_WITH_MSG(info, "custom subscriber info is null", return RMW_RET_ERROR);
 
-  eprosima::fastcdr::FastBuffer buffer;
-
   rmw_fastrtps_shared_cpp::SerializedData data;
   data.type = FASTRTPS_SERIALIZED_DATA_TYPE_DYNAMIC_MESSAGE;
   data.data = dynamic_data->impl.handle;
   data.impl = nullptr;  // not used when type is FASTRTPS_SERIALIZED_DATA_TYPE_DYNAMIC_MESSAGE
 
-  eprosima::fastdds::dds::StackAllocatedSequence<void *, 1> data_values;
-  const_cast<void **>(data_values.buffer())[0] = &data;
-  eprosima::fastdds::dds::SampleInfoSeq info_seq{1};
+  SingleSampleCollections collections(scratch, &data);
+  eprosima::fastdds::dds::LoanableCollection & data_values = collections.data_values();
+  eprosima::fastdds::dds::SampleInfoSeq & info_seq = collections.info_seq();
 
-  while (ReturnCode_t::RETCODE_OK == info->data_reader_->take(data_values, info_seq, 1)) {
-    // The info->data_reader_->take() call already modified the dynamic_data arg
+  while (ReturnCode_t::RETCODE_OK == _take_samples(info, data_values, info_seq, 1)) {
+    // The _take_samples() call already modified the dynamic_data arg
     // See rmw_fastrtps_shared_cpp/src/TypeSupport_impl.cpp
 
     auto reset = rcpputils::make_scope_exit(
@@ -505,24 +704,14 @@ __rmw_take_dynamic_message_with_info(
 
 // ----------------- Loans related code ------------------------- //
 
-struct GenericSequence : public eprosima::fastdds::dds::LoanableCollection
-{
-  GenericSequence() = default;
-
-  void resize(
-    size_type /*new_length*/) override
-  {
-    // This kind of collection should only be used with loans
-    throw std::bad_alloc();
-  }
-};
-
 struct LoanManager
 {
   struct Item
   {
     GenericSequence data_seq{};
     eprosima::fastdds::dds::SampleInfoSeq info_seq{};
+    // What was handed out to the user, and will be given back when returning the loan
+    void * loaned_message{nullptr};
   };
 
   explicit LoanManager(
@@ -545,7 +734,7 @@ struct LoanManager
 
     std::lock_guard<std::mutex> guard(mtx);
     for (auto it = items.begin(); it != items.end(); ++it) {
-      if (loaned_message == (*it)->data_seq.buffer()[0]) {
+      if (loaned_message == (*it)->loaned_message) {
         ret = std::move(*it);
         items.erase(it);
         break;
@@ -555,6 +744,16 @@ struct LoanManager
     return ret;
   }
 
+  void return_all(
+    eprosima::fastdds::dds::DataReader * reader)
+  {
+    std::lock_guard<std::mutex> guard(mtx);
+    for (auto & item : items) {
+      reader->return_loan(item->data_seq, item->info_seq);
+    }
+    items.clear();
+  }
+
 private:
   std::mutex mtx;
   using ItemVector = eprosima::fastrtps::ResourceLimitedVector<std::unique_ptr<Item>>;
@@ -567,10 +766,22 @@ __init_subscription_for_loans(
 {
   auto info = static_cast<CustomSubscriberInfo *>(subscription->data);
   const auto & qos = info->data_reader_->get_qos();
-  subscription->can_loan_messages = info->type_support_->is_plain();
-  if (subscription->can_loan_messages) {
-    const auto & allocation_qos = qos.reader_resource_limits().outstanding_reads_allocation;
-    info->loan_manager_ = std::make_shared<LoanManager>(allocation_qos);
+  // Samples of a shared DataReader are copied into the queue of each subscription, and so are
+  // the messages delivered locally
+  subscription->can_loan_messages = !info->shared_reader_ && !info->local_subscription_ &&
+    info->type_support_->is_plain();
+  // Serialized messages can be loaned for any type
+  const auto & allocation_qos = qos.reader_resource_limits().outstanding_reads_allocation;
+  info->loan_manager_ = std::make_shared<LoanManager>(allocation_qos);
+}
+
+void
+__return_subscription_loans(
+  rmw_subscription_t * subscription)
+{
+  auto info = static_cast<CustomSubscriberInfo *>(subscription->data);
+  if (info->loan_manager_) {
+    info->loan_manager_->return_all(info->data_reader_);
   }
 }
 
@@ -604,6 +815,7 @@ __rmw_take_loaned_message_internal(
         _assign_message_info(identifier, message_info, &item->info_seq[0]);
       }
       *loaned_message = item->data_seq.buffer()[0];
+      item->loaned_message = *loaned_message;
       *taken = true;
 
       info->loan_manager_->add_item(std::move(item));
@@ -652,4 +864,105 @@ __rmw_return_loaned_message_from_subscription(
   return RMW_RET_ERROR;
 }
 
+rmw_ret_t
+__rmw_take_loaned_serialized_message(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  rmw_serialized_message_t * serialized_message,
+  bool * taken,
+  rmw_message_info_t * message_info)
+{
+  RMW_CHECK_ARGUMENT_FOR_NULL(subscription, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
+    subscription, subscription->implementation_identifier, identifier,
+    return RMW_RET_INCORRECT_RMW_IMPLEMENTATION);
+  if (subscription->can_loan_messages) {
+    // Loaned samples of plain types hold the ROS message, not its serialized representation
+    RMW_SET_ERROR_MSG("Loaning serialized messages is not supported for plain types");
+    return RMW_RET_UNSUPPORTED;
+  }
+
+  RMW_CHECK_ARGUMENT_FOR_NULL(serialized_message, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_ARGUMENT_FOR_NULL(taken, RMW_RET_INVALID_ARGUMENT);
+
+  auto info = static_cast<CustomSubscriberInfo *>(subscription->data);
+  if (info->shared_reader_) {
+    RMW_SET_ERROR_MSG("Loaning serialized messages is not supported on shared data readers");
+    return RMW_RET_UNSUPPORTED;
+  }
+  if (info->local_subscription_) {
+    RMW_SET_ERROR_MSG("Loaning serialized messages is not supported with local delivery");
+    return RMW_RET_UNSUPPORTED;
+  }
+
+  auto item = std::make_unique<rmw_fastrtps_shared_cpp::LoanManager::Item>();
+
+  while (ReturnCode_t::RETCODE_OK == info->data_reader_->take(item->data_seq, item->info_seq, 1)) {
+    if (item->info_seq[0].valid_data) {
+      if (nullptr != message_info) {
+        _assign_message_info(identifier, message_info, &item->info_seq[0]);
+      }
+
+      // Loaned samples are created by TypeSupport::createData, and keep the serialized payload
+      auto ser_data = static_cast<SerializedData *>(item->data_seq.buffer()[0]);
+      auto loaned_serialized_message = static_cast<rmw_serialized_message_t *>(ser_data->data);
+
+      // Hand out a view of the loaned buffer, with an invalid allocator so it cannot be resized
+      *serialized_message = rmw_get_zero_initialized_serialized_message();
+      serialized_message->buffer = loaned_serialized_message->buffer;
+      serialized_message->buffer_length = loaned_serialized_message->buffer_length;
+      serialized_message->buffer_capacity = loaned_serialized_message->buffer_length;
+      item->loaned_message = serialized_message->buffer;
+      *taken = true;
+
+      info->loan_manager_->add_item(std::move(item));
+
+      TRACETOOLS_TRACEPOINT(
+        rmw_take,
+        static_cast<const void *>(subscription),
+        static_cast<const void *>(serialized_message),
+        (message_info ? message_info->source_timestamp : 0LL),
+        true);
+      return RMW_RET_OK;
+    }
+
+    // Should return loan before taking again
+    info->data_reader_->return_loan(item->data_seq, item->info_seq);
+  }
+
+  // No data available, return loan information.
+  *taken = false;
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+__rmw_return_loaned_serialized_message(
+  const char * identifier,
+  const rmw_subscription_t * subscription,
+  rmw_serialized_message_t * serialized_message)
+{
+  RMW_CHECK_ARGUMENT_FOR_NULL(subscription, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
+    subscription, subscription->implementation_identifier, identifier,
+    return RMW_RET_INCORRECT_RMW_IMPLEMENTATION);
+  RMW_CHECK_ARGUMENT_FOR_NULL(serialized_message, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_ARGUMENT_FOR_NULL(serialized_message->buffer, RMW_RET_INVALID_ARGUMENT);
+
+  auto info = static_cast<CustomSubscriberInfo *>(subscription->data);
+  std::unique_ptr<rmw_fastrtps_shared_cpp::LoanManager::Item> item;
+  item = info->loan_manager_->erase_item(serialized_message->buffer);
+  if (item != nullptr) {
+    if (!info->data_reader_->return_loan(item->data_seq, item->info_seq)) {
+      RMW_SET_ERROR_MSG("Error returning loan");
+      return RMW_RET_ERROR;
+    }
+
+    *serialized_message = rmw_get_zero_initialized_serialized_message();
+    return RMW_RET_OK;
+  }
+
+  RMW_SET_ERROR_MSG("Trying to return serialized message not loaned by this subscription");
+  return RMW_RET_ERROR;
+}
+
 }  // namespace rmw_fastrtps_shared_cpp
@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+
 #include "rcutils/macros.h"
 
 #include "rmw/error_handling.h"
@@ -20,7 +22,10 @@
 #include "rmw_fastrtps_shared_cpp/custom_client_info.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_service_info.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_subscriber_info.hpp"
+#include "rmw_fastrtps_shared_cpp/custom_wait_set_info.hpp"
+#include "rmw_fastrtps_shared_cpp/local_delivery.hpp"
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+#include "rmw_fastrtps_shared_cpp/shared_data_reader.hpp"
 #include "types/event_types.hpp"
 
 #include "fastdds/dds/core/condition/WaitSet.hpp"
@@ -29,6 +34,18 @@
 
 namespace rmw_fastrtps_shared_cpp
 {
+/// Check whether a subscription has untaken data, in its queue when the reader is shared.
+static bool has_untaken_data(CustomSubscriberInfo * info)
+{
+  if (info->shared_queue_) {
+    return !info->shared_queue_->empty();
+  }
+  if (info->local_subscription_ && !info->local_subscription_->get_queue().empty()) {
+    return true;
+  }
+  return info->data_readiness_.has_untaken_data(info->data_reader_);
+}
+
 /// Check if any condition in the set of entities has a triggered condition.
 /**
  * If any condition is triggered before waiting, then we can skip some set-up,
@@ -48,7 +65,7 @@ static bool has_triggered_condition(
   rmw_clients_t * clients,
   rmw_events_t * events)
 {
-  // `get_first_untaken_info` is relatively more expensive than checking guard conditions,
+  // Checking for untaken data is relatively more expensive than checking guard conditions,
   // so should be skipped if possible.
   // Subscriptions, services, and clients typically have additional waitables
   // connected (eg receive event or intraprocess waitable), so we can hit those first
@@ -79,10 +96,7 @@ static bool has_triggered_condition(
     for (size_t i = 0; i < subscriptions->subscriber_count; ++i) {
       void * data = subscriptions->subscribers[i];
       auto custom_subscriber_info = static_cast<CustomSubscriberInfo *>(data);
-      eprosima::fastdds::dds::SampleInfo sample_info;
-      if (ReturnCode_t::RETCODE_OK ==
-        custom_subscriber_info->data_reader_->get_first_untaken_info(&sample_info))
-      {
+      if (has_untaken_data(custom_subscriber_info)) {
         return true;
       }
     }
@@ -92,9 +106,8 @@ static bool has_triggered_condition(
     for (size_t i = 0; i < clients->client_count; ++i) {
       void * data = clients->clients[i];
       auto custom_client_info = static_cast<CustomClientInfo *>(data);
-      eprosima::fastdds::dds::SampleInfo sample_info;
-      if (ReturnCode_t::RETCODE_OK ==
-        custom_client_info->response_reader_->get_first_untaken_info(&sample_info))
+      if (custom_client_info->data_readiness_.has_untaken_data(
+          custom_client_info->response_reader_))
       {
         return true;
       }
@@ -105,9 +118,8 @@ static bool has_triggered_condition(
     for (size_t i = 0; i < services->service_count; ++i) {
       void * data = services->services[i];
       auto custom_service_info = static_cast<CustomServiceInfo *>(data);
-      eprosima::fastdds::dds::SampleInfo sample_info;
-      if (ReturnCode_t::RETCODE_OK ==
-        custom_service_info->request_reader_->get_first_untaken_info(&sample_info))
+      if (custom_service_info->data_readiness_.has_untaken_data(
+          custom_service_info->request_reader_))
       {
         return true;
       }
@@ -116,6 +128,53 @@ static bool has_triggered_condition(
   return false;
 }
 
+/// Attach and detach conditions so that the wait set watches exactly the requested ones.
+/**
+ * Executors usually wait on the same entities over and over, so instead of attaching every
+ * condition before waiting and detaching it afterwards, only the difference between the
+ * currently attached and the requested conditions is applied.
+ *
+ * The list of attached conditions is always queried from the Fast DDS wait set, which
+ * automatically forgets the conditions of deleted entities.
+ *
+ * \param[inout] wait_set_info wait set with the requested conditions already filled in
+ */
+static void update_attached_conditions(CustomWaitsetInfo & wait_set_info)
+{
+  auto & fastdds_wait_set = wait_set_info.fastdds_wait_set_;
+  auto & requested = wait_set_info.requested_conditions_;
+  auto & attached = wait_set_info.attached_conditions_;
+
+  // The same condition may be requested more than once (e.g. a subscription and one of its
+  // events share the DataReader status condition)
+  std::sort(requested.begin(), requested.end());
+  requested.erase(std::unique(requested.begin(), requested.end()), requested.end());
+
+  fastdds_wait_set.get_conditions(attached);
+  std::sort(attached.begin(), attached.end());
+
+  if (requested == attached) {
+    return;
+  }
+
+  auto requested_it = requested.begin();
+  auto attached_it = attached.begin();
+  while (requested_it != requested.end() || attached_it != attached.end()) {
+    if (attached_it == attached.end() ||
+      (requested_it != requested.end() && *requested_it < *attached_it))
+    {
+      fastdds_wait_set.attach_condition(**requested_it);
+      ++requested_it;
+    } else if (requested_it == requested.end() || *attached_it < *requested_it) {
+      fastdds_wait_set.detach_condition(**attached_it);
+      ++attached_it;
+    } else {
+      ++requested_it;
+      ++attached_it;
+    }
+  }
+}
+
 rmw_ret_t
 __rmw_wait(
   const char * identifier,
@@ -142,24 +201,35 @@ __rmw_wait(
   // error.
   // - Heap is corrupt.
   // In all three cases, it's better if this crashes soon enough.
-  auto fastdds_wait_set = static_cast<eprosima::fastdds::dds::WaitSet *>(wait_set->data);
+  auto wait_set_info = static_cast<CustomWaitsetInfo *>(wait_set->data);
 
   /// Check if any conditions are already true before waiting,
   /// allowing us to skip some work of attaching/detaching
   bool skip_wait = has_triggered_condition(
     subscriptions, guard_conditions, services, clients, events);
   bool wait_result = true;
-  std::vector<eprosima::fastdds::dds::Condition *> attached_conditions;
 
   if (!skip_wait) {
     // In the case that a wait is needed (no triggered conditions), gather the conditions
     // to be added to the waitset.
+    auto & requested_conditions = wait_set_info->requested_conditions_;
+    requested_conditions.clear();
+
     if (subscriptions) {
       for (size_t i = 0; i < subscriptions->subscriber_count; ++i) {
         void * data = subscriptions->subscribers[i];
         auto custom_subscriber_info = static_cast<CustomSubscriberInfo *>(data);
-        attached_conditions.push_back(
-          &custom_subscriber_info->data_reader_->get_statuscondition());
+        if (custom_subscriber_info->shared_queue_) {
+          requested_conditions.push_back(
+            &custom_subscriber_info->shared_queue_->get_guard_condition());
+        } else {
+          requested_conditions.push_back(
+            &custom_subscriber_info->data_reader_->get_statuscondition());
+          if (custom_subscriber_info->local_subscription_) {
+            requested_conditions.push_back(
+              &custom_subscriber_info->local_subscription_->get_queue().get_guard_condition());
+          }
+        }
       }
     }
 
@@ -167,7 +237,7 @@ __rmw_wait(
       for (size_t i = 0; i < clients->client_count; ++i) {
         void * data = clients->clients[i];
         auto custom_client_info = static_cast<CustomClientInfo *>(data);
-        attached_conditions.push_back(
+        requested_conditions.push_back(
           &custom_client_info->response_reader_->get_statuscondition());
       }
     }
@@ -176,7 +246,7 @@ __rmw_wait(
       for (size_t i = 0; i < services->service_count; ++i) {
         void * data = services->services[i];
         auto custom_service_info = static_cast<CustomServiceInfo *>(data);
-        attached_conditions.push_back(
+        requested_conditions.push_back(
           &custom_service_info->request_reader_->get_statuscondition());
       }
     }
@@ -185,9 +255,9 @@ __rmw_wait(
       for (size_t i = 0; i < events->event_count; ++i) {
         auto event = static_cast<rmw_event_t *>(events->events[i]);
         auto custom_event_info = static_cast<CustomEventInfo *>(event->data);
-        attached_conditions.push_back(
+        requested_conditions.push_back(
           &custom_event_info->get_listener()->get_statuscondition());
-        attached_conditions.push_back(
+        requested_conditions.push_back(
           &custom_event_info->get_listener()->get_event_guard(event->event_type));
       }
     }
@@ -195,34 +265,24 @@ __rmw_wait(
     if (guard_conditions) {
       for (size_t i = 0; i < guard_conditions->guard_condition_count; ++i) {
         void * data = guard_conditions->guard_conditions[i];
-        attached_conditions.push_back(
+        requested_conditions.push_back(
           static_cast<eprosima::fastdds::dds::GuardCondition *>(data));
       }
     }
 
-    // Attach all of the conditions to the wait set.
-    // TODO(mjcarroll): When upstream has the ability to attach a vector of conditions,
-    // switch to that API
-    for (auto & condition : attached_conditions) {
-      fastdds_wait_set->attach_condition(*condition);
-    }
+    update_attached_conditions(*wait_set_info);
 
     Duration_t timeout = (wait_timeout) ?
       Duration_t{static_cast<int32_t>(wait_timeout->sec),
       static_cast<uint32_t>(wait_timeout->nsec)} : eprosima::fastrtps::c_TimeInfinite;
 
-    eprosima::fastdds::dds::ConditionSeq triggered_conditions;
-    ReturnCode_t ret_code = fastdds_wait_set->wait(
-      triggered_conditions,
+    ReturnCode_t ret_code = wait_set_info->fastdds_wait_set_.wait(
+      wait_set_info->triggered_conditions_,
       timeout);
     wait_result = (ret_code == ReturnCode_t::RETCODE_OK);
 
-    // Detach all of the conditions from the wait set.
-    // TODO(mjcarroll): When upstream has the ability to detach a vector of conditions,
-    // switch to that API
-    for (auto & condition : attached_conditions) {
-      fastdds_wait_set->detach_condition(*condition);
-    }
+    // Conditions are intentionally left attached, as the next call will most likely wait on
+    // the same entities.
   }
 
   // Check the results of the wait, and mark ready entities accordingly.
@@ -231,10 +291,7 @@ __rmw_wait(
       void * data = subscriptions->subscribers[i];
       auto custom_subscriber_info = static_cast<CustomSubscriberInfo *>(data);
 
-      eprosima::fastdds::dds::SampleInfo sample_info;
-      if (ReturnCode_t::RETCODE_OK !=
-        custom_subscriber_info->data_reader_->get_first_untaken_info(&sample_info))
-      {
+      if (!has_untaken_data(custom_subscriber_info)) {
         subscriptions->subscribers[i] = 0;
       }
     }
@@ -245,9 +302,8 @@ __rmw_wait(
       void * data = clients->clients[i];
       auto custom_client_info = static_cast<CustomClientInfo *>(data);
 
-      eprosima::fastdds::dds::SampleInfo sample_info;
-      if (ReturnCode_t::RETCODE_OK !=
-        custom_client_info->response_reader_->get_first_untaken_info(&sample_info))
+      if (!custom_client_info->data_readiness_.has_untaken_data(
+          custom_client_info->response_reader_))
       {
         clients->clients[i] = 0;
       }
@@ -259,9 +315,8 @@ __rmw_wait(
       void * data = services->services[i];
       auto custom_service_info = static_cast<CustomServiceInfo *>(data);
 
-      eprosima::fastdds::dds::SampleInfo sample_info;
-      if (ReturnCode_t::RETCODE_OK !=
-        custom_service_info->request_reader_->get_first_untaken_info(&sample_info))
+      if (!custom_service_info->data_readiness_.has_untaken_data(
+          custom_service_info->request_reader_))
       {
         services->services[i] = 0;
       }
@@ -19,10 +19,9 @@
 #include "rmw/rmw.h"
 #include "rmw/impl/cpp/macros.hpp"
 
+#include "rmw_fastrtps_shared_cpp/custom_wait_set_info.hpp"
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
 
-#include "fastdds/dds/core/condition/WaitSet.hpp"
-
 namespace rmw_fastrtps_shared_cpp
 {
 rmw_wait_set_t *
@@ -37,29 +36,33 @@ __rmw_create_wait_set(const char * identifier, rmw_context_t * context, size_t m
     // TODO(wjwwood): replace this with RMW_RET_INCORRECT_RMW_IMPLEMENTATION when refactored
     return nullptr);
 
-  (void)max_conditions;
-
   // From here onward, error results in unrolling in the goto fail block.
-  eprosima::fastdds::dds::WaitSet * fastdds_wait_set = nullptr;
+  CustomWaitsetInfo * wait_set_info = nullptr;
   rmw_wait_set_t * wait_set = rmw_wait_set_allocate();
   if (!wait_set) {
     RMW_SET_ERROR_MSG("failed to allocate wait set");
     goto fail;
   }
   wait_set->implementation_identifier = identifier;
-  wait_set->data = rmw_allocate(sizeof(eprosima::fastdds::dds::WaitSet));
+  wait_set->data = rmw_allocate(sizeof(CustomWaitsetInfo));
   if (!wait_set->data) {
     RMW_SET_ERROR_MSG("failed to allocate wait set info");
     goto fail;
   }
   // This should default-construct the fields of CustomWaitsetInfo
   RMW_TRY_PLACEMENT_NEW(
-    fastdds_wait_set,
+    wait_set_info,
     wait_set->data,
     goto fail,
     // cppcheck-suppress syntaxError
-    eprosima::fastdds::dds::WaitSet, );
-  (void) fastdds_wait_set;
+    CustomWaitsetInfo, );
+  // Reserve room for the expected number of conditions up front, so that waiting does not
+  // allocate at all in steady state
+  if (max_conditions > 0u) {
+    wait_set_info->attached_conditions_.reserve(max_conditions);
+    wait_set_info->requested_conditions_.reserve(max_conditions);
+    wait_set_info->triggered_conditions_.reserve(max_conditions);
+  }
 
   return wait_set;
 
@@ -89,12 +92,12 @@ __rmw_destroy_wait_set(const char * identifier, rmw_wait_set_t * wait_set)
   // error.
   // - Heap is corrupt.
   // In all three cases, it's better if this crashes soon enough.
-  auto fastdds_wait_set = static_cast<eprosima::fastdds::dds::WaitSet *>(wait_set->data);
+  auto wait_set_info = static_cast<CustomWaitsetInfo *>(wait_set->data);
 
   if (wait_set->data) {
-    if (fastdds_wait_set) {
+    if (wait_set_info) {
       RMW_TRY_DESTRUCTOR(
-        fastdds_wait_set->eprosima::fastdds::dds::WaitSet::~WaitSet(), fastdds_wait_set,
+        wait_set_info->~CustomWaitsetInfo(), wait_set_info,
         result = RMW_RET_ERROR)
     }
     rmw_free(wait_set->data);
@@ -0,0 +1,598 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "fastdds/dds/core/StackAllocatedSequence.hpp"
+#include "fastdds/dds/core/status/StatusMask.hpp"
+#include "fastdds/rtps/common/Guid.h"
+#include "fastdds/rtps/common/SerializedPayload.h"
+
+#include "rcutils/allocator.h"
+
+#include "rmw/error_handling.h"
+#include "rmw/serialized_message.h"
+
+#include "rmw_fastrtps_shared_cpp/create_rmw_gid.hpp"
+#include "rmw_fastrtps_shared_cpp/shared_data_reader.hpp"
+#include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
+#include "rmw_fastrtps_shared_cpp/utils.hpp"
+
+namespace rmw_fastrtps_shared_cpp
+{
+
+namespace
+{
+
+std::shared_ptr<rmw_serialized_message_t>
+make_serialized_message()
+{
+  // The buffer is only allocated when the payload is copied into it, see TypeSupport::deserialize
+  auto serialized_message = new rmw_serialized_message_t;
+  *serialized_message = rmw_get_zero_initialized_serialized_message();
+  serialized_message->allocator = rcutils_get_default_allocator();
+  return std::shared_ptr<rmw_serialized_message_t>(
+    serialized_message,
+    [](rmw_serialized_message_t * msg)
+    {
+      if (RMW_RET_OK != rmw_serialized_message_fini(msg)) {
+        rmw_reset_error();
+      }
+      delete msg;
+    });
+}
+
+// Payloads kept for reuse by a SharedDataReader whose queues have no depth
+constexpr size_t default_max_payloads = 256u;
+
+// GUID for the subscriptions attached to an already existing shared DataReader.
+// It keeps the prefix of the participant, with an entity id of the vendor-specific kind so that
+// it never matches one of the entities created by Fast DDS.
+eprosima::fastrtps::rtps::GUID_t
+make_synthetic_guid(const eprosima::fastrtps::rtps::GUID_t & reader_guid)
+{
+  constexpr eprosima::fastrtps::rtps::octet vendor_specific_reader_no_key = 0x44;
+  static std::atomic<uint32_t> entity_key{0u};
+
+  const uint32_t key = entity_key.fetch_add(1u) + 1u;
+  eprosima::fastrtps::rtps::GUID_t guid = reader_guid;
+  guid.entityId.value[0] = static_cast<eprosima::fastrtps::rtps::octet>((key >> 16) & 0xFF);
+  guid.entityId.value[1] = static_cast<eprosima::fastrtps::rtps::octet>((key >> 8) & 0xFF);
+  guid.entityId.value[2] = static_cast<eprosima::fastrtps::rtps::octet>(key & 0xFF);
+  guid.entityId.value[3] = vendor_specific_reader_no_key;
+  return guid;
+}
+
+// Copy a plain ROS message into the representation requested by `data`
+bool
+copy_plain_message(
+  eprosima::fastdds::dds::TopicDataType * type,
+  const rmw_serialized_message_t & message,
+  const void * impl,
+  SerializedData * data)
+{
+  if (FASTRTPS_SERIALIZED_DATA_TYPE_ROS_MESSAGE == data->type) {
+    // Queued messages come from publishers with the same type support, so the layout matches
+    std::memcpy(data->data, message.buffer, message.buffer_length);
+    return true;
+  }
+
+  // Any other representation is obtained from the serialized message
+  SerializedData ros_message;
+  ros_message.type = FASTRTPS_SERIALIZED_DATA_TYPE_ROS_MESSAGE;
+  ros_message.data = message.buffer;
+  ros_message.impl = impl;
+  eprosima::fastrtps::rtps::SerializedPayload_t payload(
+    type->getSerializedSizeProvider(&ros_message)());
+  return type->serialize(&ros_message, &payload) && type->deserialize(&payload, data);
+}
+
+}  // namespace
+
+size_t
+get_queue_depth(const eprosima::fastdds::dds::DataReaderQos & qos)
+{
+  if (eprosima::fastdds::dds::KEEP_LAST_HISTORY_QOS == qos.history().kind &&
+    0 < qos.history().depth)
+  {
+    return static_cast<size_t>(qos.history().depth);
+  }
+  if (0 < qos.resource_limits().max_samples) {
+    return static_cast<size_t>(qos.resource_limits().max_samples);
+  }
+  return 0u;
+}
+
+SharedSampleQueue::SharedSampleQueue(size_t depth)
+: depth_(depth)
+{
+}
+
+void
+SharedSampleQueue::push(
+  const std::shared_ptr<const rmw_serialized_message_t> & payload,
+  const eprosima::fastdds::dds::SampleInfo & sample_info,
+  const void * plain_impl)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (0u != depth_ && samples_.size() >= depth_) {
+    samples_.pop_front();
+  }
+  samples_.push_back({payload, sample_info, plain_impl});
+  ++unread_count_;
+  guard_condition_.set_trigger_value(true);
+}
+
+ReturnCode_t
+SharedSampleQueue::take(
+  eprosima::fastdds::dds::TopicDataType * type,
+  eprosima::fastdds::dds::LoanableCollection & data_values,
+  eprosima::fastdds::dds::SampleInfoSeq & info_seq,
+  int32_t max_samples)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (samples_.empty() || max_samples <= 0) {
+    return ReturnCode_t::RETCODE_NO_DATA;
+  }
+
+  const auto count = static_cast<eprosima::fastdds::dds::LoanableCollection::size_type>(
+    std::min(samples_.size(), static_cast<size_t>(max_samples)));
+  data_values.length(count);
+  info_seq.length(count);
+
+  for (eprosima::fastdds::dds::LoanableCollection::size_type i = 0; i < count; ++i) {
+    Sample sample = std::move(samples_.front());
+    samples_.pop_front();
+
+    info_seq[i] = sample.info;
+
+    if (nullptr != sample.plain_impl) {
+      if (!copy_plain_message(
+          type, *sample.payload, sample.plain_impl,
+          static_cast<SerializedData *>(data_values.buffer()[i])))
+      {
+        info_seq[i].valid_data = false;
+      }
+      continue;
+    }
+
+    // Deserialize straight from the shared buffer, without letting the payload own it
+    eprosima::fastrtps::rtps::SerializedPayload_t payload;
+    payload.data = sample.payload->buffer;
+    payload.length = static_cast<uint32_t>(sample.payload->buffer_length);
+    payload.max_size = static_cast<uint32_t>(sample.payload->buffer_capacity);
+    if (!type->deserialize(&payload, data_values.buffer()[i])) {
+      info_seq[i].valid_data = false;
+    }
+    payload.data = nullptr;
+  }
+
+  if (samples_.empty() && !samples_in_reader_) {
+    guard_condition_.set_trigger_value(false);
+  }
+  return ReturnCode_t::RETCODE_OK;
+}
+
+size_t
+SharedSampleQueue::size() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return samples_.size();
+}
+
+bool
+SharedSampleQueue::full() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return 0u != depth_ && samples_.size() >= depth_;
+}
+
+void
+SharedSampleQueue::mark_samples_in_reader()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++reader_generation_;
+  samples_in_reader_ = true;
+  guard_condition_.set_trigger_value(true);
+}
+
+uint64_t
+SharedSampleQueue::get_reader_generation() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return reader_generation_;
+}
+
+void
+SharedSampleQueue::clear_samples_in_reader(uint64_t generation)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!samples_in_reader_ || generation != reader_generation_) {
+    return;
+  }
+  samples_in_reader_ = false;
+  if (samples_.empty()) {
+    guard_condition_.set_trigger_value(false);
+  }
+}
+
+bool
+SharedSampleQueue::empty() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return samples_.empty() && !samples_in_reader_;
+}
+
+size_t
+SharedSampleQueue::get_unread_count()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Samples may have been taken or dropped since they were pushed
+  size_t unread_count = std::min(unread_count_, samples_.size());
+  unread_count_ = 0u;
+  return unread_count;
+}
+
+SharedDataReader::SharedDataReader(
+  eprosima::fastdds::dds::DataReader * reader,
+  const eprosima::fastdds::dds::DataReaderQos & qos)
+: reader_(reader),
+  qos_(qos),
+  keep_all_(eprosima::fastdds::dds::KEEP_ALL_HISTORY_QOS == qos.history().kind),
+  max_payloads_(0u != get_queue_depth(qos) ? get_queue_depth(qos) + 1u : default_max_payloads)
+{
+}
+
+void
+SharedDataReader::attach(CustomSubscriberInfo * info)
+{
+  if (1u == sharer_count_.load()) {
+    // The samples left in the DataReader are for the subscription already attached
+    queue_available_samples();
+  }
+  {
+    std::lock_guard<std::mutex> lock(sharers_mutex_);
+    sharers_.push_back(info);
+    sharer_count_.store(sharers_.size());
+  }
+  if (1u < sharer_count_.load()) {
+    queue_available_samples();
+  }
+}
+
+bool
+SharedDataReader::detach(CustomSubscriberInfo * info)
+{
+  std::lock_guard<std::mutex> lock(sharers_mutex_);
+  sharers_.erase(std::remove(sharers_.begin(), sharers_.end(), info), sharers_.end());
+  sharer_count_.store(sharers_.size());
+  if (1u == sharers_.size()) {
+    // Samples held back for the other subscriptions are now taken from the DataReader
+    sharers_.front()->shared_queue_->mark_samples_in_reader();
+  }
+  return !sharers_.empty();
+}
+
+ReturnCode_t
+SharedDataReader::take(
+  CustomSubscriberInfo * info,
+  eprosima::fastdds::dds::LoanableCollection & data_values,
+  eprosima::fastdds::dds::SampleInfoSeq & info_seq,
+  int32_t max_samples)
+{
+  SharedSampleQueue & queue = *info->shared_queue_;
+  // Samples queued while other subscriptions were attached are taken first
+  ReturnCode_t ret = queue.take(info->type_support_.get(), data_values, info_seq, max_samples);
+
+  if (1u == sharer_count_.load()) {
+    if (ReturnCode_t::RETCODE_NO_DATA == ret) {
+      const uint64_t generation = queue.get_reader_generation();
+      ret = reader_->take(data_values, info_seq, max_samples);
+      if (0u == reader_->get_unread_count(false)) {
+        queue.clear_samples_in_reader(generation);
+      }
+    }
+    return ret;
+  }
+
+  queue.clear_samples_in_reader(queue.get_reader_generation());
+  if (keep_all_ && ReturnCode_t::RETCODE_OK == ret) {
+    // Samples held back while this queue was full can be queued now
+    queue_available_samples();
+  }
+  return ret;
+}
+
+size_t
+SharedDataReader::get_unread_count(CustomSubscriberInfo * info)
+{
+  size_t unread_count = info->shared_queue_->get_unread_count();
+  if (1u == sharer_count_.load()) {
+    unread_count += static_cast<size_t>(reader_->get_unread_count(true));
+  }
+  return unread_count;
+}
+
+void
+SharedDataReader::queue_available_samples()
+{
+  queueing_requested_.store(true);
+  while (queueing_requested_.load() && queueing_mutex_.try_lock()) {
+    std::lock_guard<std::mutex> queueing_lock(queueing_mutex_, std::adopt_lock);
+    while (queueing_requested_.exchange(false)) {
+      std::vector<std::shared_ptr<SharedSampleQueue>> queues;
+      {
+        std::lock_guard<std::mutex> lock(sharers_mutex_);
+        for (CustomSubscriberInfo * sharer : sharers_) {
+          queues.push_back(sharer->shared_queue_);
+        }
+      }
+      if (queues.empty()) {
+        return;
+      }
+
+      auto has_room = [this, &queues]() -> bool
+        {
+          // Queues of KEEP_LAST subscriptions drop their oldest sample instead
+          return !keep_all_ || std::none_of(
+            queues.begin(), queues.end(),
+            [](const std::shared_ptr<SharedSampleQueue> & queue) {return queue->full();});
+        };
+
+      SerializedData data;
+      data.type = FASTRTPS_SERIALIZED_DATA_TYPE_SERIALIZED_MESSAGE;
+      data.impl = nullptr;  // not used for FASTRTPS_SERIALIZED_DATA_TYPE_SERIALIZED_MESSAGE
+
+      eprosima::fastdds::dds::StackAllocatedSequence<void *, 1> data_values;
+      const_cast<void **>(data_values.buffer())[0] = &data;
+      eprosima::fastdds::dds::SampleInfoSeq info_seq{1};
+
+      bool queued = false;
+      std::shared_ptr<rmw_serialized_message_t> payload = get_payload();
+      data.data = payload.get();
+      while (has_room() && ReturnCode_t::RETCODE_OK == reader_->take(data_values, info_seq, 1)) {
+        if (info_seq[0].valid_data) {
+          // Every subscription gets the sample, including those ignoring local publications,
+          // which skip them when taking exactly as with a DataReader of their own.
+          for (const std::shared_ptr<SharedSampleQueue> & queue : queues) {
+            queue->push(payload, info_seq[0]);
+          }
+          queued = true;
+
+          payload.reset();
+          payload = get_payload();
+          data.data = payload.get();
+        }
+        data_values.length(0);
+        info_seq.length(0);
+      }
+
+      if (queued && 1u < queues.size()) {
+        // A single subscription was already notified of its samples when they were received.
+        // Detaching waits for the lock, so the subscriptions are still there.
+        std::lock_guard<std::mutex> lock(sharers_mutex_);
+        if (1u < sharers_.size()) {
+          for (CustomSubscriberInfo * sharer : sharers_) {
+            sharer->data_reader_listener_->on_data_available(reader_);
+          }
+        }
+      }
+    }
+  }
+}
+
+std::shared_ptr<rmw_serialized_message_t>
+SharedDataReader::get_payload()
+{
+  if (!payloads_.empty()) {
+    std::shared_ptr<rmw_serialized_message_t> & oldest = payloads_[next_payload_];
+    if (1 == oldest.use_count()) {
+      // The queues drop their references once done with the buffer, see SharedSampleQueue::take
+      std::atomic_thread_fence(std::memory_order_acquire);
+      next_payload_ = (next_payload_ + 1u) % payloads_.size();
+      return oldest;
+    }
+  }
+
+  std::shared_ptr<rmw_serialized_message_t> payload = make_serialized_message();
+  if (payloads_.size() < max_payloads_) {
+    // It goes before the oldest payload still in use, which is checked again next time
+    payloads_.insert(payloads_.begin() + static_cast<std::ptrdiff_t>(next_payload_), payload);
+    next_payload_ = (next_payload_ + 1u) % payloads_.size();
+  }
+  return payload;
+}
+
+void
+SharedDataReader::on_subscription_matched(
+  eprosima::fastdds::dds::DataReader * reader,
+  const eprosima::fastdds::dds::SubscriptionMatchedStatus & status)
+{
+  std::lock_guard<std::mutex> lock(sharers_mutex_);
+  for (CustomSubscriberInfo * sharer : sharers_) {
+    sharer->data_reader_listener_->on_subscription_matched(reader, status);
+  }
+}
+
+void
+SharedDataReader::on_data_available(
+  eprosima::fastdds::dds::DataReader * reader)
+{
+  if (1u < sharer_count_.load()) {
+    queue_available_samples();
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(sharers_mutex_);
+  if (1u == sharers_.size()) {
+    // Nothing to share, the subscription takes straight from the DataReader
+    sharers_.front()->shared_queue_->mark_samples_in_reader();
+    sharers_.front()->data_reader_listener_->on_data_available(reader);
+  }
+}
+
+void
+SharedDataReader::on_requested_deadline_missed(
+  eprosima::fastdds::dds::DataReader * reader,
+  const eprosima::fastdds::dds::RequestedDeadlineMissedStatus & status)
+{
+  std::lock_guard<std::mutex> lock(sharers_mutex_);
+  for (CustomSubscriberInfo * sharer : sharers_) {
+    sharer->data_reader_listener_->on_requested_deadline_missed(reader, status);
+  }
+}
+
+void
+SharedDataReader::on_liveliness_changed(
+  eprosima::fastdds::dds::DataReader * reader,
+  const eprosima::fastdds::dds::LivelinessChangedStatus & status)
+{
+  std::lock_guard<std::mutex> lock(sharers_mutex_);
+  for (CustomSubscriberInfo * sharer : sharers_) {
+    sharer->data_reader_listener_->on_liveliness_changed(reader, status);
+  }
+}
+
+void
+SharedDataReader::on_sample_lost(
+  eprosima::fastdds::dds::DataReader * reader,
+  const eprosima::fastdds::dds::SampleLostStatus & status)
+{
+  std::lock_guard<std::mutex> lock(sharers_mutex_);
+  for (CustomSubscriberInfo * sharer : sharers_) {
+    sharer->data_reader_listener_->on_sample_lost(reader, status);
+  }
+}
+
+void
+SharedDataReader::on_requested_incompatible_qos(
+  eprosima::fastdds::dds::DataReader * reader,
+  const eprosima::fastdds::dds::RequestedIncompatibleQosStatus & status)
+{
+  std::lock_guard<std::mutex> lock(sharers_mutex_);
+  for (CustomSubscriberInfo * sharer : sharers_) {
+    sharer->data_reader_listener_->on_requested_incompatible_qos(reader, status);
+  }
+}
+
+bool
+can_share_datareader(const rmw_subscription_options_t * subscription_options)
+{
+  if (subscription_options->content_filter_options &&
+    nullptr != subscription_options->content_filter_options->filter_expression)
+  {
+    return false;
+  }
+  switch (subscription_options->require_unique_network_flow_endpoints) {
+    case RMW_UNIQUE_NETWORK_FLOW_ENDPOINTS_SYSTEM_DEFAULT:
+    case RMW_UNIQUE_NETWORK_FLOW_ENDPOINTS_NOT_REQUIRED:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool
+attach_to_shared_datareader(
+  const char * identifier,
+  CustomParticipantInfo * participant_info,
+  CustomSubscriberInfo * info,
+  const rmw_subscription_options_t * subscription_options)
+{
+  SharedDataReader * shared_reader = nullptr;
+  for (SharedDataReader * candidate : participant_info->shared_data_readers_) {
+    if (candidate->matches(info->topic_, info->datareader_qos_)) {
+      shared_reader = candidate;
+      break;
+    }
+  }
+
+  const bool first_sharer = (nullptr == shared_reader);
+  if (first_sharer) {
+    eprosima::fastdds::dds::DataReader * reader = nullptr;
+    if (!create_datareader(
+        info->datareader_qos_,
+        subscription_options,
+        info->subscriber_,
+        info->topic_,
+        nullptr,
+        &reader))
+    {
+      return false;
+    }
+
+    // Waits are done on the queues of the subscriptions, never on the reader itself
+    reader->get_statuscondition().set_enabled_statuses(
+      eprosima::fastdds::dds::StatusMask::none());
+
+    shared_reader = new (std::nothrow) SharedDataReader(reader, info->datareader_qos_);
+    if (!shared_reader) {
+      info->subscriber_->delete_datareader(reader);
+      return false;
+    }
+    participant_info->shared_data_readers_.push_back(shared_reader);
+  }
+
+  eprosima::fastdds::dds::DataReader * reader = shared_reader->get_reader();
+  info->data_reader_ = reader;
+  info->shared_reader_ = shared_reader;
+  info->shared_queue_ = std::make_shared<SharedSampleQueue>(get_queue_depth(info->datareader_qos_));
+  info->synthetic_gid_ = !first_sharer;
+  info->subscription_gid_ = create_rmw_gid(
+    identifier, first_sharer ? reader->guid() : make_synthetic_guid(reader->guid()));
+  shared_reader->attach(info);
+
+  if (first_sharer) {
+    // Only install the listener once there is a queue to fill, and pick up anything received
+    // in the meantime
+    reader->set_listener(shared_reader, eprosima::fastdds::dds::StatusMask::all());
+    shared_reader->on_data_available(reader);
+  }
+  return true;
+}
+
+bool
+detach_from_shared_datareader(
+  CustomParticipantInfo * participant_info,
+  CustomSubscriberInfo * info)
+{
+  SharedDataReader * shared_reader = info->shared_reader_;
+  if (shared_reader->detach(info)) {
+    return true;
+  }
+
+  eprosima::fastdds::dds::DataReader * reader = shared_reader->get_reader();
+  reader->set_listener(nullptr);
+  if (ReturnCode_t::RETCODE_OK != participant_info->subscriber_->delete_datareader(reader)) {
+    // Keep the reader around, so another subscription can still attach to it
+    reader->set_listener(shared_reader, eprosima::fastdds::dds::StatusMask::all());
+    shared_reader->attach(info);
+    return false;
+  }
+
+  auto & shared_readers = participant_info->shared_data_readers_;
+  shared_readers.erase(
+    std::remove(shared_readers.begin(), shared_readers.end(), shared_reader),
+    shared_readers.end());
+  delete shared_reader;
+  return true;
+}
+
+}  // namespace rmw_fastrtps_shared_cpp
@@ -21,9 +21,11 @@
 
 #include "rmw_fastrtps_shared_cpp/custom_participant_info.hpp"
 #include "rmw_fastrtps_shared_cpp/custom_subscriber_info.hpp"
+#include "rmw_fastrtps_shared_cpp/local_delivery.hpp"
 #include "rmw_fastrtps_shared_cpp/namespace_prefix.hpp"
 #include "rmw_fastrtps_shared_cpp/qos.hpp"
 #include "rmw_fastrtps_shared_cpp/rmw_common.hpp"
+#include "rmw_fastrtps_shared_cpp/shared_data_reader.hpp"
 #include "rmw_fastrtps_shared_cpp/subscription.hpp"
 #include "rmw_fastrtps_shared_cpp/TypeSupport.hpp"
 #include "rmw_fastrtps_shared_cpp/utils.hpp"
@@ -46,9 +48,23 @@ destroy_subscription(
     // Get RMW Subscriber
     auto info = static_cast<CustomSubscriberInfo *>(subscription->data);
 
-    // Delete DataReader
-    ReturnCode_t ret = participant_info->subscriber_->delete_datareader(info->data_reader_);
-    if (ReturnCode_t::RETCODE_OK != ret) {
+    // Stop local delivery first, so no more messages are queued for the subscription.
+    // It is not restored when resetting the content filter, as filters are not applied to them.
+    if (info->local_subscription_) {
+      participant_info->local_delivery_->remove_subscription(info);
+    }
+
+    // Loans are only taken from DataReaders which are not shared
+    if (nullptr == info->shared_reader_) {
+      __return_subscription_loans(subscription);
+    }
+
+    // Delete DataReader, or detach from it when shared
+    bool deleted = (nullptr != info->shared_reader_) ?
+      detach_from_shared_datareader(participant_info, info) :
+      (ReturnCode_t::RETCODE_OK ==
+      participant_info->subscriber_->delete_datareader(info->data_reader_));
+    if (!deleted) {
       RMW_SET_ERROR_MSG("Failed to delete datareader");
       // This is the first failure on this function, and we have not changed state.
       // This means it should be safe to return an error
@@ -0,0 +1,108 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+#include "fastdds/rtps/common/CacheChange.h"
+#include "fastdds/rtps/common/SerializedPayload.h"
+#include "fastdds/rtps/history/IPayloadPool.h"
+
+#include "rmw_fastrtps_shared_cpp/bounded_payload_pool.hpp"
+
+using eprosima::fastrtps::rtps::CacheChange_t;
+using eprosima::fastrtps::rtps::IPayloadPool;
+using eprosima::fastrtps::rtps::SerializedPayload_t;
+using rmw_fastrtps_shared_cpp::BoundedPayloadPool;
+
+TEST(BoundedPayloadPoolTest, payloads_are_reused) {
+  BoundedPayloadPool pool(64u, 1u);
+  EXPECT_EQ(64u, pool.get_payload_size());
+
+  CacheChange_t first;
+  ASSERT_TRUE(pool.get_payload(10u, first));
+  EXPECT_EQ(&pool, first.payload_owner());
+  EXPECT_EQ(64u, first.serializedPayload.max_size);
+  EXPECT_EQ(0u, first.serializedPayload.length);
+  auto first_data = first.serializedPayload.data;
+
+  // Only one payload was allocated up front, the pool grows past it
+  CacheChange_t second;
+  ASSERT_TRUE(pool.get_payload(64u, second));
+  EXPECT_NE(first_data, second.serializedPayload.data);
+  auto second_data = second.serializedPayload.data;
+
+  ASSERT_TRUE(pool.release_payload(first));
+  EXPECT_EQ(nullptr, first.payload_owner());
+  EXPECT_EQ(nullptr, first.serializedPayload.data);
+  EXPECT_EQ(0u, first.serializedPayload.max_size);
+  ASSERT_TRUE(pool.release_payload(second));
+
+  // The last payload released is the first handed out again
+  CacheChange_t third;
+  ASSERT_TRUE(pool.get_payload(1u, third));
+  EXPECT_EQ(second_data, third.serializedPayload.data);
+  CacheChange_t fourth;
+  ASSERT_TRUE(pool.get_payload(1u, fourth));
+  EXPECT_EQ(first_data, fourth.serializedPayload.data);
+
+  ASSERT_TRUE(pool.release_payload(third));
+  ASSERT_TRUE(pool.release_payload(fourth));
+}
+
+TEST(BoundedPayloadPoolTest, oversized_payloads_are_not_pooled) {
+  BoundedPayloadPool pool(16u, 1u);
+
+  CacheChange_t change;
+  ASSERT_TRUE(pool.get_payload(100u, change));
+  EXPECT_EQ(&pool, change.payload_owner());
+  EXPECT_EQ(100u, change.serializedPayload.max_size);
+  ASSERT_TRUE(pool.release_payload(change));
+
+  CacheChange_t pooled;
+  ASSERT_TRUE(pool.get_payload(16u, pooled));
+  EXPECT_EQ(16u, pooled.serializedPayload.max_size);
+  ASSERT_TRUE(pool.release_payload(pooled));
+}
+
+TEST(BoundedPayloadPoolTest, copy_payload) {
+  BoundedPayloadPool pool(16u, 0u);
+
+  SerializedPayload_t data(8u);
+  std::memcpy(data.data, "payload", 8u);
+  data.length = 8u;
+
+  // Copying a payload nobody owns makes the pool its owner
+  IPayloadPool * data_owner = nullptr;
+  auto original_data = data.data;
+  CacheChange_t change;
+  ASSERT_TRUE(pool.get_payload(data, data_owner, change));
+  EXPECT_EQ(&pool, data_owner);
+  EXPECT_EQ(change.serializedPayload.data, data.data);
+  EXPECT_EQ(8u, change.serializedPayload.length);
+  EXPECT_STREQ("payload", reinterpret_cast<const char *>(change.serializedPayload.data));
+
+  // The copy is owned by the change, so the original buffer is freed as usual
+  data.data = original_data;
+
+  // Copying it again leaves its owner alone
+  CacheChange_t copy;
+  ASSERT_TRUE(pool.get_payload(change.serializedPayload, data_owner, copy));
+  EXPECT_NE(change.serializedPayload.data, copy.serializedPayload.data);
+  EXPECT_STREQ("payload", reinterpret_cast<const char *>(copy.serializedPayload.data));
+
+  ASSERT_TRUE(pool.release_payload(copy));
+  ASSERT_TRUE(pool.release_payload(change));
+}
@@ -257,3 +257,31 @@ TEST_F(GetDataWriterQoSTest, infinite_duration_conversions)
   EXPECT_EQ(publisher_qos_.deadline().period, InfiniteDuration);
   EXPECT_EQ(publisher_qos_.liveliness().lease_duration, InfiniteDuration);
 }
+
+TEST_F(GetDataReaderQoSTest, enable_xcdr2)
+{
+  EXPECT_TRUE(get_datareader_qos(qos_profile_, zero_type_hash, subscriber_qos_));
+  enable_xcdr2(subscriber_qos_);
+  const auto & representations = subscriber_qos_.type_consistency().representation.m_value;
+  ASSERT_EQ(2u, representations.size());
+  EXPECT_EQ(
+    eprosima::fastdds::dds::DataRepresentationId::XCDR_DATA_REPRESENTATION,
+    representations[0]);
+  EXPECT_EQ(
+    eprosima::fastdds::dds::DataRepresentationId::XCDR2_DATA_REPRESENTATION,
+    representations[1]);
+
+  // Enabling it again changes nothing
+  enable_xcdr2(subscriber_qos_);
+  EXPECT_EQ(2u, representations.size());
+}
+
+TEST_F(GetDataWriterQoSTest, enable_xcdr2)
+{
+  EXPECT_TRUE(get_datawriter_qos(qos_profile_, zero_type_hash, publisher_qos_));
+  enable_xcdr2(publisher_qos_);
+  ASSERT_EQ(1u, publisher_qos_.representation().m_value.size());
+  EXPECT_EQ(
+    eprosima::fastdds::dds::DataRepresentationId::XCDR2_DATA_REPRESENTATION,
+    publisher_qos_.representation().m_value[0]);
+}